@@ -0,0 +1,154 @@
+#include "MeasurementLineParser.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Will move the cursor after the given text, if the cursor starts with it.
+ */
+static bool skipText(const char*& cursor, const char* text) {
+
+    size_t textLength = strlen(text);
+
+    if (strncmp(cursor, text, textLength) != 0)
+        return false;
+
+    cursor += textLength;
+    return true;
+}
+
+static bool readUnsignedNumber(const char*& cursor, unsigned long& number) {
+
+    char* numberEnd;
+    number = strtoul(cursor, &numberEnd, 10);
+
+    if (numberEnd == cursor)
+        return false;
+
+    cursor = numberEnd;
+    return true;
+}
+
+static bool readFloatNumber(const char*& cursor, float& number) {
+
+    char* numberEnd;
+    number = static_cast<float>(strtod(cursor, &numberEnd));
+
+    if (numberEnd == cursor)
+        return false;
+
+    cursor = numberEnd;
+    return true;
+}
+
+/**
+ * Will read the text until the given delimiter, which is skipped too.
+ */
+static bool readWord(const char*& cursor, char* word, const size_t& wordMaxLength, const char& delimiter) {
+
+    size_t wordLength = 0;
+
+    while (*cursor != '\0' && *cursor != delimiter) {
+
+        if (wordLength + 1 >= wordMaxLength)
+            return false;
+
+        word[wordLength++] = *cursor++;
+    }
+
+    word[wordLength] = '\0';
+
+    return *cursor++ == delimiter;
+}
+
+/**
+ * Will read the on/off text of a boolean.
+ */
+static bool readOnOff(const char*& cursor, bool& isOn) {
+
+    isOn = skipText(cursor, "on");
+
+    return isOn || skipText(cursor, "off");
+}
+
+MeasurementLineParser::MeasurementLineParser() {
+    this->parsedLinesCount = 0;
+    this->invalidLinesCount = 0;
+    this->reset();
+}
+
+/**
+ * Will drop the incomplete line. For example when the device was reconnected.
+ */
+void MeasurementLineParser::reset() {
+    this->lineLength = 0;
+    this->isLineOverflowed = false;
+}
+
+bool MeasurementLineParser::parseLine(MeasurementLine& measurementLine) {
+
+    const char* cursor = this->line;
+
+    bool isParsed = skipText(cursor, "Distance: ")
+                    && readFloatNumber(cursor, measurementLine.distance)
+                    && skipText(cursor, " ")
+                    && readWord(cursor, measurementLine.distanceUnit, MEASUREMENT_LINE_DISTANCE_UNIT_MAX_LENGTH, ',')
+                    && skipText(cursor, " Valid Samples: ")
+                    && readUnsignedNumber(cursor, measurementLine.validSamples)
+                    && skipText(cursor, "/")
+                    && readUnsignedNumber(cursor, measurementLine.takenSamples)
+                    && skipText(cursor, " [Signal Timed Out Count: ")
+                    && readUnsignedNumber(cursor, measurementLine.signalTimedOutCount)
+                    && skipText(cursor, ", Response Timed Out Count: ")
+                    && readUnsignedNumber(cursor, measurementLine.responseTimedOutCount)
+                    && skipText(cursor, ", Max Distance Exceeded Count: ")
+                    && readUnsignedNumber(cursor, measurementLine.maxDistanceExceededCount)
+                    && skipText(cursor, ", Response Cool Down: ")
+                    && readOnOff(cursor, measurementLine.isResponseCoolDownActive)
+                    && skipText(cursor, "]");
+
+    return isParsed && (*cursor == '\0' || *cursor == '\r');
+}
+
+/**
+ * Will add the character to the current line.
+ *
+ * @param character The next character from the device
+ * @param measurementLine Will be filled when the character completes a valid line
+ * @return If a valid line was completed
+ */
+bool MeasurementLineParser::feed(const char& character, MeasurementLine& measurementLine) {
+
+    if (character != '\n') {
+
+        if (this->lineLength + 1 < MEASUREMENT_LINE_MAX_LENGTH)
+            this->line[this->lineLength++] = character;
+        else
+            this->isLineOverflowed = true;
+
+        return false;
+    }
+
+    this->line[this->lineLength] = '\0';
+
+    bool isParsed = !this->isLineOverflowed && this->parseLine(measurementLine);
+
+    if (isParsed)
+        this->parsedLinesCount++;
+    else
+        this->invalidLinesCount++;
+
+    this->reset();
+
+    return isParsed;
+}
+
+unsigned long MeasurementLineParser::getParsedLinesCount() const {
+    return this->parsedLinesCount;
+}
+
+/**
+ * @return How many lines were too long or didn't have the format of a measurement
+ */
+unsigned long MeasurementLineParser::getInvalidLinesCount() const {
+    return this->invalidLinesCount;
+}
@@ -0,0 +1,58 @@
+#ifndef HC_SR04_MEASUREMENTLINEPARSER_H
+#define HC_SR04_MEASUREMENTLINEPARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define MEASUREMENT_LINE_MAX_LENGTH 192
+#define MEASUREMENT_LINE_DISTANCE_UNIT_MAX_LENGTH 4
+
+/**
+ * One line, which the example sketch prints for each measurement:
+ * Distance: 12.34 cm, Valid Samples: 3/3 [Signal Timed Out Count: 0, Response Timed Out Count: 0, Max Distance Exceeded Count: 0, Response Cool Down: off]
+ */
+struct MeasurementLine {
+
+    float distance;
+    char distanceUnit[MEASUREMENT_LINE_DISTANCE_UNIT_MAX_LENGTH];
+    unsigned long validSamples;
+    unsigned long takenSamples;
+    unsigned long signalTimedOutCount;
+    unsigned long responseTimedOutCount;
+    unsigned long maxDistanceExceededCount;
+    bool isResponseCoolDownActive;
+};
+
+/**
+ * Parses the output of a device byte by byte, as it comes, in a fixed buffer. There is no allocation per line.
+ *
+ * Lines that are longer than the buffer or don't have the format of a measurement are counted as invalid and skipped.
+ */
+class MeasurementLineParser {
+
+private:
+
+    char line[MEASUREMENT_LINE_MAX_LENGTH];
+    uint16_t lineLength;
+    bool isLineOverflowed;
+
+    unsigned long parsedLinesCount;
+    unsigned long invalidLinesCount;
+
+    bool parseLine(MeasurementLine& measurementLine);
+
+public:
+
+    MeasurementLineParser();
+
+    bool feed(const char& character, MeasurementLine& measurementLine);
+
+    void reset();
+
+    unsigned long getParsedLinesCount() const;
+
+    unsigned long getInvalidLinesCount() const;
+};
+
+
+#endif //HC_SR04_MEASUREMENTLINEPARSER_H
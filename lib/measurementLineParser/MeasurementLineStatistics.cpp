@@ -0,0 +1,126 @@
+#include "MeasurementLineStatistics.h"
+#include <string.h>
+
+MeasurementLineStatistics::MeasurementLineStatistics() {
+    this->distanceUnit[0] = '\0';
+    this->linesCount = 0;
+    this->otherUnitLinesCount = 0;
+    this->takenSamplesCount = 0;
+    this->validSamplesCount = 0;
+    this->signalTimedOutCount = 0;
+    this->responseTimedOutCount = 0;
+    this->maxDistanceExceededCount = 0;
+    this->responseCoolDownCount = 0;
+    this->distancesCount = 0;
+    this->distancesMean = 0;
+    this->squaredDeviationsSum = 0;
+    this->minDistance = 0;
+    this->maxDistance = 0;
+    this->lastDistance = 0;
+}
+
+/**
+ * Will add the samples and the errors of the line. Its distance is accumulated only when it has valid samples.
+ */
+void MeasurementLineStatistics::add(const MeasurementLine& measurementLine) {
+
+    this->linesCount++;
+    this->takenSamplesCount += measurementLine.takenSamples;
+    this->validSamplesCount += measurementLine.validSamples;
+    this->signalTimedOutCount += measurementLine.signalTimedOutCount;
+    this->responseTimedOutCount += measurementLine.responseTimedOutCount;
+    this->maxDistanceExceededCount += measurementLine.maxDistanceExceededCount;
+    this->responseCoolDownCount += measurementLine.isResponseCoolDownActive ? 1 : 0;
+
+    if (this->distanceUnit[0] == '\0')
+        strcpy(this->distanceUnit, measurementLine.distanceUnit);
+
+    if (strcmp(this->distanceUnit, measurementLine.distanceUnit) != 0) {
+        this->otherUnitLinesCount++;
+        return;
+    }
+
+    if (measurementLine.validSamples == 0)
+        return;
+
+    float distance = measurementLine.distance;
+
+    this->distancesCount++;
+
+    double deviation = distance - this->distancesMean;
+    this->distancesMean += deviation / static_cast<double>(this->distancesCount);
+    this->squaredDeviationsSum += deviation * (distance - this->distancesMean);
+
+    this->minDistance = this->distancesCount == 1 || distance < this->minDistance ? distance : this->minDistance;
+    this->maxDistance = this->distancesCount == 1 || distance > this->maxDistance ? distance : this->maxDistance;
+    this->lastDistance = distance;
+}
+
+/**
+ * @return The unit of the first line, in which the distances are accumulated
+ */
+const char* MeasurementLineStatistics::getDistanceUnit() const {
+    return this->distanceUnit;
+}
+
+unsigned long MeasurementLineStatistics::getLinesCount() const {
+    return this->linesCount;
+}
+
+unsigned long MeasurementLineStatistics::getOtherUnitLinesCount() const {
+    return this->otherUnitLinesCount;
+}
+
+unsigned long MeasurementLineStatistics::getTakenSamplesCount() const {
+    return this->takenSamplesCount;
+}
+
+unsigned long MeasurementLineStatistics::getValidSamplesCount() const {
+    return this->validSamplesCount;
+}
+
+unsigned long MeasurementLineStatistics::getSignalTimedOutCount() const {
+    return this->signalTimedOutCount;
+}
+
+unsigned long MeasurementLineStatistics::getResponseTimedOutCount() const {
+    return this->responseTimedOutCount;
+}
+
+unsigned long MeasurementLineStatistics::getMaxDistanceExceededCount() const {
+    return this->maxDistanceExceededCount;
+}
+
+/**
+ * @return How many lines were reported while the response cool down was active
+ */
+unsigned long MeasurementLineStatistics::getResponseCoolDownCount() const {
+    return this->responseCoolDownCount;
+}
+
+/**
+ * @return How many lines had valid samples and were accumulated in the distance statistics
+ */
+unsigned long MeasurementLineStatistics::getDistancesCount() const {
+    return this->distancesCount;
+}
+
+float MeasurementLineStatistics::getDistanceMean() const {
+    return static_cast<float>(this->distancesMean);
+}
+
+float MeasurementLineStatistics::getDistanceVariance() const {
+    return this->distancesCount < 2 ? 0 : static_cast<float>(this->squaredDeviationsSum / static_cast<double>(this->distancesCount - 1));
+}
+
+float MeasurementLineStatistics::getMinDistance() const {
+    return this->minDistance;
+}
+
+float MeasurementLineStatistics::getMaxDistance() const {
+    return this->maxDistance;
+}
+
+float MeasurementLineStatistics::getLastDistance() const {
+    return this->lastDistance;
+}
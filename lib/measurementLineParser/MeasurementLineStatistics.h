@@ -0,0 +1,70 @@
+#ifndef HC_SR04_MEASUREMENTLINESTATISTICS_H
+#define HC_SR04_MEASUREMENTLINESTATISTICS_H
+
+#include "MeasurementLineParser.h"
+
+/**
+ * The statistics of the measurement lines of one device, in constant memory.
+ * The distances are accumulated in the unit of the first line. Lines in another unit are counted, but not accumulated.
+ */
+class MeasurementLineStatistics {
+
+private:
+
+    char distanceUnit[MEASUREMENT_LINE_DISTANCE_UNIT_MAX_LENGTH];
+
+    unsigned long linesCount;
+    unsigned long otherUnitLinesCount;
+    unsigned long takenSamplesCount;
+    unsigned long validSamplesCount;
+    unsigned long signalTimedOutCount;
+    unsigned long responseTimedOutCount;
+    unsigned long maxDistanceExceededCount;
+    unsigned long responseCoolDownCount;
+
+    unsigned long distancesCount;
+    double distancesMean;
+    double squaredDeviationsSum;
+    float minDistance;
+    float maxDistance;
+    float lastDistance;
+
+public:
+
+    MeasurementLineStatistics();
+
+    void add(const MeasurementLine& measurementLine);
+
+    const char* getDistanceUnit() const;
+
+    unsigned long getLinesCount() const;
+
+    unsigned long getOtherUnitLinesCount() const;
+
+    unsigned long getTakenSamplesCount() const;
+
+    unsigned long getValidSamplesCount() const;
+
+    unsigned long getSignalTimedOutCount() const;
+
+    unsigned long getResponseTimedOutCount() const;
+
+    unsigned long getMaxDistanceExceededCount() const;
+
+    unsigned long getResponseCoolDownCount() const;
+
+    unsigned long getDistancesCount() const;
+
+    float getDistanceMean() const;
+
+    float getDistanceVariance() const;
+
+    float getMinDistance() const;
+
+    float getMaxDistance() const;
+
+    float getLastDistance() const;
+};
+
+
+#endif //HC_SR04_MEASUREMENTLINESTATISTICS_H
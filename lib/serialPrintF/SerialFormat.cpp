@@ -0,0 +1,239 @@
+#include "SerialFormat.h"
+#include <math.h>
+#include <string.h>
+
+/*
+ * The largest float that fits in an unsigned long, like the Print of Arduino
+ */
+#define SERIAL_FORMAT_MAX_FIXED_VALUE 4294967040.0
+#define SERIAL_FORMAT_MAX_DECIMAL_PLACES 9
+
+static const unsigned long DECIMAL_PLACES_SCALES[SERIAL_FORMAT_MAX_DECIMAL_PLACES + 1] = {
+        1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
+FormatWriter::FormatWriter(Print& output) : output(output), length(0) {
+}
+
+/**
+ * The literal parts of the format are copied at once. If they don't fit in the buffer, they are written directly.
+ */
+void FormatWriter::write(const char* characters, const size_t& charactersCount) {
+
+    if (this->length + charactersCount > SERIAL_FORMAT_BUFFER_SIZE)
+        this->flush();
+
+    if (charactersCount > SERIAL_FORMAT_BUFFER_SIZE) {
+        this->output.write(reinterpret_cast<const uint8_t*>(characters), charactersCount);
+        return;
+    }
+
+    memcpy(this->buffer + this->length, characters, charactersCount);
+    this->length += charactersCount;
+}
+
+void FormatWriter::write(const char* string) {
+    this->write(string, strlen(string));
+}
+
+/**
+ * The digits are made from the end, so they are reversed into a small buffer first.
+ * The decimal numbers have their own loop, where the compiler replaces the division by a constant with a multiplication.
+ */
+void FormatWriter::writeUnsigned(unsigned long value, const uint8_t& base) {
+
+    char digits[sizeof(unsigned long) * 8];
+    uint8_t digitsCount = 0;
+
+    if (base == 10) {
+
+        do {
+            digits[digitsCount++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+
+        while (digitsCount > 0)
+            this->write(digits[--digitsCount]);
+
+        return;
+    }
+
+    do {
+        uint8_t digit = static_cast<uint8_t>(value % base);
+        value /= base;
+
+        digits[digitsCount++] = static_cast<char>(digit < 10 ? '0' + digit : 'A' + digit - 10);
+    } while (value > 0);
+
+    while (digitsCount > 0)
+        this->write(digits[--digitsCount]);
+}
+
+void FormatWriter::writeSigned(const long& value) {
+
+    if (value >= 0) {
+        this->writeUnsigned(static_cast<unsigned long>(value), 10);
+        return;
+    }
+
+    this->write('-');
+    this->writeUnsigned(0UL - static_cast<unsigned long>(value), 10);
+}
+
+/**
+ * Rounded like the Print of Arduino, but the decimal places are made with a single multiplication
+ * and written as a zero padded integer, instead of a multiplication per decimal place.
+ *
+ * @param decimalPlaces At most SERIAL_FORMAT_MAX_DECIMAL_PLACES
+ */
+void FormatWriter::writeFixed(double value, const uint8_t& decimalPlaces) {
+
+    if (isnan(value)) {
+        this->write("nan");
+        return;
+    }
+
+    if (isinf(value)) {
+        this->write("inf");
+        return;
+    }
+
+    if (value > SERIAL_FORMAT_MAX_FIXED_VALUE || value < -SERIAL_FORMAT_MAX_FIXED_VALUE) {
+        this->write("ovf");
+        return;
+    }
+
+    if (value < 0) {
+        this->write('-');
+        value = -value;
+    }
+
+    uint8_t places = min(decimalPlaces, static_cast<uint8_t>(SERIAL_FORMAT_MAX_DECIMAL_PLACES));
+    unsigned long scale = DECIMAL_PLACES_SCALES[places];
+
+    value += 0.5 / static_cast<double>(scale);
+
+    unsigned long integerPart = static_cast<unsigned long>(value);
+    this->writeUnsigned(integerPart, 10);
+
+    if (places == 0)
+        return;
+
+    unsigned long fraction = static_cast<unsigned long>((value - static_cast<double>(integerPart)) * static_cast<double>(scale));
+    fraction = min(fraction, scale - 1);
+
+    this->write('.');
+
+    for (uint8_t i = places; i > 1 && fraction < DECIMAL_PLACES_SCALES[i - 1]; i--)
+        this->write('0');
+
+    this->writeUnsigned(fraction, 10);
+}
+
+void FormatWriter::flush() {
+
+    if (this->length == 0)
+        return;
+
+    this->output.write(reinterpret_cast<const uint8_t*>(this->buffer), this->length);
+    this->length = 0;
+}
+
+const char* formatLiteral(FormatWriter& writer, const char* format) {
+
+    while (*format != '\0') {
+
+        const char* literalEnd = format;
+
+        while (*literalEnd != '\0' && *literalEnd != '%')
+            literalEnd++;
+
+        writer.write(format, static_cast<size_t>(literalEnd - format));
+        format = literalEnd;
+
+        if (*format == '\0')
+            break;
+
+        if (format[1] != '%')
+            return format + 1;
+
+        writer.write('%');
+        format += 2;
+    }
+
+    return format;
+}
+
+void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t&, const long& value) {
+
+    switch (specifier) {
+        case 'c':
+            writer.write(static_cast<char>(value));
+            break;
+        case 'o':
+            writer.write(value == 0 ? "off" : "on");
+            break;
+        case 'B':
+            writer.write("0b");
+            writer.writeUnsigned(static_cast<unsigned long>(value), 2);
+            break;
+        case 'b':
+            writer.writeUnsigned(static_cast<unsigned long>(value), 2);
+            break;
+        case 'X':
+            writer.write("0x");
+            writer.writeUnsigned(static_cast<unsigned long>(value), 16);
+            break;
+        case 'x':
+            writer.writeUnsigned(static_cast<unsigned long>(value), 16);
+            break;
+        default:
+            writer.writeSigned(value);
+            break;
+    }
+}
+
+void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t&, const unsigned long& value) {
+
+    switch (specifier) {
+        case 'c':
+            writer.write(static_cast<char>(value));
+            break;
+        case 'o':
+            writer.write(value == 0 ? "off" : "on");
+            break;
+        case 'B':
+            writer.write("0b");
+            writer.writeUnsigned(value, 2);
+            break;
+        case 'b':
+            writer.writeUnsigned(value, 2);
+            break;
+        case 'X':
+            writer.write("0x");
+            writer.writeUnsigned(value, 16);
+            break;
+        case 'x':
+            writer.writeUnsigned(value, 16);
+            break;
+        default:
+            writer.writeUnsigned(value, 10);
+            break;
+    }
+}
+
+void formatArgument(FormatWriter& writer, const char&, const uint8_t& decimalPlaces, const double& value) {
+    writer.writeFixed(value, decimalPlaces);
+}
+
+void formatArgument(FormatWriter& writer, const char&, const uint8_t&, const char& value) {
+    writer.write(value);
+}
+
+void formatArgument(FormatWriter& writer, const char&, const uint8_t&, const bool& value) {
+    writer.write(value ? "on" : "off");
+}
+
+void formatArgument(FormatWriter& writer, const char&, const uint8_t&, const char* value) {
+    writer.write(value);
+}
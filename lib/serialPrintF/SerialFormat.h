@@ -0,0 +1,261 @@
+#ifndef SERIAL_FORMAT_H
+#define SERIAL_FORMAT_H
+
+#include <Arduino.h>
+
+/*
+ * Type checked printf for writing to any Print, for example Serial, a SoftwareSerial or a File of an SD card.
+ * It has the formatting strings of serial_printf, but:
+ *  - The format is checked against the types of the arguments at compile time. A wrong specifier or a missing/extra argument doesn't compile
+ *  - The width of the integers is known, so %d/%i/%l accept any integer
+ *  - The output is formatted into a buffer on the stack and written with a single write per SERIAL_FORMAT_BUFFER_SIZE characters
+ *
+ * SERIAL_PRINTF(Serial, "Sensor %d is %o and reads %1f\n", d, d > 0, f);
+ *
+ * Formatting strings <fmt>
+ * %B    - binary (d = 0b1000001)
+ * %b    - binary (d = 1000001)
+ * %c    - character (c = H)
+ * %d/%i/%l - integer (d = 65)
+ * %f    - float (f = 123.45)
+ * %3f   - float (f = 123.346) three decimal places specified by %3.
+ * %o    - boolean on/off (b = on)
+ * %s    - char* string (s = Hello)
+ * %X    - hexidecimal (d = 0x41)
+ * %x    - hexidecimal (d = 41)
+ * %%    - escaped percent ("%")
+ */
+
+#define SERIAL_FORMAT_BUFFER_SIZE 32
+#define SERIAL_FORMAT_DEFAULT_DECIMAL_PLACES 2
+
+/**
+ * Checks the format at compile time. The arguments are only used for their types.
+ */
+#define SERIAL_PRINTF(output, format, ...) \
+    do { \
+        static_assert(decltype(makeFormatChecker(__VA_ARGS__))::check(format), "The format of SERIAL_PRINTF doesn't match its arguments"); \
+        serialPrintf(output, format, ##__VA_ARGS__); \
+    } while (false)
+
+enum class FormatArgumentKind : uint8_t {
+    INTEGER,
+    FLOATING,
+    CHARACTER,
+    BOOLEAN,
+    STRING,
+    UNSUPPORTED
+};
+
+template<typename T>
+struct FormatArgument {
+    static constexpr FormatArgumentKind kind() { return FormatArgumentKind::UNSUPPORTED; }
+};
+
+#define SERIAL_FORMAT_ARGUMENT_KIND(type, argumentKind) \
+    template<> \
+    struct FormatArgument<type> { \
+        static constexpr FormatArgumentKind kind() { return FormatArgumentKind::argumentKind; } \
+    };
+
+SERIAL_FORMAT_ARGUMENT_KIND(signed char, INTEGER)
+SERIAL_FORMAT_ARGUMENT_KIND(unsigned char, INTEGER)
+SERIAL_FORMAT_ARGUMENT_KIND(short, INTEGER)
+SERIAL_FORMAT_ARGUMENT_KIND(unsigned short, INTEGER)
+SERIAL_FORMAT_ARGUMENT_KIND(int, INTEGER)
+SERIAL_FORMAT_ARGUMENT_KIND(unsigned int, INTEGER)
+SERIAL_FORMAT_ARGUMENT_KIND(long, INTEGER)
+SERIAL_FORMAT_ARGUMENT_KIND(unsigned long, INTEGER)
+SERIAL_FORMAT_ARGUMENT_KIND(float, FLOATING)
+SERIAL_FORMAT_ARGUMENT_KIND(double, FLOATING)
+SERIAL_FORMAT_ARGUMENT_KIND(char, CHARACTER)
+SERIAL_FORMAT_ARGUMENT_KIND(bool, BOOLEAN)
+SERIAL_FORMAT_ARGUMENT_KIND(char*, STRING)
+SERIAL_FORMAT_ARGUMENT_KIND(const char*, STRING)
+
+template<size_t N>
+struct FormatArgument<char[N]> {
+    static constexpr FormatArgumentKind kind() { return FormatArgumentKind::STRING; }
+};
+
+constexpr bool isFormatDigit(const char& character) {
+    return character >= '0' && character <= '9';
+}
+
+/**
+ * @param specification The characters after the %
+ */
+constexpr char getFormatSpecifier(const char* specification) {
+    return isFormatDigit(specification[0]) ? specification[1] : specification[0];
+}
+
+constexpr const char* skipFormatSpecification(const char* specification) {
+    return isFormatDigit(specification[0]) ? specification + 2 : specification + 1;
+}
+
+/**
+ * @return If the specifier can format an argument of the given kind
+ */
+constexpr bool isFormatSpecifierAccepting(const char& specifier, const FormatArgumentKind& kind) {
+    return specifier == 'f' ? kind == FormatArgumentKind::FLOATING
+         : specifier == 's' ? kind == FormatArgumentKind::STRING
+         : specifier == 'c' ? kind == FormatArgumentKind::CHARACTER || kind == FormatArgumentKind::INTEGER
+         : specifier == 'o' ? kind == FormatArgumentKind::BOOLEAN || kind == FormatArgumentKind::INTEGER
+         : specifier == 'b' || specifier == 'B' || specifier == 'd' || specifier == 'i' || specifier == 'l' || specifier == 'x' || specifier == 'X'
+                            ? kind == FormatArgumentKind::INTEGER
+         : false;
+}
+
+/**
+ * Walks the format once per argument type. Each % has to have an argument of a kind that its specifier accepts and each argument has to have a %.
+ * The walk is recursive, because C++11 constexpr functions can't loop, so the format can't be longer than the constexpr depth of the compiler (512).
+ */
+template<typename... Arguments>
+struct FormatChecker;
+
+template<>
+struct FormatChecker<> {
+
+    static constexpr bool check(const char* format) {
+        return *format == '\0' ? true
+             : *format != '%' ? check(format + 1)
+             : format[1] == '%' ? check(format + 2)
+             : false;
+    }
+};
+
+template<typename First, typename... Rest>
+struct FormatChecker<First, Rest...> {
+
+    static constexpr bool check(const char* format) {
+        return *format == '\0' ? false
+             : *format != '%' ? check(format + 1)
+             : format[1] == '%' ? check(format + 2)
+             : isFormatSpecifierAccepting(getFormatSpecifier(format + 1), FormatArgument<First>::kind())
+               && FormatChecker<Rest...>::check(skipFormatSpecification(format + 1));
+    }
+};
+
+/**
+ * Only declared, for decltype in SERIAL_PRINTF.
+ */
+template<typename... Arguments>
+FormatChecker<Arguments...> makeFormatChecker(const Arguments&... arguments);
+
+/**
+ * Formats into a buffer and writes it to the output when it is full.
+ */
+class FormatWriter {
+
+private:
+
+    Print& output;
+    char buffer[SERIAL_FORMAT_BUFFER_SIZE];
+    uint8_t length;
+
+public:
+
+    FormatWriter(Print& output);
+
+    /**
+     * Inline, because it is called for each character of the numbers.
+     */
+    void write(const char& character) {
+
+        if (this->length == SERIAL_FORMAT_BUFFER_SIZE)
+            this->flush();
+
+        this->buffer[this->length++] = character;
+    }
+
+    void write(const char* characters, const size_t& charactersCount);
+
+    void write(const char* string);
+
+    void writeUnsigned(unsigned long value, const uint8_t& base);
+
+    void writeSigned(const long& value);
+
+    void writeFixed(double value, const uint8_t& decimalPlaces);
+
+    void flush();
+};
+
+void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const long& value);
+
+void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const unsigned long& value);
+
+void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const double& value);
+
+void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const char& value);
+
+void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const bool& value);
+
+void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const char* value);
+
+inline void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const signed char& value) {
+    formatArgument(writer, specifier, decimalPlaces, static_cast<long>(value));
+}
+
+inline void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const short& value) {
+    formatArgument(writer, specifier, decimalPlaces, static_cast<long>(value));
+}
+
+inline void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const int& value) {
+    formatArgument(writer, specifier, decimalPlaces, static_cast<long>(value));
+}
+
+inline void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const unsigned char& value) {
+    formatArgument(writer, specifier, decimalPlaces, static_cast<unsigned long>(value));
+}
+
+inline void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const unsigned short& value) {
+    formatArgument(writer, specifier, decimalPlaces, static_cast<unsigned long>(value));
+}
+
+inline void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const unsigned int& value) {
+    formatArgument(writer, specifier, decimalPlaces, static_cast<unsigned long>(value));
+}
+
+inline void formatArgument(FormatWriter& writer, const char& specifier, const uint8_t& decimalPlaces, const float& value) {
+    formatArgument(writer, specifier, decimalPlaces, static_cast<double>(value));
+}
+
+/**
+ * Writes the characters until the next specification.
+ *
+ * @return The characters after the % of the specification or the end of the format
+ */
+const char* formatLiteral(FormatWriter& writer, const char* format);
+
+inline void formatTo(FormatWriter& writer, const char* format) {
+    formatLiteral(writer, format);
+}
+
+template<typename First, typename... Rest>
+void formatTo(FormatWriter& writer, const char* format, const First& first, const Rest&... rest) {
+
+    const char* specification = formatLiteral(writer, format);
+
+    if (*specification == '\0')
+        return;
+
+    uint8_t decimalPlaces = isFormatDigit(specification[0]) ? specification[0] - '0' : SERIAL_FORMAT_DEFAULT_DECIMAL_PLACES;
+
+    formatArgument(writer, getFormatSpecifier(specification), decimalPlaces, first);
+    formatTo(writer, skipFormatSpecification(specification), rest...);
+}
+
+/**
+ * Not checked at compile time, use SERIAL_PRINTF. The specifiers are still matched with the types of the arguments.
+ */
+template<typename... Arguments>
+void serialPrintf(Print& output, const char* format, const Arguments&... arguments) {
+
+    FormatWriter writer(output);
+
+    formatTo(writer, format, arguments...);
+    writer.flush();
+}
+
+#endif //SERIAL_FORMAT_H
@@ -0,0 +1,163 @@
+#include "AdaptivePingRate.h"
+
+AdaptivePingRate::AdaptivePingRate() : AdaptivePingRate(0, 0, 0) {
+}
+
+/**
+ * @param minPeriodMS The period between the starts of the measurements, while the scene changes
+ * @param maxPeriodMS The period between the starts of the measurements, while the scene doesn't change
+ * @param significantChangeCM A change of the distance, which is bigger than this snaps back to the min period
+ */
+AdaptivePingRate::AdaptivePingRate(const unsigned long& minPeriodMS, const unsigned long& maxPeriodMS, const float& significantChangeCM) : minPeriodMS(minPeriodMS), maxPeriodMS(max(minPeriodMS, maxPeriodMS)), significantChangeCM(significantChangeCM) {
+    this->reset();
+}
+
+/**
+ * Will forget the measurements and start again from the min period.
+ */
+void AdaptivePingRate::reset() {
+    this->periodMS = this->minPeriodMS;
+    this->changeRateCMPerMS = 0;
+    this->hasLastMeasurement = false;
+    this->wasLastMeasurementValid = false;
+    this->lastDistanceCM = 0;
+    this->lastStartTimeMS = 0;
+    this->lastDurationMS = 0;
+    this->maxDurationMS = 0;
+    this->firstStartTimeMS = 0;
+    this->measurementsCount = 0;
+}
+
+/**
+ * @return If the current period has passed since the start of the last measurement
+ */
+bool AdaptivePingRate::isMeasurementDue(const unsigned long& nowMS) const {
+    return !this->hasLastMeasurement || nowMS - this->lastStartTimeMS >= this->periodMS;
+}
+
+/**
+ * The period at which the expected change of the distance is half of the significant change.
+ * It grows at most two times per measurement, so a single calm measurement doesn't jump straight to the max period.
+ */
+unsigned long AdaptivePingRate::calculateAdaptedPeriodMS() {
+
+    unsigned long adaptedPeriodMS = this->maxPeriodMS;
+
+    if (this->changeRateCMPerMS > 0) {
+        float calmPeriodMS = this->significantChangeCM / 2 / this->changeRateCMPerMS;
+
+        if (calmPeriodMS < this->maxPeriodMS)
+            adaptedPeriodMS = static_cast<unsigned long>(calmPeriodMS);
+    }
+
+    adaptedPeriodMS = min(adaptedPeriodMS, max(this->periodMS * 2, 1UL));
+
+    return constrain(adaptedPeriodMS, this->minPeriodMS, this->maxPeriodMS);
+}
+
+/**
+ * Will update the estimated rate of change and the period with the given measurement.
+ *
+ * @param isValid If the measurement had valid samples. The distance of invalid measurements is ignored
+ * @param distanceCM The distance of the measurement in centimeters
+ * @param startTimeMS When the measurement started
+ * @param endTimeMS When the measurement ended
+ */
+void AdaptivePingRate::addMeasurement(const bool& isValid, const float& distanceCM, const unsigned long& startTimeMS, const unsigned long& endTimeMS) {
+
+    if (this->measurementsCount == 0)
+        this->firstStartTimeMS = startTimeMS;
+
+    this->measurementsCount++;
+    this->lastDurationMS = endTimeMS - startTimeMS;
+    this->maxDurationMS = max(this->maxDurationMS, this->lastDurationMS);
+
+    bool isSignificantChange;
+
+    if (!this->hasLastMeasurement || isValid != this->wasLastMeasurementValid) {
+        isSignificantChange = true;
+    } else if (!isValid) {
+        isSignificantChange = false;
+    } else {
+        float changeCM = fabs(distanceCM - this->lastDistanceCM);
+        unsigned long elapsedMS = max(startTimeMS - this->lastStartTimeMS, 1UL);
+
+        this->changeRateCMPerMS += DEFAULT_ADAPTIVE_CHANGE_RATE_SMOOTHING * (changeCM / elapsedMS - this->changeRateCMPerMS);
+        isSignificantChange = changeCM > this->significantChangeCM;
+    }
+
+    if (isSignificantChange) {
+        this->changeRateCMPerMS = 0;
+        this->periodMS = this->minPeriodMS;
+    } else {
+        this->periodMS = this->calculateAdaptedPeriodMS();
+    }
+
+    this->hasLastMeasurement = true;
+    this->wasLastMeasurementValid = isValid;
+    this->lastStartTimeMS = startTimeMS;
+
+    if (isValid)
+        this->lastDistanceCM = distanceCM;
+}
+
+/**
+ * Will keep the learned period and rate of change, but move the times to the given clock. For example after a restart, when millis() starts from 0.
+ * The next measurement is due at once and the effective rate is counted again.
+ */
+void AdaptivePingRate::rebaseTime(const unsigned long& nowMS) {
+    this->lastStartTimeMS = nowMS - this->periodMS;
+    this->firstStartTimeMS = 0;
+    this->measurementsCount = 0;
+}
+
+unsigned long AdaptivePingRate::getPeriodMS() const {
+    return this->periodMS;
+}
+
+unsigned long AdaptivePingRate::getMinPeriodMS() const {
+    return this->minPeriodMS;
+}
+
+unsigned long AdaptivePingRate::getMaxPeriodMS() const {
+    return this->maxPeriodMS;
+}
+
+/**
+ * @return The smoothed rate of change of the distance, since the last significant change
+ */
+float AdaptivePingRate::getChangeRateCMPerSecond() const {
+    return this->changeRateCMPerMS * 1000;
+}
+
+unsigned long AdaptivePingRate::getMeasurementsCount() const {
+    return this->measurementsCount;
+}
+
+/**
+ * @return How many measurements per second were made, between the first and the last measurement
+ */
+float AdaptivePingRate::getEffectiveRateHz() const {
+
+    if (this->measurementsCount < 2 || this->lastStartTimeMS == this->firstStartTimeMS)
+        return 0;
+
+    return (this->measurementsCount - 1) * 1000.00f / (this->lastStartTimeMS - this->firstStartTimeMS);
+}
+
+/**
+ * A change that happens right after a measurement has started is missed by it and seen by the next one,
+ * which starts after the current period and ends after the duration of the measurement.
+ *
+ * @return The longest time until a change is seen with the current period
+ */
+unsigned long AdaptivePingRate::getWorstCaseDetectionLatencyMS() const {
+    return this->periodMS + this->lastDurationMS;
+}
+
+/**
+ * @return The longest time until a change is seen with any period, the bound when the scene has been calm
+ */
+unsigned long AdaptivePingRate::getMaxDetectionLatencyMS() const {
+    return this->maxPeriodMS + this->maxDurationMS;
+}
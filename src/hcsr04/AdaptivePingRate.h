@@ -0,0 +1,71 @@
+#ifndef HC_SR04_ADAPTIVEPINGRATE_H
+#define HC_SR04_ADAPTIVEPINGRATE_H
+
+#include <Arduino.h>
+
+#define DEFAULT_ADAPTIVE_CHANGE_RATE_SMOOTHING 0.25f
+
+/**
+ * Decides how often a sensor has to be pinged, based on how fast the scene changes.
+ *
+ * After each measurement the rate of change of the distance is estimated (smoothed over the recent measurements)
+ * and the period is chosen so that between two pings the distance is expected to change by less than half of
+ * the significant change. While the scene doesn't change the period grows (at most doubles per measurement) up to the max period.
+ * Any significant change, or a switch between valid and invalid measurements, snaps the period back to the min period.
+ */
+class AdaptivePingRate {
+
+private:
+
+    unsigned long minPeriodMS;
+    unsigned long maxPeriodMS;
+    float significantChangeCM;
+
+    unsigned long periodMS;
+    float changeRateCMPerMS;
+
+    bool hasLastMeasurement;
+    bool wasLastMeasurementValid;
+    float lastDistanceCM;
+    unsigned long lastStartTimeMS;
+    unsigned long lastDurationMS;
+    unsigned long maxDurationMS;
+
+    unsigned long firstStartTimeMS;
+    unsigned long measurementsCount;
+
+    unsigned long calculateAdaptedPeriodMS();
+
+public:
+
+    AdaptivePingRate();
+
+    AdaptivePingRate(const unsigned long& minPeriodMS, const unsigned long& maxPeriodMS, const float& significantChangeCM);
+
+    bool isMeasurementDue(const unsigned long& nowMS) const;
+
+    void addMeasurement(const bool& isValid, const float& distanceCM, const unsigned long& startTimeMS, const unsigned long& endTimeMS);
+
+    void reset();
+
+    void rebaseTime(const unsigned long& nowMS);
+
+    unsigned long getPeriodMS() const;
+
+    unsigned long getMinPeriodMS() const;
+
+    unsigned long getMaxPeriodMS() const;
+
+    float getChangeRateCMPerSecond() const;
+
+    unsigned long getMeasurementsCount() const;
+
+    float getEffectiveRateHz() const;
+
+    unsigned long getWorstCaseDetectionLatencyMS() const;
+
+    unsigned long getMaxDetectionLatencyMS() const;
+};
+
+
+#endif //HC_SR04_ADAPTIVEPINGRATE_H
@@ -0,0 +1,267 @@
+#include "BackgroundModel.h"
+
+BackgroundModel::BackgroundModel() {
+    this->learningRate = DEFAULT_BACKGROUND_LEARNING_RATE;
+    this->learningMeasurements = DEFAULT_BACKGROUND_LEARNING_MEASUREMENTS;
+    this->matchDeviations = DEFAULT_BACKGROUND_MATCH_DEVIATIONS;
+    this->minDeviationCM = DEFAULT_BACKGROUND_MIN_DEVIATION_CENTIMETERS;
+    this->backgroundWeight = DEFAULT_BACKGROUND_WEIGHT;
+    this->reportedChangeCM = DEFAULT_BACKGROUND_REPORTED_CHANGE_CENTIMETERS;
+    this->foregroundPeriodMS = DEFAULT_BACKGROUND_FOREGROUND_PERIOD_MS;
+    this->backgroundPeriodMS = DEFAULT_BACKGROUND_PERIOD_MS;
+    this->holdMeasurements = DEFAULT_BACKGROUND_HOLD_MEASUREMENTS;
+    this->reset();
+}
+
+/**
+ * @param learningRate How fast the background follows the measurements. Smaller is slower, but a passing object stays foreground longer
+ * @param learningMeasurements How many of the first measurements only learn the background. Nothing is reported until then
+ */
+void BackgroundModel::setLearning(const float& learningRate, const unsigned long& learningMeasurements) {
+    this->learningRate = constrain(learningRate, 0.0001f, 1.0f);
+    this->learningMeasurements = learningMeasurements;
+}
+
+/**
+ * @param matchDeviations How many standard deviations of a mode a measurement can be from it, to match it
+ * @param minDeviationValue The smallest standard deviation of a mode, so a very steady background doesn't make the noise of the sensor a foreground
+ */
+void BackgroundModel::setMatching(const float& matchDeviations, const float& minDeviationValue, const DistanceUnit& minDeviationUnit) {
+    this->matchDeviations = matchDeviations;
+    this->minDeviationCM = convertDistanceUnit(minDeviationValue, minDeviationUnit, DistanceUnit::CENTIMETERS);
+}
+
+/**
+ * @param backgroundWeight Which part of the measurements must be explained by the background modes. Between 0 and 1
+ */
+void BackgroundModel::setBackgroundWeight(const float& backgroundWeight) {
+    this->backgroundWeight = constrain(backgroundWeight, 0.0f, 1.0f);
+}
+
+/**
+ * @param reportedChangeValue How much the distance of a foreground must change, to be reported again
+ */
+void BackgroundModel::setReportedChange(const float& reportedChangeValue, const DistanceUnit& reportedChangeUnit) {
+    this->reportedChangeCM = convertDistanceUnit(reportedChangeValue, reportedChangeUnit, DistanceUnit::CENTIMETERS);
+}
+
+/**
+ * @param foregroundPeriodMS The period between the measurements while there is a foreground or the background isn't yet held
+ * @param backgroundPeriodMS The period between the measurements after the background held for the hold measurements
+ */
+void BackgroundModel::setSamplingPeriods(const unsigned long& foregroundPeriodMS, const unsigned long& backgroundPeriodMS, const unsigned long& holdMeasurements) {
+    this->foregroundPeriodMS = foregroundPeriodMS;
+    this->backgroundPeriodMS = max(foregroundPeriodMS, backgroundPeriodMS);
+    this->holdMeasurements = holdMeasurements;
+}
+
+/**
+ * Will forget the background and learn it again.
+ */
+void BackgroundModel::reset() {
+
+    for (uint8_t i = 0; i < BACKGROUND_MODEL_MODES; i++)
+        this->modes[i] = BackgroundMode{0, BACKGROUND_MAX_DEVIATION_CENTIMETERS * BACKGROUND_MAX_DEVIATION_CENTIMETERS, 0};
+
+    this->noEchoWeight = 0;
+    this->state = BackgroundState::LEARNING;
+    this->lastChange = BackgroundChange{BackgroundState::LEARNING, false, 0, 0};
+    this->measurementsCount = 0;
+    this->backgroundMeasurementsCount = 0;
+    this->reportedChangesCount = 0;
+}
+
+/**
+ * @return The index of the nearest mode, which is within the match deviations from the distance. -1 If there is none
+ */
+int8_t BackgroundModel::findMatchingMode(const float& distanceCM) const {
+
+    int8_t matchingModeIndex = -1;
+    float matchingDeviationCM = 0;
+
+    for (uint8_t i = 0; i < BACKGROUND_MODEL_MODES; i++) {
+        const BackgroundMode& mode = this->modes[i];
+
+        if (mode.weight <= 0)
+            continue;
+
+        float deviationCM = fabs(distanceCM - mode.meanCM);
+
+        if (deviationCM > this->matchDeviations * sqrt(mode.varianceCM2))
+            continue;
+
+        if (matchingModeIndex == -1 || deviationCM < matchingDeviationCM) {
+            matchingModeIndex = static_cast<int8_t>(i);
+            matchingDeviationCM = deviationCM;
+        }
+    }
+
+    return matchingModeIndex;
+}
+
+/**
+ * The modes and the no echo are ordered by their weights and the background is the strongest of them, until they reach the background weight.
+ * So a weight is in the background, if the weights stronger than it don't reach the background weight.
+ */
+bool BackgroundModel::isBackgroundWeight(const float& weight) const {
+
+    if (weight <= 0)
+        return false;
+
+    float strongerWeight = this->noEchoWeight > weight ? this->noEchoWeight : 0;
+
+    for (uint8_t i = 0; i < BACKGROUND_MODEL_MODES; i++)
+        strongerWeight += this->modes[i].weight > weight ? this->modes[i].weight : 0;
+
+    return strongerWeight < this->backgroundWeight;
+}
+
+/**
+ * The weights decay with the learning rate and the matched mode (or the no echo) gains it, so the weights always add up to 1.
+ * The learning measurements are learned with a rate of 1 / their count, which is their average.
+ */
+void BackgroundModel::learn(const bool& isValid, const float& distanceCM, const int8_t& matchingModeIndex) {
+
+    float rate = this->learningRate;
+
+    if (this->measurementsCount <= this->learningMeasurements)
+        rate = max(rate, 1.0f / static_cast<float>(this->measurementsCount));
+
+    for (uint8_t i = 0; i < BACKGROUND_MODEL_MODES; i++)
+        this->modes[i].weight *= 1 - rate;
+
+    this->noEchoWeight *= 1 - rate;
+
+    if (!isValid) {
+        this->noEchoWeight += rate;
+        return;
+    }
+
+    if (matchingModeIndex != -1) {
+        BackgroundMode& mode = this->modes[matchingModeIndex];
+        mode.weight += rate;
+
+        float modeRate = min(1.0f, rate / mode.weight);
+        float deviationCM = distanceCM - mode.meanCM;
+
+        mode.meanCM += modeRate * deviationCM;
+        mode.varianceCM2 += modeRate * (deviationCM * deviationCM - mode.varianceCM2);
+        mode.varianceCM2 = constrain(mode.varianceCM2, this->minDeviationCM * this->minDeviationCM, BACKGROUND_MAX_DEVIATION_CENTIMETERS * BACKGROUND_MAX_DEVIATION_CENTIMETERS);
+        return;
+    }
+
+    uint8_t weakestModeIndex = 0;
+
+    for (uint8_t i = 1; i < BACKGROUND_MODEL_MODES; i++) {
+        if (this->modes[i].weight < this->modes[weakestModeIndex].weight)
+            weakestModeIndex = i;
+    }
+
+    this->modes[weakestModeIndex] = BackgroundMode{distanceCM, BACKGROUND_MAX_DEVIATION_CENTIMETERS * BACKGROUND_MAX_DEVIATION_CENTIMETERS, rate};
+}
+
+/**
+ * Will classify the measurement by the background before it and then learn it.
+ *
+ * @param change Will be set to the state and the distance of the measurement, if it is reported
+ * @return If the measurement is reported: the state changed, or the foreground distance changed by more than the reported change
+ */
+bool BackgroundModel::add(const Measurement& measurement, BackgroundChange& change) {
+
+    bool isValid = measurement.getValidMeasurementsCount() > 0;
+    float distanceCM = isValid ? measurement.getDistance(DistanceUnit::CENTIMETERS) : 0;
+
+    int8_t matchingModeIndex = isValid ? this->findMatchingMode(distanceCM) : -1;
+    bool isBackground = isValid ? matchingModeIndex != -1 && this->isBackgroundWeight(this->modes[matchingModeIndex].weight) : this->isBackgroundWeight(this->noEchoWeight);
+
+    this->measurementsCount++;
+    this->learn(isValid, distanceCM, matchingModeIndex);
+
+    BackgroundState state = BackgroundState::LEARNING;
+
+    if (this->measurementsCount > this->learningMeasurements)
+        state = isBackground ? BackgroundState::BACKGROUND : BackgroundState::FOREGROUND;
+
+    this->backgroundMeasurementsCount = state == BackgroundState::BACKGROUND ? this->backgroundMeasurementsCount + 1 : 0;
+
+    bool isForegroundChanged = state == BackgroundState::FOREGROUND
+                               && this->state == BackgroundState::FOREGROUND
+                               && (isValid != this->lastChange.isValid || fabs(distanceCM - this->lastChange.distanceCM) > this->reportedChangeCM);
+
+    bool isReported = state != this->state || isForegroundChanged;
+    this->state = state;
+
+    if (!isReported)
+        return false;
+
+    float backgroundDistanceCM = 0;
+    bool hasBackgroundDistance = this->getBackgroundDistanceCM(backgroundDistanceCM);
+
+    change = BackgroundChange{state, isValid, distanceCM, isValid && hasBackgroundDistance ? distanceCM - backgroundDistanceCM : 0};
+
+    this->lastChange = change;
+    this->reportedChangesCount++;
+
+    return true;
+}
+
+BackgroundState BackgroundModel::getState() const {
+    return this->state;
+}
+
+/**
+ * @param distanceCM Will be set to the distance of the strongest mode
+ * @return If a distance was learned. It isn't, when there were only measurements without an echo
+ */
+bool BackgroundModel::getBackgroundDistanceCM(float& distanceCM) const {
+
+    int8_t strongestModeIndex = -1;
+
+    for (uint8_t i = 0; i < BACKGROUND_MODEL_MODES; i++) {
+        if (this->modes[i].weight > 0 && (strongestModeIndex == -1 || this->modes[i].weight > this->modes[strongestModeIndex].weight))
+            strongestModeIndex = static_cast<int8_t>(i);
+    }
+
+    if (strongestModeIndex == -1)
+        return false;
+
+    distanceCM = this->modes[strongestModeIndex].meanCM;
+
+    return true;
+}
+
+/**
+ * @param index Less than BACKGROUND_MODEL_MODES. A mode with a weight of 0 isn't used
+ */
+const BackgroundMode& BackgroundModel::getMode(const uint8_t& index) const {
+    return this->modes[index];
+}
+
+/**
+ * @return Which part of the recent measurements had no echo
+ */
+float BackgroundModel::getNoEchoWeight() const {
+    return this->noEchoWeight;
+}
+
+/**
+ * @return How long to wait until the next measurement. The background period, once the background held for the hold measurements
+ */
+unsigned long BackgroundModel::getSuggestedPeriodMS() const {
+
+    if (this->state == BackgroundState::BACKGROUND && this->backgroundMeasurementsCount >= this->holdMeasurements)
+        return this->backgroundPeriodMS;
+
+    return this->foregroundPeriodMS;
+}
+
+unsigned long BackgroundModel::getMeasurementsCount() const {
+    return this->measurementsCount;
+}
+
+/**
+ * @return How many times add reported a change. The other measurements were suppressed
+ */
+unsigned long BackgroundModel::getReportedChangesCount() const {
+    return this->reportedChangesCount;
+}
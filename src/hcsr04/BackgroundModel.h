@@ -0,0 +1,126 @@
+#ifndef HC_SR04_BACKGROUNDMODEL_H
+#define HC_SR04_BACKGROUNDMODEL_H
+
+#include <Arduino.h>
+#include "Measurement.h"
+
+#define BACKGROUND_MODEL_MODES 3
+#define BACKGROUND_MAX_DEVIATION_CENTIMETERS 10.00f
+
+#define DEFAULT_BACKGROUND_LEARNING_RATE 0.002f
+#define DEFAULT_BACKGROUND_LEARNING_MEASUREMENTS 20
+#define DEFAULT_BACKGROUND_MATCH_DEVIATIONS 2.50f
+#define DEFAULT_BACKGROUND_MIN_DEVIATION_CENTIMETERS 1.00f
+#define DEFAULT_BACKGROUND_WEIGHT 0.70f
+#define DEFAULT_BACKGROUND_REPORTED_CHANGE_CENTIMETERS 5.00f
+#define DEFAULT_BACKGROUND_FOREGROUND_PERIOD_MS 100
+#define DEFAULT_BACKGROUND_PERIOD_MS 1000
+#define DEFAULT_BACKGROUND_HOLD_MEASUREMENTS 10
+
+enum class BackgroundState : uint8_t {
+    LEARNING, BACKGROUND, FOREGROUND
+};
+
+/**
+ * What the BackgroundModel reports. The deviation is from the strongest background distance, 0 when there is none.
+ */
+struct BackgroundChange {
+
+    BackgroundState state;
+    bool isValid;
+    float distanceCM;
+    float deviationCM;
+};
+
+/**
+ * One of the distances, that the background is made of. For example the floor, or the floor and a swinging door.
+ */
+struct BackgroundMode {
+
+    float meanCM;
+    float varianceCM2;
+    float weight;
+};
+
+/**
+ * Learns the distances that a sensor usually measures (the background) and reports only what differs from them (the foreground).
+ * For example a sensor on the ceiling, which measures the floor most of the time.
+ *
+ * The background is a mixture of up to BACKGROUND_MODEL_MODES distances, each with a mean, a variance and a weight,
+ * and of the measurements without an echo. A measurement matches the nearest mode within the match deviations of it.
+ * The matched mode moves towards the measurement and gains weight, with the learning rate. A measurement, which matches no mode,
+ * replaces the weakest one. A new mode starts with and can't get wider than BACKGROUND_MAX_DEVIATION_CENTIMETERS, so a moving object
+ * doesn't stretch a mode over its path. The strongest modes, whose weights add up to the background weight, are the background.
+ * So a new object becomes a part of the background only if it stays, after ~ background weight / learning rate measurements.
+ * The learning measurements at the start are learned faster, by their average.
+ *
+ * Only the changes of the state and the changes of the foreground distance by more than the reported change are returned by add.
+ * While the background holds, the sensor can be measured less often (getSuggestedPeriodMS).
+ *
+ * The memory is fixed and each measurement takes a single pass over the modes.
+ */
+class BackgroundModel {
+
+private:
+
+    float learningRate;
+    unsigned long learningMeasurements;
+    float matchDeviations;
+    float minDeviationCM;
+    float backgroundWeight;
+    float reportedChangeCM;
+
+    unsigned long foregroundPeriodMS;
+    unsigned long backgroundPeriodMS;
+    unsigned long holdMeasurements;
+
+    BackgroundMode modes[BACKGROUND_MODEL_MODES];
+    float noEchoWeight;
+
+    BackgroundState state;
+    BackgroundChange lastChange;
+    unsigned long measurementsCount;
+    unsigned long backgroundMeasurementsCount;
+    unsigned long reportedChangesCount;
+
+    int8_t findMatchingMode(const float& distanceCM) const;
+
+    bool isBackgroundWeight(const float& weight) const;
+
+    void learn(const bool& isValid, const float& distanceCM, const int8_t& matchingModeIndex);
+
+public:
+
+    BackgroundModel();
+
+    void setLearning(const float& learningRate, const unsigned long& learningMeasurements);
+
+    void setMatching(const float& matchDeviations, const float& minDeviationValue, const DistanceUnit& minDeviationUnit);
+
+    void setBackgroundWeight(const float& backgroundWeight);
+
+    void setReportedChange(const float& reportedChangeValue, const DistanceUnit& reportedChangeUnit);
+
+    void setSamplingPeriods(const unsigned long& foregroundPeriodMS, const unsigned long& backgroundPeriodMS, const unsigned long& holdMeasurements);
+
+    bool add(const Measurement& measurement, BackgroundChange& change);
+
+    void reset();
+
+    BackgroundState getState() const;
+
+    bool getBackgroundDistanceCM(float& distanceCM) const;
+
+    const BackgroundMode& getMode(const uint8_t& index) const;
+
+    float getNoEchoWeight() const;
+
+    unsigned long getSuggestedPeriodMS() const;
+
+    unsigned long getMeasurementsCount() const;
+
+    unsigned long getReportedChangesCount() const;
+};
+
+
+#endif //HC_SR04_BACKGROUNDMODEL_H
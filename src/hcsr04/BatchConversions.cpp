@@ -0,0 +1,137 @@
+#include "BatchConversions.h"
+#include "HCSR04.h"
+#include "SoundSpeed.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @return The factor, which converts an echo length in microseconds to a distance in the given unit
+ */
+static float calculateSignalLengthToDistanceFactor(const float& temperature, const TemperatureUnit& temperatureUnit, const DistanceUnit& distanceUnit) {
+
+    float soundSpeedInCentimetersPerMicrosecond = convertMetersPerSecondToCentimetersPerMicrosecond(calculateSoundSpeedByTemperature(temperature, temperatureUnit));
+
+    return soundSpeedInCentimetersPerMicrosecond / 2 * getDistanceUnitConversionFactor(DistanceUnit::CENTIMETERS, distanceUnit);
+}
+
+/**
+ * Multiplies each element with the factor.
+ */
+static void multiply(const float* values, float* results, const size_t& count, const float& factor) {
+
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256 factors = _mm256_set1_ps(factor);
+
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(results + i, _mm256_mul_ps(_mm256_loadu_ps(values + i), factors));
+#elif defined(__SSE2__)
+    __m128 factors = _mm_set1_ps(factor);
+
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(results + i, _mm_mul_ps(_mm_loadu_ps(values + i), factors));
+#endif
+
+    for (; i < count; i++)
+        results[i] = values[i] * factor;
+}
+
+/**
+ * Will convert the echo lengths to distances.
+ *
+ * @param signalLengthsUS The lengths of the HIGH signal from the HC-SR04 in microseconds
+ * @param distances Will be filled with the distances. Must have space for count elements
+ * @param count How many echoes will be converted
+ * @param temperature The ambient temperature, which determinates the speed of the sound
+ * @param temperatureUnit The unit of the temperature
+ * @param distanceUnit In what distance unit the distances to be returned
+ */
+void convertSignalLengthsToDistances(const uint16_t* signalLengthsUS, float* distances, const size_t& count, const float& temperature, const TemperatureUnit& temperatureUnit, const DistanceUnit& distanceUnit) {
+
+    float factor = calculateSignalLengthToDistanceFactor(temperature, temperatureUnit, distanceUnit);
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256 factors = _mm256_set1_ps(factor);
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i signalLengths = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(signalLengthsUS + i)));
+        _mm256_storeu_ps(distances + i, _mm256_mul_ps(_mm256_cvtepi32_ps(signalLengths), factors));
+    }
+#elif defined(__SSE2__)
+    __m128 factors = _mm_set1_ps(factor);
+    __m128i zero = _mm_setzero_si128();
+
+    for (; i + 8 <= count; i += 8) {
+        __m128i signalLengths = _mm_loadu_si128(reinterpret_cast<const __m128i*>(signalLengthsUS + i));
+        _mm_storeu_ps(distances + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(signalLengths, zero)), factors));
+        _mm_storeu_ps(distances + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(signalLengths, zero)), factors));
+    }
+#endif
+
+    for (; i < count; i++)
+        distances[i] = static_cast<float>(signalLengthsUS[i]) * factor;
+}
+
+/**
+ * Will convert the distances from one unit to another.
+ *
+ * @param distances The distances in the fromUnit
+ * @param convertedDistances Will be filled with the distances in the toUnit. Can be the same array as the distances
+ * @param count How many distances will be converted
+ */
+void convertDistanceUnits(const float* distances, float* convertedDistances, const size_t& count, const DistanceUnit& fromUnit, const DistanceUnit& toUnit) {
+    multiply(distances, convertedDistances, count, getDistanceUnitConversionFactor(fromUnit, toUnit));
+}
+
+/**
+ * Will check which of the echoes are valid. An echo is valid, if it has arrived (not 0), its signal has not timed out
+ * and its distance doesn't exceed the max distance. The max distance is converted to an echo length once, so the check is a comparison per echo.
+ *
+ * @param signalLengthsUS The lengths of the HIGH signal from the HC-SR04 in microseconds
+ * @param isValid Will be filled with 1 for the valid echoes and 0 for the invalid ones
+ * @param count How many echoes will be checked
+ * @return How many of the echoes are valid
+ */
+size_t classifySignalLengths(const uint16_t* signalLengthsUS, uint8_t* isValid, const size_t& count, const float& maxDistance, const DistanceUnit& maxDistanceUnit, const float& temperature, const TemperatureUnit& temperatureUnit) {
+
+    float maxSignalLengthUS = maxDistance / calculateSignalLengthToDistanceFactor(temperature, temperatureUnit, maxDistanceUnit);
+
+    //The echoes are valid below this limit
+    uint16_t limitUS = TIMEOUT_SIGNAL_LENGTH_US;
+
+    if (maxSignalLengthUS < TIMEOUT_SIGNAL_LENGTH_US)
+        limitUS = maxSignalLengthUS < 0 ? 0 : static_cast<uint16_t>(maxSignalLengthUS) + 1;
+
+    size_t validCount = 0;
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    //There is no unsigned 16 bit comparison in SSE2, so the sign bits are flipped and the signed one is used
+    __m128i signBits = _mm_set1_epi16(static_cast<short>(0x8000));
+    __m128i limits = _mm_xor_si128(_mm_set1_epi16(static_cast<short>(limitUS)), signBits);
+    __m128i zero = _mm_setzero_si128();
+    __m128i ones = _mm_set1_epi8(1);
+
+    for (; i + 8 <= count; i += 8) {
+        __m128i signalLengths = _mm_loadu_si128(reinterpret_cast<const __m128i*>(signalLengthsUS + i));
+
+        __m128i isBelowLimit = _mm_cmplt_epi16(_mm_xor_si128(signalLengths, signBits), limits);
+        __m128i isArrived = _mm_xor_si128(_mm_cmpeq_epi16(signalLengths, zero), _mm_set1_epi16(-1));
+        __m128i isValidMask = _mm_packs_epi16(_mm_and_si128(isBelowLimit, isArrived), zero);
+
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(isValid + i), _mm_and_si128(isValidMask, ones));
+        validCount += __builtin_popcount(_mm_movemask_epi8(isValidMask));
+    }
+#endif
+
+    for (; i < count; i++) {
+        isValid[i] = signalLengthsUS[i] != 0 && signalLengthsUS[i] < limitUS ? 1 : 0;
+        validCount += isValid[i];
+    }
+
+    return validCount;
+}
@@ -0,0 +1,22 @@
+#ifndef HC_SR04_BATCHCONVERSIONS_H
+#define HC_SR04_BATCHCONVERSIONS_H
+
+#include <Arduino.h>
+#include "DistanceUnits.h"
+#include "TemperatureUnits.h"
+
+/*
+ * Conversions over contiguous arrays, for processing many recorded echoes at once (for example traces on the host).
+ *
+ * The factors are resolved once per call, so each element costs a single multiplication.
+ * When compiled for a x86 host with AVX2 or SSE2 enabled, the loops run vectorized. Everywhere else (the AVR) the portable scalar loops are used.
+ * The results are the same as converting the elements one by one with the same factors.
+ */
+
+void convertSignalLengthsToDistances(const uint16_t* signalLengthsUS, float* distances, const size_t& count, const float& temperature, const TemperatureUnit& temperatureUnit, const DistanceUnit& distanceUnit);
+
+void convertDistanceUnits(const float* distances, float* convertedDistances, const size_t& count, const DistanceUnit& fromUnit, const DistanceUnit& toUnit);
+
+size_t classifySignalLengths(const uint16_t* signalLengthsUS, uint8_t* isValid, const size_t& count, const float& maxDistance, const DistanceUnit& maxDistanceUnit, const float& temperature, const TemperatureUnit& temperatureUnit);
+
+#endif //HC_SR04_BATCHCONVERSIONS_H
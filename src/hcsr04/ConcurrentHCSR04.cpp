@@ -0,0 +1,91 @@
+#include "ConcurrentHCSR04.h"
+
+ConcurrentHCSR04::ConcurrentHCSR04(HCSR04& hcsr04, const MeasurementConfiguration& configuration) : hcsr04(hcsr04) {
+    this->isConfigurationLocked = false;
+    this->isStopRequested = false;
+    this->hasMeasurement = false;
+    this->samplesCount = 0;
+
+    this->configuration.write(configuration);
+}
+
+/**
+ * Sampling thread only. Will do a measurement with the latest configuration and publish it.
+ */
+void ConcurrentHCSR04::sample() {
+
+    MeasurementConfiguration measurementConfiguration;
+    this->configuration.read(measurementConfiguration);
+
+    this->latestMeasurement.write(this->hcsr04.measure(measurementConfiguration));
+
+    //Not the sequence, because it wraps around to zero (on the AVR after 128 measurements)
+    __atomic_store_n(&this->hasMeasurement, true, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&this->samplesCount, this->samplesCount + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Sampling thread only. Will sample until stop() is called. For example the function of a std::thread or a FreeRTOS task.
+ */
+void ConcurrentHCSR04::run() {
+
+    while (!__atomic_load_n(&this->isStopRequested, __ATOMIC_ACQUIRE))
+        this->sample();
+}
+
+/**
+ * Will make run() return after the current measurement. Once stopped, run() returns at once.
+ */
+void ConcurrentHCSR04::stop() {
+    __atomic_store_n(&this->isStopRequested, true, __ATOMIC_RELEASE);
+}
+
+/**
+ * Any thread. Doesn't wait for the sampling thread, only for other threads that change the configuration at the same time.
+ */
+void ConcurrentHCSR04::setConfiguration(const MeasurementConfiguration& configuration) {
+
+    while (__atomic_test_and_set(&this->isConfigurationLocked, __ATOMIC_ACQUIRE)) {
+    }
+
+    this->configuration.write(configuration);
+
+    __atomic_clear(&this->isConfigurationLocked, __ATOMIC_RELEASE);
+}
+
+MeasurementConfiguration ConcurrentHCSR04::getConfiguration() const {
+
+    MeasurementConfiguration measurementConfiguration;
+    this->configuration.read(measurementConfiguration);
+
+    return measurementConfiguration;
+}
+
+/**
+ * Any thread.
+ *
+ * @param measurement Will be set to the latest measurement. Not changed if there is none yet
+ * @return If there was a measurement
+ */
+bool ConcurrentHCSR04::getLatestMeasurement(Measurement& measurement) const {
+
+    if (!__atomic_load_n(&this->hasMeasurement, __ATOMIC_ACQUIRE))
+        return false;
+
+    this->latestMeasurement.read(measurement);
+
+    return true;
+}
+
+/**
+ * @return Grows with each published measurement, so a reader can know if there is a new one without copying it.
+ * It wraps around (see SeqLock::getSequence()), so compare it only with != or SeqLock<Measurement>::isSequenceAfter()
+ */
+SeqLock<Measurement>::Sequence ConcurrentHCSR04::getMeasurementSequence() const {
+    return this->latestMeasurement.getSequence();
+}
+
+uint32_t ConcurrentHCSR04::getSamplesCount() const {
+    return __atomic_load_n(&this->samplesCount, __ATOMIC_ACQUIRE);
+}
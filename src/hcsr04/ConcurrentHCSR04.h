@@ -0,0 +1,54 @@
+#ifndef HC_SR04_CONCURRENTHCSR04_H
+#define HC_SR04_CONCURRENTHCSR04_H
+
+#include <Arduino.h>
+#include "HCSR04.h"
+#include "SeqLock.h"
+
+/**
+ * Shares a sensor between threads, cores or an interrupt and the loop.
+ *
+ * The HCSR04 is used only by the sampling thread, which calls run() (or sample() from its own loop) and publishes each measurement through a SeqLock.
+ * Any number of threads read the latest measurement without locks and without ever stopping the sampling.
+ * The configuration is published to the sampling thread the same way, so it can be changed while sampling. It is taken by the next measurement.
+ * The threads that change the configuration take turns with a spin lock, which only they use.
+ *
+ * After the HCSR04 is given to it, nothing else may call the HCSR04.
+ */
+class ConcurrentHCSR04 {
+
+private:
+
+    HCSR04& hcsr04;
+
+    SeqLock<MeasurementConfiguration> configuration;
+    SeqLock<Measurement> latestMeasurement;
+
+    bool isConfigurationLocked;
+    bool isStopRequested;
+    bool hasMeasurement;
+    uint32_t samplesCount;
+
+public:
+
+    ConcurrentHCSR04(HCSR04& hcsr04, const MeasurementConfiguration& configuration);
+
+    void sample();
+
+    void run();
+
+    void stop();
+
+    void setConfiguration(const MeasurementConfiguration& configuration);
+
+    MeasurementConfiguration getConfiguration() const;
+
+    bool getLatestMeasurement(Measurement& measurement) const;
+
+    SeqLock<Measurement>::Sequence getMeasurementSequence() const;
+
+    uint32_t getSamplesCount() const;
+};
+
+
+#endif //HC_SR04_CONCURRENTHCSR04_H
@@ -1,35 +1,54 @@
 #include "DistanceUnits.h"
 
+#include <Arduino.h>
+
+#define DISTANCE_UNITS_COUNT 5
+
+/**
+ * The factors that convert a distance in the unit of the row to the unit of the column, in the order of the DistanceUnit.
+ * Kept in the flash, so it doesn't take RAM on the AVR.
+ */
+static const float DISTANCE_UNIT_CONVERSION_FACTORS[DISTANCE_UNITS_COUNT][DISTANCE_UNITS_COUNT] PROGMEM = {
+        /*                CENTIMETERS  METERS      INCH          FOOT          YARD */
+        /* CENTIMETERS */ {1.00f,       0.01f,      0.393700787f, 0.032808399f, 0.010936133f},
+        /* METERS      */ {100.00f,     1.00f,      39.3700787f,  3.2808399f,   1.0936133f},
+        /* INCH        */ {2.54f,       0.0254f,    1.00f,        0.0833333333f, 0.0277777778f},
+        /* FOOT        */ {30.48f,      0.3048f,    12.00f,       1.00f,        0.333333333f},
+        /* YARD        */ {91.44f,      0.9144f,    36.00f,       3.00f,        1.00f}
+};
+
 /**
  * Will converted the given distance in the given fromUnit to the given toUnit
  *
  * @param distance The distance that will be converted
- * @param fromUnit The unit that the distance will be converted to
- * @param toUnit The unit that the distance is now
- * @return The converted distance in the given fromUnit to the given toUnit. -1 If the given fromUnit is not yet implemented.
+ * @param fromUnit The unit that the distance is now
+ * @param toUnit The unit that the distance will be converted to
+ * @return The converted distance in the given fromUnit to the given toUnit. -1 If one of the units is not yet implemented.
  */
 float convertDistanceUnit(const float& distance, const DistanceUnit& fromUnit, const DistanceUnit& toUnit) {
 
-    switch (fromUnit) {
+    if (fromUnit == toUnit)
+        return distance;
 
-        case DistanceUnit::CENTIMETERS:
-            return convertCentimetersTo(distance, toUnit);
+    float conversionFactor = getDistanceUnitConversionFactor(fromUnit, toUnit);
 
-        case DistanceUnit::METERS:
-            return convertMetersTo(distance, toUnit);
+    return conversionFactor < 0 ? -1 : distance * conversionFactor;
+}
 
-        case DistanceUnit::INCH:
-            return convertInchesTo(distance, toUnit);
+/**
+ * All of the distance units are proportional, so every conversion is a multiplication by a factor from a single table lookup.
+ *
+ * @return The factor, which converts a distance in the fromUnit to the toUnit. -1 If one of the units is not yet implemented.
+ */
+float getDistanceUnitConversionFactor(const DistanceUnit& fromUnit, const DistanceUnit& toUnit) {
 
-        case DistanceUnit::FOOT:
-            return convertFootTo(distance, toUnit);
+    uint8_t fromIndex = static_cast<uint8_t>(fromUnit);
+    uint8_t toIndex = static_cast<uint8_t>(toUnit);
 
-        case DistanceUnit::YARD:
-            return convertYardsTo(distance, toUnit);
+    if (fromIndex >= DISTANCE_UNITS_COUNT || toIndex >= DISTANCE_UNITS_COUNT)
+        return -1;
 
-        default:
-            return -1;
-    }
+    return pgm_read_float(&DISTANCE_UNIT_CONVERSION_FACTORS[fromIndex][toIndex]);
 }
 
 /**
@@ -40,28 +59,7 @@ float convertDistanceUnit(const float& distance, const DistanceUnit& fromUnit, c
  * @return The converted centimeters to the given unit. -1 If the given toUnit is not yet implemented.
  */
 float convertCentimetersTo(const float& centimeters, const DistanceUnit& toUnit) {
-
-    switch (toUnit) {
-
-        case DistanceUnit::CENTIMETERS:
-            return centimeters;
-
-        case DistanceUnit::METERS:
-            return centimeters / 100.00f;
-
-        case DistanceUnit::INCH:
-            return centimeters * 0.393700787f;
-
-        case DistanceUnit::FOOT:
-            return centimeters * 0.032808399f;
-
-        case DistanceUnit::YARD:
-            return centimeters * 0.010936133f;
-
-        default:
-            return -1;
-    }
-
+    return convertDistanceUnit(centimeters, DistanceUnit::CENTIMETERS, toUnit);
 }
 
 /**
@@ -72,27 +70,7 @@ float convertCentimetersTo(const float& centimeters, const DistanceUnit& toUnit)
  * @return The converted meters to the given unit. -1 If the given toUnit is not yet implemented.
  */
 float convertMetersTo(const float& meters, const DistanceUnit& toUnit) {
-
-    switch (toUnit) {
-
-        case DistanceUnit::CENTIMETERS:
-            return meters * 100.00f;
-
-        case DistanceUnit::METERS:
-            return meters;
-
-        case DistanceUnit::INCH:
-            return meters * 39.3700787f;
-
-        case DistanceUnit::FOOT:
-            return meters * 3.2808399f;
-
-        case DistanceUnit::YARD:
-            return meters * 1.0936133f;
-
-        default:
-            return -1;
-    }
+    return convertDistanceUnit(meters, DistanceUnit::METERS, toUnit);
 }
 
 /**
@@ -103,27 +81,7 @@ float convertMetersTo(const float& meters, const DistanceUnit& toUnit) {
  * @return The converted inches to the given unit. -1 If the given toUnit is not yet implemented.
  */
 float convertInchesTo(const float& inches, const DistanceUnit& toUnit) {
-
-    switch (toUnit) {
-
-        case DistanceUnit::CENTIMETERS:
-            return inches * 2.54f;
-
-        case DistanceUnit::METERS:
-            return inches * 0.0254f;
-
-        case DistanceUnit::INCH:
-            return inches;
-
-        case DistanceUnit::FOOT:
-            return inches * 0.0833333333f;
-
-        case DistanceUnit::YARD:
-            return inches * 0.0277777778f;
-
-        default:
-            return -1;
-    }
+    return convertDistanceUnit(inches, DistanceUnit::INCH, toUnit);
 }
 
 /**
@@ -134,27 +92,7 @@ float convertInchesTo(const float& inches, const DistanceUnit& toUnit) {
  * @return The converted foot to the given unit. -1 If the given toUnit is not yet implemented.
  */
 float convertFootTo(const float& foot, const DistanceUnit& toUnit) {
-
-    switch (toUnit) {
-
-        case DistanceUnit::CENTIMETERS:
-            return foot * 30.48f;
-
-        case DistanceUnit::METERS:
-            return foot * 0.3048f;
-
-        case DistanceUnit::INCH:
-            return foot * 12.00f;
-
-        case DistanceUnit::FOOT:
-            return foot;
-
-        case DistanceUnit::YARD:
-            return foot * 0.333333333f;
-
-        default:
-            return -1;
-    }
+    return convertDistanceUnit(foot, DistanceUnit::FOOT, toUnit);
 }
 
 /**
@@ -165,27 +103,7 @@ float convertFootTo(const float& foot, const DistanceUnit& toUnit) {
  * @return The converted yards to the given unit. -1 If the given toUnit is not yet implemented.
  */
 float convertYardsTo(const float& yards, const DistanceUnit& toUnit) {
-
-    switch (toUnit) {
-
-        case DistanceUnit::CENTIMETERS:
-            return yards * 91.44f;
-
-        case DistanceUnit::METERS:
-            return yards * 0.9144f;
-
-        case DistanceUnit::INCH:
-            return yards * 36.00f;
-
-        case DistanceUnit::FOOT:
-            return yards * 3.00f;
-
-        case DistanceUnit::YARD:
-            return yards;
-
-        default:
-            return -1;
-    }
+    return convertDistanceUnit(yards, DistanceUnit::YARD, toUnit);
 }
 
 /**
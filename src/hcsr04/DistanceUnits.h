@@ -1,7 +1,9 @@
 #ifndef HC_SR04_DISTANCEUNITS_H
 #define HC_SR04_DISTANCEUNITS_H
 
-enum class DistanceUnit {
+#include <stdint.h>
+
+enum class DistanceUnit : uint8_t {
 
     //Metric
     CENTIMETERS, METERS,
@@ -12,6 +14,8 @@ enum class DistanceUnit {
 
 float convertDistanceUnit(const float& distance, const DistanceUnit& fromUnit, const DistanceUnit& toUnit);
 
+float getDistanceUnitConversionFactor(const DistanceUnit& fromUnit, const DistanceUnit& toUnit);
+
 float convertCentimetersTo(const float& centimeters, const DistanceUnit& toUnit);
 
 float convertMetersTo(const float& meters, const DistanceUnit& toUnit);
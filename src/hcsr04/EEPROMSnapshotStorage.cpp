@@ -0,0 +1,18 @@
+#include "EEPROMSnapshotStorage.h"
+#include <EEPROM.h>
+
+size_t EEPROMSnapshotStorage::getLength() {
+    return EEPROM.length();
+}
+
+void EEPROMSnapshotStorage::read(const size_t& address, uint8_t* data, const size_t& length) {
+
+    for (size_t i = 0; i < length; i++)
+        data[i] = EEPROM.read(static_cast<int>(address + i));
+}
+
+void EEPROMSnapshotStorage::write(const size_t& address, const uint8_t* data, const size_t& length) {
+
+    for (size_t i = 0; i < length; i++)
+        EEPROM.update(static_cast<int>(address + i), data[i]);
+}
@@ -0,0 +1,22 @@
+#ifndef HC_SR04_EEPROMSNAPSHOTSTORAGE_H
+#define HC_SR04_EEPROMSNAPSHOTSTORAGE_H
+
+#include <Arduino.h>
+#include "SnapshotStorage.h"
+
+/**
+ * The EEPROM of the board. Only the changed bytes are written (EEPROM.update).
+ */
+class EEPROMSnapshotStorage : public SnapshotStorage {
+
+public:
+
+    size_t getLength() override;
+
+    void read(const size_t& address, uint8_t* data, const size_t& length) override;
+
+    void write(const size_t& address, const uint8_t* data, const size_t& length) override;
+};
+
+
+#endif //HC_SR04_EEPROMSNAPSHOTSTORAGE_H
@@ -0,0 +1,15 @@
+#ifndef HC_SR04_ECHOCLUSTER_H
+#define HC_SR04_ECHOCLUSTER_H
+
+/**
+ * The samples of a measurement, which came from the same surface. In the distance unit of the measurement.
+ */
+struct EchoCluster {
+
+    float distance;
+    float spread;
+    unsigned int supportCount;
+};
+
+
+#endif //HC_SR04_ECHOCLUSTER_H
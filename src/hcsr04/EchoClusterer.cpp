@@ -0,0 +1,209 @@
+#include "EchoClusterer.h"
+
+EchoClusterer::EchoClusterer(HCSR04& hcsr04) : hcsr04(hcsr04) {
+    this->gapCM = DEFAULT_ECHO_CLUSTER_GAP_CENTIMETERS;
+    this->maxIterations = DEFAULT_ECHO_CLUSTER_MAX_ITERATIONS;
+}
+
+/**
+ * @param gapValue How far apart two surfaces must be, to be different clusters. Should be more than the noise of the sensor
+ */
+void EchoClusterer::setGap(const float& gapValue, const DistanceUnit& gapUnit) {
+    this->gapCM = convertDistanceUnit(gapValue, gapUnit, DistanceUnit::CENTIMETERS);
+}
+
+/**
+ * @param maxIterations How many times at most the clusters are refined. At least one
+ */
+void EchoClusterer::setMaxIterations(const uint8_t& maxIterations) {
+    this->maxIterations = max(maxIterations, static_cast<uint8_t>(1));
+}
+
+/**
+ * The samples are classified like in the measurement, only the valid ones are clustered.
+ *
+ * @return If the response is a valid sample
+ */
+static bool readSignalLengthUS(const HCSR04Response& hcsr04Response, const float& maxSignalLengthUS, float& signalLengthUS) {
+
+    if (hcsr04Response.isResponseTimedOut() || hcsr04Response.isSignalTimedOut(TIMEOUT_SIGNAL_LENGTH_US))
+        return false;
+
+    signalLengthUS = static_cast<float>(hcsr04Response.getHighSignalLengthUS());
+
+    return signalLengthUS <= maxSignalLengthUS;
+}
+
+static uint8_t findNearestCenter(const float* centersUS, const uint8_t& centersCount, const float& signalLengthUS) {
+
+    uint8_t nearestIndex = 0;
+
+    for (uint8_t i = 1; i < centersCount; i++) {
+        if (fabs(signalLengthUS - centersUS[i]) < fabs(signalLengthUS - centersUS[nearestIndex]))
+            nearestIndex = i;
+    }
+
+    return nearestIndex;
+}
+
+/**
+ * Will make a measurement with the given configuration and cluster its samples.
+ *
+ * @param clusters Will be filled with the clusters, from the nearest
+ * @param clustersCapacity The max clusters (K). At most MAX_ECHO_CLUSTERS
+ * @return How many clusters were found. 0 If there were no valid samples or the response cool down is active
+ */
+uint8_t EchoClusterer::measure(const MeasurementConfiguration& configuration, EchoCluster* clusters, const uint8_t& clustersCapacity) {
+
+    ResolvedMeasurementConfiguration measurementConfiguration = this->hcsr04.resolveConfiguration(configuration);
+    HCSR04Response hcsr04Responses[measurementConfiguration.samples];
+
+    Measurement measurement = this->hcsr04.measure(configuration, hcsr04Responses);
+
+    return this->cluster(hcsr04Responses, measurement.getTakenSamples(), measurementConfiguration, clusters, clustersCapacity);
+}
+
+/**
+ * Will cluster the raw responses of a measurement, for example the ones kept by HCSR04::measure(configuration, hcsr04Responses).
+ * The clustering is done on the lengths of the echo signals and only the centers are converted to distances.
+ *
+ * @param measurementConfiguration The configuration of the measurement, HCSR04::resolveConfiguration(configuration)
+ * @param clusters Will be filled with the clusters, from the nearest
+ * @param clustersCapacity The max clusters (K). At most MAX_ECHO_CLUSTERS
+ * @return How many clusters were found
+ */
+uint8_t EchoClusterer::cluster(const HCSR04Response* hcsr04Responses, const unsigned int& responsesCount, const ResolvedMeasurementConfiguration& measurementConfiguration, EchoCluster* clusters, const uint8_t& clustersCapacity) const {
+
+    uint8_t maxClustersCount = min(clustersCapacity, static_cast<uint8_t>(MAX_ECHO_CLUSTERS));
+
+    if (maxClustersCount == 0)
+        return 0;
+
+    float centimetersPerSignalLengthUS = measurementConfiguration.getSoundSpeedCentimetersPerMicrosecond() / 2;
+    float gapUS = this->gapCM / centimetersPerSignalLengthUS;
+    float maxSignalLengthUS = convertDistanceUnit(measurementConfiguration.maxDistanceValue, measurementConfiguration.maxDistanceUnit, DistanceUnit::CENTIMETERS) / centimetersPerSignalLengthUS;
+
+    float centersUS[MAX_ECHO_CLUSTERS];
+    uint8_t centersCount = 0;
+    float signalLengthUS = 0;
+
+    for (unsigned int i = 0; i < responsesCount && centersCount < maxClustersCount; i++) {
+
+        if (!readSignalLengthUS(hcsr04Responses[i], maxSignalLengthUS, signalLengthUS))
+            continue;
+
+        if (centersCount > 0 && fabs(signalLengthUS - centersUS[findNearestCenter(centersUS, centersCount, signalLengthUS)]) <= gapUS)
+            continue;
+
+        centersUS[centersCount++] = signalLengthUS;
+    }
+
+    if (centersCount == 0)
+        return 0;
+
+    float sumsUS[MAX_ECHO_CLUSTERS];
+    float minsUS[MAX_ECHO_CLUSTERS];
+    float maxsUS[MAX_ECHO_CLUSTERS];
+    unsigned int supportCounts[MAX_ECHO_CLUSTERS];
+
+    for (uint8_t iteration = 0; iteration < this->maxIterations; iteration++) {
+
+        for (uint8_t i = 0; i < centersCount; i++) {
+            sumsUS[i] = 0;
+            supportCounts[i] = 0;
+        }
+
+        for (unsigned int i = 0; i < responsesCount; i++) {
+
+            if (!readSignalLengthUS(hcsr04Responses[i], maxSignalLengthUS, signalLengthUS))
+                continue;
+
+            uint8_t nearestIndex = findNearestCenter(centersUS, centersCount, signalLengthUS);
+            bool isFirst = supportCounts[nearestIndex] == 0;
+
+            sumsUS[nearestIndex] += signalLengthUS;
+            supportCounts[nearestIndex]++;
+            minsUS[nearestIndex] = isFirst ? signalLengthUS : min(minsUS[nearestIndex], signalLengthUS);
+            maxsUS[nearestIndex] = isFirst ? signalLengthUS : max(maxsUS[nearestIndex], signalLengthUS);
+        }
+
+        bool isMoved = false;
+
+        for (uint8_t i = 0; i < centersCount; i++) {
+
+            if (supportCounts[i] == 0)
+                continue;
+
+            float centerUS = sumsUS[i] / static_cast<float>(supportCounts[i]);
+            isMoved = isMoved || centerUS != centersUS[i];
+            centersUS[i] = centerUS;
+        }
+
+        if (!isMoved)
+            break;
+    }
+
+    //Sorted from the nearest by insertion, there are at most MAX_ECHO_CLUSTERS
+    uint8_t order[MAX_ECHO_CLUSTERS];
+
+    for (uint8_t i = 0; i < centersCount; i++) {
+
+        uint8_t j = i;
+
+        for (; j > 0 && centersUS[order[j - 1]] > centersUS[i]; j--)
+            order[j] = order[j - 1];
+
+        order[j] = i;
+    }
+
+    float distancePerSignalLengthUS = convertDistanceUnit(centimetersPerSignalLengthUS, DistanceUnit::CENTIMETERS, measurementConfiguration.measurementDistanceUnit);
+    uint8_t clustersCount = 0;
+    float lastCenterUS = 0;
+    float lastMinUS = 0;
+    float lastMaxUS = 0;
+
+    for (uint8_t i = 0; i < centersCount; i++) {
+        uint8_t index = order[i];
+
+        if (supportCounts[index] == 0)
+            continue;
+
+        bool isMerged = clustersCount > 0 && centersUS[index] - lastCenterUS <= gapUS;
+
+        if (isMerged) {
+            EchoCluster& lastCluster = clusters[clustersCount - 1];
+            unsigned int supportCount = lastCluster.supportCount + supportCounts[index];
+
+            lastCenterUS = (lastCenterUS * static_cast<float>(lastCluster.supportCount) + sumsUS[index]) / static_cast<float>(supportCount);
+            lastMinUS = min(lastMinUS, minsUS[index]);
+            lastMaxUS = max(lastMaxUS, maxsUS[index]);
+            lastCluster.supportCount = supportCount;
+        } else {
+            lastCenterUS = centersUS[index];
+            lastMinUS = minsUS[index];
+            lastMaxUS = maxsUS[index];
+            clusters[clustersCount++].supportCount = supportCounts[index];
+        }
+
+        EchoCluster& cluster = clusters[clustersCount - 1];
+        cluster.distance = lastCenterUS * distancePerSignalLengthUS;
+        cluster.spread = (lastMaxUS - lastMinUS) * distancePerSignalLengthUS;
+    }
+
+    return clustersCount;
+}
+
+/**
+ * @return The index of the cluster with the most samples. The nearest one of them, if there are more
+ */
+uint8_t findStrongestEchoCluster(const EchoCluster* clusters, const uint8_t& clustersCount) {
+
+    uint8_t strongestIndex = 0;
+
+    for (uint8_t i = 1; i < clustersCount; i++) {
+        if (clusters[i].supportCount > clusters[strongestIndex].supportCount)
+            strongestIndex = i;
+    }
+
+    return strongestIndex;
+}
@@ -0,0 +1,49 @@
+#ifndef HC_SR04_ECHOCLUSTERER_H
+#define HC_SR04_ECHOCLUSTERER_H
+
+#include <Arduino.h>
+#include "HCSR04.h"
+#include "EchoCluster.h"
+
+#define MAX_ECHO_CLUSTERS 4
+#define DEFAULT_ECHO_CLUSTER_GAP_CENTIMETERS 10.00f
+#define DEFAULT_ECHO_CLUSTER_MAX_ITERATIONS 4
+
+/**
+ * Groups the samples of a measurement by the surface they came from, for scenes with more than one reflector.
+ * For example a person in a doorway and the wall behind them, where the average of the samples is a distance between both.
+ *
+ * The clusters are seeded by the first samples, which are further than the gap from the seeds before them,
+ * and then refined like k-means for at most the max iterations. Clusters that end up closer than the gap are merged.
+ * When there are more surfaces than clusters, the samples of the extra ones join the nearest cluster.
+ * The time is bounded by the samples, the clusters and the iterations and the memory by MAX_ECHO_CLUSTERS, nothing is allocated.
+ *
+ * EchoCluster clusters[2];
+ * uint8_t clustersCount = echoClusterer.measure(MeasurementConfiguration::builder().withSamples(8).build(), clusters, 2);
+ */
+class EchoClusterer {
+
+private:
+
+    HCSR04& hcsr04;
+
+    float gapCM;
+    uint8_t maxIterations;
+
+public:
+
+    EchoClusterer(HCSR04& hcsr04);
+
+    void setGap(const float& gapValue, const DistanceUnit& gapUnit);
+
+    void setMaxIterations(const uint8_t& maxIterations);
+
+    uint8_t measure(const MeasurementConfiguration& configuration, EchoCluster* clusters, const uint8_t& clustersCapacity);
+
+    uint8_t cluster(const HCSR04Response* hcsr04Responses, const unsigned int& responsesCount, const ResolvedMeasurementConfiguration& measurementConfiguration, EchoCluster* clusters, const uint8_t& clustersCapacity) const;
+};
+
+uint8_t findStrongestEchoCluster(const EchoCluster* clusters, const uint8_t& clustersCount);
+
+
+#endif //HC_SR04_ECHOCLUSTERER_H
@@ -0,0 +1,45 @@
+#include "EchoRecorder.h"
+
+EchoRecorder::EchoRecorder(HCSR04Backend& source, Print& output) : source(&source), output(&output) {
+    this->isHeaderWritten = false;
+    this->recordedCount = 0;
+}
+
+/**
+ * Will ping through the wrapped backend and record the echo.
+ * The header of the trace is written before the first record, so nothing is written before the output is ready.
+ */
+HCSR04Response EchoRecorder::ping(const unsigned long& responseTimeoutMS) {
+
+    unsigned long timeMS = this->source->getTimeMS();
+    HCSR04Response hcsr04Response = this->source->ping(responseTimeoutMS);
+
+    if (!this->isHeaderWritten) {
+        const uint8_t header[ECHO_TRACE_HEADER_SIZE] = {ECHO_TRACE_MAGIC, ECHO_TRACE_VERSION};
+        this->output->write(header, ECHO_TRACE_HEADER_SIZE);
+        this->isHeaderWritten = true;
+    }
+
+    uint8_t buffer[ECHO_TRACE_RECORD_SIZE];
+    encodeEchoTraceRecord(toEchoTraceRecord(hcsr04Response, timeMS), buffer);
+    this->output->write(buffer, ECHO_TRACE_RECORD_SIZE);
+    this->recordedCount++;
+
+    return hcsr04Response;
+}
+
+unsigned long EchoRecorder::getTimeMS() {
+    return this->source->getTimeMS();
+}
+
+unsigned long EchoRecorder::getTimeUS() {
+    return this->source->getTimeUS();
+}
+
+void EchoRecorder::delayMS(const unsigned long& delayMS) {
+    this->source->delayMS(delayMS);
+}
+
+unsigned long EchoRecorder::getRecordedCount() const {
+    return this->recordedCount;
+}
@@ -0,0 +1,42 @@
+#ifndef HC_SR04_ECHORECORDER_H
+#define HC_SR04_ECHORECORDER_H
+
+#include <Arduino.h>
+#include "HCSR04Backend.h"
+#include "EchoTrace.h"
+
+/**
+ * Records every raw echo that passes through it, while the measurements keep working as usual.
+ * It wraps the backend that communicates with the sensor and writes the echoes to the given output (Serial, SD file, etc.).
+ *
+ * HCSR04PinBackend pins(9);
+ * EchoRecorder recorder(pins, Serial);
+ * HCSR04 hcsr04(recorder);
+ */
+class EchoRecorder : public HCSR04Backend {
+
+private:
+
+    HCSR04Backend* source;
+    Print* output;
+
+    bool isHeaderWritten;
+    unsigned long recordedCount;
+
+public:
+
+    EchoRecorder(HCSR04Backend& source, Print& output);
+
+    HCSR04Response ping(const unsigned long& responseTimeoutMS) override;
+
+    unsigned long getTimeMS() override;
+
+    unsigned long getTimeUS() override;
+
+    void delayMS(const unsigned long& delayMS) override;
+
+    unsigned long getRecordedCount() const;
+};
+
+
+#endif //HC_SR04_ECHORECORDER_H
@@ -0,0 +1,147 @@
+#include "EchoReplay.h"
+
+EchoReplay::EchoReplay(Stream& input) : input(&input) {
+    this->isHeaderRead = false;
+    this->isInvalid = false;
+    this->hasNextRecord = false;
+    this->timeMS = 0;
+    this->replayedCount = 0;
+    this->skippedCount = 0;
+}
+
+/**
+ * Will read exactly the given amount of bytes. Doesn't use Stream::readBytes, because it waits for the stream timeout at the end of the input.
+ *
+ * @return If all of the bytes were available
+ */
+bool EchoReplay::readBytes(uint8_t* buffer, const uint8_t& length) {
+
+    for (uint8_t i = 0; i < length; i++) {
+
+        if (this->input->available() <= 0)
+            return false;
+
+        buffer[i] = static_cast<uint8_t>(this->input->read());
+    }
+
+    return true;
+}
+
+/**
+ * @return If the header is present and its version is supported
+ */
+bool EchoReplay::readHeader() {
+
+    if (this->isHeaderRead)
+        return !this->isInvalid;
+
+    uint8_t header[ECHO_TRACE_HEADER_SIZE];
+
+    this->isHeaderRead = true;
+    this->isInvalid = !this->readBytes(header, ECHO_TRACE_HEADER_SIZE) || header[0] != ECHO_TRACE_MAGIC || header[1] != ECHO_TRACE_VERSION;
+
+    return !this->isInvalid;
+}
+
+/**
+ * Will read the next record without consuming it, so its time is known before it is replayed.
+ *
+ * @return If there is a next record
+ */
+bool EchoReplay::readNextRecord() {
+
+    if (this->hasNextRecord)
+        return true;
+
+    uint8_t buffer[ECHO_TRACE_RECORD_SIZE];
+
+    if (!this->readHeader() || !this->readBytes(buffer, ECHO_TRACE_RECORD_SIZE))
+        return false;
+
+    this->nextRecord = decodeEchoTraceRecord(buffer);
+    this->hasNextRecord = true;
+
+    return true;
+}
+
+/**
+ * Will return the next recorded echo. The time jumps to the time when it was recorded.
+ * Echoes longer than the response timeout are timed out, like they would be by the sensor.
+ * If the trace is finished or invalid, then the response will be timed out.
+ */
+HCSR04Response EchoReplay::ping(const unsigned long& responseTimeoutMS) {
+
+    if (!this->readNextRecord())
+        return {0, true};
+
+    HCSR04Response hcsr04Response = toHCSR04Response(this->nextRecord);
+
+    this->timeMS = this->nextRecord.timeMS;
+    this->hasNextRecord = false;
+    this->replayedCount++;
+
+    if (!hcsr04Response.isResponseTimedOut() && hcsr04Response.getHighSignalLengthUS() > responseTimeoutMS * 1000)
+        return {0, true};
+
+    return hcsr04Response;
+}
+
+/**
+ * Will move the time to the next record when a measurement didn't ping, for example because the response cool-down was active.
+ * The time of the replay only moves with the pings and the delays, so without it the cool-down would never end.
+ * If the time is already there, then the record was made while the sensor is still cooling down and it is skipped.
+ *
+ * @return If the replay moved forward
+ */
+bool EchoReplay::advanceToNextRecord() {
+
+    if (!this->readNextRecord())
+        return false;
+
+    if (this->timeMS < this->nextRecord.timeMS) {
+        this->timeMS = this->nextRecord.timeMS;
+        return true;
+    }
+
+    this->hasNextRecord = false;
+    this->skippedCount++;
+
+    return true;
+}
+
+unsigned long EchoReplay::getTimeMS() {
+    return this->timeMS;
+}
+
+unsigned long EchoReplay::getTimeUS() {
+    return this->timeMS * 1000;
+}
+
+/**
+ * The delay is not actually waited, only the time of the replay moves forward.
+ */
+void EchoReplay::delayMS(const unsigned long& delayMS) {
+    this->timeMS += delayMS;
+}
+
+/**
+ * @return If there are no more records to be replayed
+ */
+bool EchoReplay::isFinished() {
+    return !this->hasNextRecord && (!this->readHeader() || this->input->available() < ECHO_TRACE_RECORD_SIZE);
+}
+
+bool EchoReplay::isTraceInvalid() const {
+    return this->isInvalid;
+}
+
+unsigned long EchoReplay::getReplayedCount() const {
+    return this->replayedCount;
+}
+
+/**
+ * @return How many records were skipped, because they were made during the response cool-down of the replaying HCSR04
+ */
+unsigned long EchoReplay::getSkippedCount() const {
+    return this->skippedCount;
+}
@@ -0,0 +1,69 @@
+#ifndef HC_SR04_ECHOREPLAY_H
+#define HC_SR04_ECHOREPLAY_H
+
+#include <Arduino.h>
+#include "HCSR04Backend.h"
+#include "EchoTrace.h"
+
+/**
+ * Feeds a recorded echo trace (see EchoRecorder) back to the HCSR04, as fast as the input can be read.
+ * The time follows the recording and the delays are only simulated, so replaying the same trace always gives the same measurements.
+ *
+ * EchoReplay replay(traceStream);
+ * HCSR04 hcsr04(replay);
+ *
+ * while (!replay.isFinished()) {
+ *     unsigned long replayedCount = replay.getReplayedCount();
+ *     Measurement measurement = hcsr04.measure();
+ *
+ *     if (replay.getReplayedCount() == replayedCount)
+ *         replay.advanceToNextRecord();
+ * }
+ */
+class EchoReplay : public HCSR04Backend {
+
+private:
+
+    Stream* input;
+
+    bool isHeaderRead;
+    bool isInvalid;
+
+    EchoTraceRecord nextRecord;
+    bool hasNextRecord;
+
+    unsigned long timeMS;
+    unsigned long replayedCount;
+    unsigned long skippedCount;
+
+    bool readBytes(uint8_t* buffer, const uint8_t& length);
+
+    bool readHeader();
+
+    bool readNextRecord();
+
+public:
+
+    EchoReplay(Stream& input);
+
+    HCSR04Response ping(const unsigned long& responseTimeoutMS) override;
+
+    unsigned long getTimeMS() override;
+
+    unsigned long getTimeUS() override;
+
+    void delayMS(const unsigned long& delayMS) override;
+
+    bool advanceToNextRecord();
+
+    bool isFinished();
+
+    bool isTraceInvalid() const;
+
+    unsigned long getReplayedCount() const;
+
+    unsigned long getSkippedCount() const;
+};
+
+
+#endif //HC_SR04_ECHOREPLAY_H
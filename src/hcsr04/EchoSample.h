@@ -0,0 +1,24 @@
+#ifndef HC_SR04_ECHOSAMPLE_H
+#define HC_SR04_ECHOSAMPLE_H
+
+#include <Arduino.h>
+#include "HCSR04Response.h"
+
+#define ECHO_SAMPLE_FLAG_RESPONSE_TIMED_OUT 0x01
+
+/**
+ * A completed echo, as captured in interrupt context. Packed, so a queue of them takes as little RAM as possible.
+ */
+struct __attribute__((packed)) EchoSample {
+
+    uint32_t triggerTimeUS;
+    uint16_t signalLengthUS;
+    uint8_t flags;
+
+    HCSR04Response toHCSR04Response() const {
+        return {this->signalLengthUS, (this->flags & ECHO_SAMPLE_FLAG_RESPONSE_TIMED_OUT) != 0};
+    }
+};
+
+
+#endif //HC_SR04_ECHOSAMPLE_H
@@ -0,0 +1,51 @@
+#include "EchoTrace.h"
+
+/**
+ * Will convert the response into its compact recorded form.
+ *
+ * @param hcsr04Response The response that will be recorded
+ * @param timeMS When the ping of the response was sent
+ * @return The record of the response
+ */
+EchoTraceRecord toEchoTraceRecord(const HCSR04Response& hcsr04Response, const unsigned long& timeMS) {
+
+    unsigned long signalLengthUS = hcsr04Response.getHighSignalLengthUS();
+    uint8_t flags = hcsr04Response.isResponseTimedOut() ? ECHO_TRACE_FLAG_RESPONSE_TIMED_OUT : 0;
+
+    if (signalLengthUS > 0xFFFF) {
+        signalLengthUS = 0xFFFF;
+        flags |= ECHO_TRACE_FLAG_SIGNAL_SATURATED;
+    }
+
+    return {timeMS, static_cast<uint16_t>(signalLengthUS), flags};
+}
+
+/**
+ * Will convert the record back into a response.
+ */
+HCSR04Response toHCSR04Response(const EchoTraceRecord& echoTraceRecord) {
+    return {echoTraceRecord.signalLengthUS, (echoTraceRecord.flags & ECHO_TRACE_FLAG_RESPONSE_TIMED_OUT) != 0};
+}
+
+void encodeEchoTraceRecord(const EchoTraceRecord& echoTraceRecord, uint8_t buffer[ECHO_TRACE_RECORD_SIZE]) {
+
+    buffer[0] = static_cast<uint8_t>(echoTraceRecord.timeMS);
+    buffer[1] = static_cast<uint8_t>(echoTraceRecord.timeMS >> 8);
+    buffer[2] = static_cast<uint8_t>(echoTraceRecord.timeMS >> 16);
+    buffer[3] = static_cast<uint8_t>(echoTraceRecord.timeMS >> 24);
+    buffer[4] = static_cast<uint8_t>(echoTraceRecord.signalLengthUS);
+    buffer[5] = static_cast<uint8_t>(echoTraceRecord.signalLengthUS >> 8);
+    buffer[6] = echoTraceRecord.flags;
+}
+
+EchoTraceRecord decodeEchoTraceRecord(const uint8_t buffer[ECHO_TRACE_RECORD_SIZE]) {
+
+    unsigned long timeMS = static_cast<unsigned long>(buffer[0])
+                           | static_cast<unsigned long>(buffer[1]) << 8
+                           | static_cast<unsigned long>(buffer[2]) << 16
+                           | static_cast<unsigned long>(buffer[3]) << 24;
+
+    uint16_t signalLengthUS = static_cast<uint16_t>(buffer[4] | buffer[5] << 8);
+
+    return {timeMS, signalLengthUS, buffer[6]};
+}
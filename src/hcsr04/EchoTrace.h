@@ -0,0 +1,38 @@
+#ifndef HC_SR04_ECHOTRACE_H
+#define HC_SR04_ECHOTRACE_H
+
+#include <Arduino.h>
+#include "HCSR04Response.h"
+
+/*
+ * Format of a recorded echo trace:
+ *
+ * Header: magic (1 byte), version (1 byte)
+ * Records: time of the ping in milliseconds (4 bytes), echo length in microseconds (2 bytes), flags (1 byte). All little endian.
+ *
+ * The echo length is saturated at 65535 us. Everything above TIMEOUT_SIGNAL_LENGTH_US is a signal time out anyway.
+ */
+#define ECHO_TRACE_MAGIC 0xEC
+#define ECHO_TRACE_VERSION 1
+#define ECHO_TRACE_HEADER_SIZE 2
+#define ECHO_TRACE_RECORD_SIZE 7
+
+#define ECHO_TRACE_FLAG_RESPONSE_TIMED_OUT 0x01
+#define ECHO_TRACE_FLAG_SIGNAL_SATURATED 0x02
+
+struct EchoTraceRecord {
+
+    unsigned long timeMS;
+    uint16_t signalLengthUS;
+    uint8_t flags;
+};
+
+EchoTraceRecord toEchoTraceRecord(const HCSR04Response& hcsr04Response, const unsigned long& timeMS);
+
+HCSR04Response toHCSR04Response(const EchoTraceRecord& echoTraceRecord);
+
+void encodeEchoTraceRecord(const EchoTraceRecord& echoTraceRecord, uint8_t buffer[ECHO_TRACE_RECORD_SIZE]);
+
+EchoTraceRecord decodeEchoTraceRecord(const uint8_t buffer[ECHO_TRACE_RECORD_SIZE]);
+
+#endif //HC_SR04_ECHOTRACE_H
@@ -0,0 +1,22 @@
+#include "ExtendedClock.h"
+
+ExtendedClock::ExtendedClock() {
+    this->lastTimeUS = 0;
+    this->overflowsCount = 0;
+}
+
+/**
+ * @param timeUS The current time from micros()
+ * @return The current time extended to 64 bits
+ */
+uint64_t ExtendedClock::extendTimeUS(const unsigned long& timeUS) {
+
+    uint32_t currentTimeUS = static_cast<uint32_t>(timeUS);
+
+    if (currentTimeUS < this->lastTimeUS)
+        this->overflowsCount++;
+
+    this->lastTimeUS = currentTimeUS;
+
+    return (static_cast<uint64_t>(this->overflowsCount) << 32) | currentTimeUS;
+}
@@ -0,0 +1,27 @@
+#ifndef HC_SR04_EXTENDEDCLOCK_H
+#define HC_SR04_EXTENDEDCLOCK_H
+
+#include <Arduino.h>
+
+/**
+ * micros() overflows after ~71 minutes. The extended clock counts the overflows and gives a 64 bit time that doesn't overflow,
+ * so the difference between two timestamps is always correct.
+ *
+ * It detects the overflow when the time goes back, so it has to be called at least once per ~71 minutes.
+ */
+class ExtendedClock {
+
+private:
+
+    uint32_t lastTimeUS;
+    uint32_t overflowsCount;
+
+public:
+
+    ExtendedClock();
+
+    uint64_t extendTimeUS(const unsigned long& timeUS);
+};
+
+
+#endif //HC_SR04_EXTENDEDCLOCK_H
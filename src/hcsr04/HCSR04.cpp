@@ -1,256 +1,260 @@
 #include "HCSR04.h"
 
-HCSR04::HCSR04(const uint8_t& oneWirePin) : oneWirePin(oneWirePin) {
+HCSR04::HCSR04(const uint8_t& oneWirePin) : pinBackend(oneWirePin), backend(nullptr) {
+    this->initializeDefaults();
+}
 
-    this->isOneWireMode = true;
+HCSR04::HCSR04(const uint8_t& triggerPin, const uint8_t& echoPin) : pinBackend(triggerPin, echoPin), backend(nullptr) {
     this->initializeDefaults();
 }
 
-HCSR04::HCSR04(const uint8_t& triggerPin, const uint8_t& echoPin) : triggerPin(triggerPin), echoPin(echoPin) {
+/**
+ * The echoes and the time will come from the given backend instead of the pins. For example a recording or a simulation.
+ */
+HCSR04::HCSR04(HCSR04Backend& backend) : pinBackend(0), backend(&backend) {
+    this->initializeDefaults();
+}
 
-    pinMode(this->triggerPin, OUTPUT);
-    pinMode(this->echoPin, INPUT);
+/**
+ * Will replace the source of the echoes and the time. For example with a recorder that wraps the current backend.
+ */
+void HCSR04::setBackend(HCSR04Backend& backend) {
+    this->backend = &backend;
+}
 
-    this->isOneWireMode = false;
-    this->initializeDefaults();
+/**
+ * @return The given backend or the pins if no backend was given
+ */
+HCSR04Backend& HCSR04::getBackend() {
+    return this->backend ? *this->backend : this->pinBackend;
 }
 
 /**
  * Will set the default values of the properties.
  */
 void HCSR04::initializeDefaults() {
-    this->defaultSamples = DEFAULT_SAMPLES;
-    this->defaultMaxDistanceValue = DEFAULT_MAX_DISTANCE_CENTIMETERS;
-    this->defaultMaxDistanceUnit = DistanceUnit::CENTIMETERS;
-    this->defaultTemperatureValue = DEFAULT_TEMPERATURE_CELSIUS;
-    this->defaultTemperatureUnit = TemperatureUnit::CELSIUS;
-    this->defaultResponseTimeoutMS = DEFAULT_RESPONSE_TIMEOUT_MS;
-    this->defaultMeasurementDistanceUnit = DistanceUnit::CENTIMETERS;
-    this->defaultResponseTimeoutCoolDownTimeMS = DEFAULT_RESPONSE_COOL_DOWN_MS;
+    this->defaults.samples = DEFAULT_SAMPLES;
+    this->defaults.maxDistanceValue = DEFAULT_MAX_DISTANCE_CENTIMETERS;
+    this->defaults.maxDistanceUnit = DistanceUnit::CENTIMETERS;
+    this->defaults.temperatureValue = DEFAULT_TEMPERATURE_CELSIUS;
+    this->defaults.temperatureUnit = TemperatureUnit::CELSIUS;
+    this->defaults.responseTimeoutMS = DEFAULT_RESPONSE_TIMEOUT_MS;
+    this->defaults.measurementDistanceUnit = DistanceUnit::CENTIMETERS;
+    this->defaults.responseTimeoutCoolDownTimeMS = DEFAULT_RESPONSE_COOL_DOWN_MS;
+    this->defaults.timeBudgetMS = DEFAULT_TIME_BUDGET_MS;
+    this->defaults.minimumSamples = DEFAULT_MINIMUM_SAMPLES;
     this->responseCoolDownEndMS = DEFAULT_RESPONSE_COOL_DOWN_MS;
+    this->lastPingEndMS = 0;
+    this->isPingSpacingPending = false;
+    this->isAdaptivePingRateEnabled = false;
+    this->cachedMeasurementTimeMS = 0;
+    this->hasCachedMeasurement = false;
+    this->cacheHitsCount = 0;
+    this->cacheMissesCount = 0;
+    this->defaults.calibratedSoundSpeedCentimetersPerMicrosecond = 0;
+    this->calibrationTimeMS = 0;
 }
 
 /**
- * Will calculate the signal length as actual distance in the given unit
- * The signal length represents the time the signal travelled per cm/us.
+ * The distance is proportional to the signal length, so it is calculated once per measurement instead of once per response.
  *
- * @param signalLength The length of the HIGH signal from the HC-SR04 in microseconds
- * @param soundSpeed The speed of the sound in meters per second
- * @param distanceUnit In what distance unit the distance to be returned
- * @return The distance that the sensor measured converted in the given one
+ * @param measurementConfiguration The configuration, which will determinate the sound speed and measurement distance unit
+ * @return The distance in the measurement distance unit that a signal of one microsecond represents
  */
-float HCSR04::calculateDistanceBySignalLengthAndSoundSpeed(const unsigned int& signalLength, const float& soundSpeed, const DistanceUnit& distanceUnit) {
+float HCSR04::calculateDistancePerSignalLengthUS(const ResolvedMeasurementConfiguration& measurementConfiguration) {
 
-    float soundSpeedInCentimetersPerMicrosecond = this->convertMetersPerSecondToCentimetersPerMicrosecond(soundSpeed);
-    float distanceInCM = (soundSpeedInCentimetersPerMicrosecond * static_cast<float>(signalLength)) / 2;
+    float distanceInCM = measurementConfiguration.getSoundSpeedCentimetersPerMicrosecond() / 2;
 
-    return convertDistanceUnit(distanceInCM, DistanceUnit::CENTIMETERS, distanceUnit);
+    return convertDistanceUnit(distanceInCM, DistanceUnit::CENTIMETERS, measurementConfiguration.measurementDistanceUnit);
 }
 
 /**
- * Will calculate the signal length as actual distance in the given unit
- * The signal length represents the time the signal travelled per cm/us.
+ * The sensor needs a pause between two pings, so the echoes of the previous one fade out.
  *
- * @param hcsr04Response The response, which signal length will be used for the distance's calculation
- * @param measurementConfiguration The configuration, which will determinate the temperature and measurement distance unit
- * @return The calculated distance
+ * @return How much time is left until the next ping can be sent
  */
-float HCSR04::calculateDistance(const HCSR04Response& hcsr04Response, const MeasurementConfiguration& measurementConfiguration) {
-
-    float temperatureValue = measurementConfiguration.getTemperatureValue().orElseGet(this->defaultTemperatureValue);
-    TemperatureUnit temperatureUnit = measurementConfiguration.getTemperatureUnit().orElseGet(this->defaultTemperatureUnit);
-    DistanceUnit measurementDistanceUnit = measurementConfiguration.getMeasurementDistanceUnit().orElseGet(this->defaultMeasurementDistanceUnit);;
+unsigned long HCSR04::calculateRemainingPingSpacingMS() {
 
-    float soundSpeedMetersPerSecond = this->calculateSoundSpeedByTemperature(temperatureValue, temperatureUnit);
+    if (!this->isPingSpacingPending)
+        return 0;
 
-    return this->calculateDistanceBySignalLengthAndSoundSpeed(hcsr04Response.getHighSignalLengthUS(), soundSpeedMetersPerSecond, measurementDistanceUnit);
-}
+    unsigned long sinceLastPingMS = this->getBackend().getTimeMS() - this->lastPingEndMS;
 
-/**
- * Will convert meters per second to centimeters per microsecond/
- *
- * @param metersPerSecond The meters per second that will be converted
- * @return The converted meters per second into centimeters per microsecond
- */
-float HCSR04::convertMetersPerSecondToCentimetersPerMicrosecond(const float& metersPerSecond) {
-    return metersPerSecond * 0.0001f;
+    return sinceLastPingMS >= COOL_DOWN_DELAY_MS ? 0 : COOL_DOWN_DELAY_MS - sinceLastPingMS;
 }
 
 /**
- * The speed of sound in air is dependent on the temperature & other factors such as air pressure and humidity.
- * The temperature plays more important role that the other two.
+ * A ping needs time for the echo of the max distance, but never more than the response timeout.
  *
- * https://www.engineeringtoolbox.com/air-speed-sound-d_603.html
- *
- * @param temperature The ambient temperature
- * @param temperatureUnit The unit of the temperature
- * @return The speed of sound in m/s
+ * @return The time that a ping needs in milliseconds
  */
-float HCSR04::calculateSoundSpeedByTemperature(const float& temperature, const TemperatureUnit& temperatureUnit) {
-    float temperatureInCelsius = convertTemperatureUnit(temperature, temperatureUnit, TemperatureUnit::CELSIUS);
-    return 331.0f + (0.6f * temperatureInCelsius);
-}
+unsigned long HCSR04::calculateEchoWindowMS(const ResolvedMeasurementConfiguration& measurementConfiguration) {
 
-/**
- * Will send the trigger signal to the HCSR04. It consists of holding a high signal for specific period.
- * This method works in both one wire and two wire (trigger/echo) mode
- */
-void HCSR04::sendTriggerSignalToHCSR04() {
-
-    uint8_t pin = this->isOneWireMode ? this->oneWirePin : this->triggerPin;
+    float soundSpeedInCentimetersPerMicrosecond = measurementConfiguration.getSoundSpeedCentimetersPerMicrosecond();
+    float maxDistanceInCM = convertDistanceUnit(measurementConfiguration.maxDistanceValue, measurementConfiguration.maxDistanceUnit, DistanceUnit::CENTIMETERS);
 
-    pinMode(pin, OUTPUT);
+    unsigned long maxDistanceEchoMS = static_cast<unsigned long>(maxDistanceInCM * 2 / soundSpeedInCentimetersPerMicrosecond / 1000) + 1;
 
-    digitalWrite(pin, HIGH);
-    delayMicroseconds(TRIGGER_SIGNAL_LENGTH_US);
-    digitalWrite(pin, LOW);
+    return min(maxDistanceEchoMS, static_cast<unsigned long>(measurementConfiguration.responseTimeoutMS));
 }
 
 /**
  * Will send a request for measurement to the HCSR04 and wait for its response.
+ * If the previous ping was recent, it will wait for the spacing between the pings first.
  * If the response doesn't arrive in the given timeout time, then it will be time outed
  *
  * @param responseTimeOutMS The maximum time that the response has to arrive
  * @return The results from the measurement.
  */
-HCSR04Response HCSR04::sendAndReceivedToHCSR04(const MeasurementConfiguration& measurementConfiguration) {
+HCSR04Response HCSR04::sendAndReceivedToHCSR04(const unsigned long& responseTimeOutMS) {
+
+    unsigned long remainingPingSpacingMS = this->calculateRemainingPingSpacingMS();
 
-    unsigned long responseTimeOutMS = measurementConfiguration.getResponseTimeoutMS().orElseGet(this->defaultResponseTimeoutMS);
+    if (remainingPingSpacingMS > 0)
+        this->getBackend().delayMS(remainingPingSpacingMS);
 
-    uint8_t measurementPin = this->isOneWireMode ? this->oneWirePin : this->echoPin;
+#ifdef HCSR04_TIMESTAMPS
+    uint64_t triggerTimeUS = this->extendedClock.extendTimeUS(this->getBackend().getTimeUS());
+#endif
 
-    this->sendTriggerSignalToHCSR04();
+    HCSR04Response hcsr04Response = this->getBackend().ping(responseTimeOutMS);
 
-    SignalLengthMeasurementUS signalLengthMeasurementUs = measureSignalLength(measurementPin, HIGH, responseTimeOutMS);
+#ifdef HCSR04_TIMESTAMPS
+    hcsr04Response.setTriggerTimeUS(triggerTimeUS);
+#endif
 
-    delay(COOL_DOWN_DELAY_MS);
-    return {signalLengthMeasurementUs.signalLengthUS, signalLengthMeasurementUs.isTimedOut};
+    this->lastPingEndMS = this->getBackend().getTimeMS();
+    this->isPingSpacingPending = true;
+
+    return hcsr04Response;
 }
 
 /**
  * Will send a multiple requests for measurement to the HCSR04 and wait for their responses.
  * The measurement configuration defines how they will be collected.
  *
+ * If there is a time budget, a ping is sent only if the remaining time can fit the spacing between the pings and the echo window.
+ * The response timeout of the ping is shortened to the remaining time, so the measurement never exceeds the budget.
+ *
  * @param hcsr04Responses The array, which will be filled with the responses
  * @param measurementConfiguration Defines how the measurements will be collected
+ * @return How many samples were taken
  */
-void HCSR04::sendAndReceivedToHCSR04(HCSR04Response hcsr04Responses[], const MeasurementConfiguration& measurementConfiguration) {
+unsigned int HCSR04::sendAndReceivedToHCSR04(HCSR04Response hcsr04Responses[], const ResolvedMeasurementConfiguration& measurementConfiguration) {
 
-    unsigned int samples = measurementConfiguration.getSamples().orElseGet(this->defaultSamples);
+    unsigned int samples = measurementConfiguration.samples;
+    unsigned long timeBudgetMS = measurementConfiguration.timeBudgetMS;
 
-    for (int i = 0; i < samples; i++)
-        hcsr04Responses[i] = this->sendAndReceivedToHCSR04(measurementConfiguration);
-}
+    if (timeBudgetMS == 0) {
 
-/**
- * Will check if a response is valid based on its timeouts and the distance that has been measured.
- *
- * @param measurementConfiguration Will be used to determinate if the response was valid
- * @param hcsr04Response The response that will be check if valid
- * @return If the given response was valid
- */
-bool HCSR04::isResponseValid(const MeasurementConfiguration& measurementConfiguration, const HCSR04Response& hcsr04Response) {
+        for (unsigned int i = 0; i < samples; i++)
+            hcsr04Responses[i] = this->sendAndReceivedToHCSR04(measurementConfiguration.responseTimeoutMS);
 
-    float maxDistanceValue = measurementConfiguration.getMaxDistanceValue().orElseGet(this->defaultMaxDistanceValue);
-    DistanceUnit maxDistanceUnit = measurementConfiguration.getMaxDistanceUnit().orElseGet(this->defaultMaxDistanceUnit);
-    DistanceUnit measurementDistanceUnit = measurementConfiguration.getMeasurementDistanceUnit().orElseGet(this->defaultMeasurementDistanceUnit);;
+        return samples;
+    }
 
-    float distance = this->calculateDistance(hcsr04Response, measurementConfiguration);
+    unsigned long startMS = this->getBackend().getTimeMS();
+    unsigned long echoWindowMS = this->calculateEchoWindowMS(measurementConfiguration);
+    unsigned int takenSamples = 0;
 
-    bool isMaxDistanceExceeded = convertDistanceUnit(distance, measurementDistanceUnit, maxDistanceUnit) > maxDistanceValue;
+    while (takenSamples < samples) {
 
-    return !hcsr04Response.isSignalTimedOut(TIMEOUT_SIGNAL_LENGTH_US) && !hcsr04Response.isResponseTimedOut() && !isMaxDistanceExceeded;
-}
+        unsigned long elapsedMS = this->getBackend().getTimeMS() - startMS;
+        unsigned long remainingPingSpacingMS = this->calculateRemainingPingSpacingMS();
 
-/**
- * Checks if the max distance for the given response has been exceeded.
- *
- * @param hcsr04Response The response, which distance will be checked
- * @param measurementConfiguration The configuration, which parameters will determinate if the response's distance was valid
- * @return If the distance was valid
- */
-bool HCSR04::isMaxDistanceExceeded(const HCSR04Response& hcsr04Response, const MeasurementConfiguration& measurementConfiguration) {
+        if (elapsedMS + remainingPingSpacingMS + echoWindowMS > timeBudgetMS)
+            break;
 
-    float maxDistanceValue = measurementConfiguration.getMaxDistanceValue().orElseGet(this->defaultMaxDistanceValue);
-    DistanceUnit maxDistanceUnit = measurementConfiguration.getMaxDistanceUnit().orElseGet(this->defaultMaxDistanceUnit);
-    DistanceUnit measurementDistanceUnit = measurementConfiguration.getMeasurementDistanceUnit().orElseGet(this->defaultMeasurementDistanceUnit);;
+        unsigned long responseTimeOutMS = min(static_cast<unsigned long>(measurementConfiguration.responseTimeoutMS), timeBudgetMS - elapsedMS - remainingPingSpacingMS);
 
-    float distance = this->calculateDistance(hcsr04Response, measurementConfiguration);
+        hcsr04Responses[takenSamples++] = this->sendAndReceivedToHCSR04(responseTimeOutMS);
+    }
 
-    return convertDistanceUnit(distance, measurementDistanceUnit, maxDistanceUnit) > maxDistanceValue;;
+    return takenSamples;
 }
 
 /**
- * Counts the errors of the responses that have a error.
+ * Will classify each response once and collect the errors and the statistics of the valid echo signals in a single pass.
+ * The signals aren't converted to distances, the max distance is converted to a max signal length once instead. See Measurement.
  * There is priority that determinants in which category the error will go.
  * 1. Response Timed Out
  * 2. Signal Timed Out
  * 3. Max Distance Exceeded
  *
+ * The mean and the variance are accumulated with Welford's method, which doesn't lose precision like the sum of squares.
+ *
+ * @param distancePerSignalLengthUS The distance that one microsecond of the signal represents in the measurement distance unit
  */
-HCSR04ResponseErrors HCSR04::countResponseErrors(HCSR04Response hcsr04Responses[], const unsigned int& responsesCount, const MeasurementConfiguration& measurementConfiguration) {
+HCSR04ResponsesAggregation HCSR04::aggregateResponses(const HCSR04Response* hcsr04Responses, const unsigned int& responsesCount, const ResolvedMeasurementConfiguration& measurementConfiguration, const float& distancePerSignalLengthUS) {
 
-    unsigned int signalTimedOutCount = 0;
-    unsigned int responseTimedOutCount = 0;
-    unsigned int maxDistanceExceededCount = 0;
+    float maxDistance = convertDistanceUnit(measurementConfiguration.maxDistanceValue, measurementConfiguration.maxDistanceUnit, measurementConfiguration.measurementDistanceUnit);
+    float maxSignalLengthUS = maxDistance / distancePerSignalLengthUS;
 
-    for (int i = 0; i < responsesCount; ++i) {
-        HCSR04Response hcsr04Response = hcsr04Responses[i];
+    HCSR04ResponsesAggregation aggregation = {{0, 0, 0}, 0, 0, {0, 0, 0}};
+    float squaredDeviationsSum = 0;
 
-        bool isMaxDistanceExceeded = this->isMaxDistanceExceeded(hcsr04Response, measurementConfiguration);
+    for (unsigned int i = 0; i < responsesCount; i++) {
+        const HCSR04Response& hcsr04Response = hcsr04Responses[i];
 
-        if (hcsr04Response.isResponseTimedOut())
-            responseTimedOutCount++;
-        else if (hcsr04Response.isSignalTimedOut(TIMEOUT_SIGNAL_LENGTH_US))
-            signalTimedOutCount++;
-        else if (isMaxDistanceExceeded)
-            maxDistanceExceededCount++;
-    }
+        if (hcsr04Response.isResponseTimedOut()) {
+            aggregation.errors.responseTimedOutCount++;
+            continue;
+        }
 
-    return {signalTimedOutCount, responseTimedOutCount, maxDistanceExceededCount};
-}
+        if (hcsr04Response.isSignalTimedOut(TIMEOUT_SIGNAL_LENGTH_US)) {
+            aggregation.errors.signalTimedOutCount++;
+            continue;
+        }
 
-/**
- * Calculates the average sum of the distances.
- */
-float HCSR04::calculateAverage(HCSR04Response hcsr04Responses[], const unsigned int& responsesCount, const MeasurementConfiguration& measurementConfiguration) {
+        float signalLengthUS = static_cast<float>(hcsr04Response.getHighSignalLengthUS());
 
-    float distancesSum = 0;
-    unsigned int validSamples = 0;
+        if (signalLengthUS > maxSignalLengthUS) {
+            aggregation.errors.maxDistanceExceededCount++;
+            continue;
+        }
 
-    for (int i = 0; i < responsesCount; i++) {
-        HCSR04Response hcsr04Response = hcsr04Responses[i];
+        aggregation.validSamplesCount++;
 
-        float distance = this->calculateDistance(hcsr04Response, measurementConfiguration);
+        float deviation = signalLengthUS - aggregation.averageSignalLengthUS;
+        aggregation.averageSignalLengthUS += deviation / static_cast<float>(aggregation.validSamplesCount);
+        squaredDeviationsSum += deviation * (signalLengthUS - aggregation.averageSignalLengthUS);
 
-        if (this->isResponseValid(measurementConfiguration, hcsr04Response)) {
-            distancesSum += distance;
-            validSamples++;
-        }
+        bool isFirst = aggregation.validSamplesCount == 1;
+        aggregation.statistics.minSignalLengthUS = isFirst ? signalLengthUS : min(aggregation.statistics.minSignalLengthUS, signalLengthUS);
+        aggregation.statistics.maxSignalLengthUS = isFirst ? signalLengthUS : max(aggregation.statistics.maxSignalLengthUS, signalLengthUS);
     }
 
-    return distancesSum / (validSamples == 0 ? 1 : static_cast<float>(validSamples));
-}
+    if (aggregation.validSamplesCount > 1)
+        aggregation.statistics.signalLengthStandardDeviationUS = sqrt(squaredDeviationsSum / static_cast<float>(aggregation.validSamplesCount - 1));
 
-bool HCSR04::isResponseCoolDownRequired(HCSR04Response hcsr04Responses[], const unsigned int& responsesCount, const MeasurementConfiguration& measurementConfiguration) {
+    return aggregation;
+}
 
-    if (!measurementConfiguration.getResponseTimeoutCoolDownTimeMS().has())
-        return false;
+bool HCSR04::isResponseCoolDownRequired(HCSR04Response hcsr04Responses[], const unsigned int& responsesCount, const ResolvedMeasurementConfiguration& measurementConfiguration) {
 
     unsigned int timedOutResponsesCount = 0;
 
-    for (int i = 0; i < responsesCount; i++) {
-        HCSR04Response hcsr04Response = hcsr04Responses[i];
-        timedOutResponsesCount += hcsr04Response.isResponseTimedOut() ? 1 : 0;
-    }
+    for (unsigned int i = 0; i < responsesCount; i++)
+        timedOutResponsesCount += hcsr04Responses[i].isResponseTimedOut() ? 1 : 0;
+
+    return this->isResponseCoolDownRequired(timedOutResponsesCount, responsesCount, measurementConfiguration);
+}
+
+/**
+ * @return If all of the responses timed out and the configuration has a cool down
+ */
+bool HCSR04::isResponseCoolDownRequired(const unsigned int& timedOutResponsesCount, const unsigned int& responsesCount, const ResolvedMeasurementConfiguration& measurementConfiguration) {
+
+    if (measurementConfiguration.responseTimeoutCoolDownTimeMS == 0 || responsesCount == 0)
+        return false;
 
     return timedOutResponsesCount == responsesCount;
 }
 
-void HCSR04::applyResponseCoolDown(const MeasurementConfiguration& measurementConfiguration) {
-    unsigned int responseTimeoutCoolDownTimeMS = measurementConfiguration.getResponseTimeoutCoolDownTimeMS().orElseGet(this->defaultResponseTimeoutCoolDownTimeMS);
+void HCSR04::applyResponseCoolDown(const ResolvedMeasurementConfiguration& measurementConfiguration) {
+    unsigned long responseTimeoutCoolDownTimeMS = measurementConfiguration.responseTimeoutCoolDownTimeMS;
 
-    this->responseCoolDownEndMS = millis() + responseTimeoutCoolDownTimeMS;
+    this->responseCoolDownEndMS = this->getBackend().getTimeMS() + responseTimeoutCoolDownTimeMS;
 }
 
 bool HCSR04::isResponseCoolDownActive() {
@@ -258,7 +262,7 @@ bool HCSR04::isResponseCoolDownActive() {
     if(this->responseCoolDownEndMS == 0)
         return false;
 
-    return millis() <= this->responseCoolDownEndMS;
+    return this->getBackend().getTimeMS() <= this->responseCoolDownEndMS;
 }
 
 /**
@@ -272,40 +276,339 @@ Measurement HCSR04::measure() {
 /**
  * Will do a measurement/s based on the provided configuration.
  */
-Measurement HCSR04::measure(const MeasurementConfiguration& measurementConfiguration) {
+Measurement HCSR04::measure(const MeasurementConfiguration& configuration) {
+
+    HCSR04Response hcsr04Responses[this->resolveConfiguration(configuration).samples];
+
+    return this->measure(configuration, hcsr04Responses);
+}
+
+/**
+ * Will do a measurement/s based on the provided configuration and keep the raw responses of the samples.
+ *
+ * @param configuration Defines how the measurement will be done
+ * @param hcsr04Responses Will be filled with the raw responses. Must have space for the configured samples. Not filled if the response cool down is active.
+ * If it is nullptr (for example a literal 0), the responses are not kept. For the cached measurement see measureCached
+ */
+Measurement HCSR04::measure(const MeasurementConfiguration& configuration, HCSR04Response* hcsr04Responses) {
+
+    if (hcsr04Responses == nullptr)
+        return this->measure(configuration);
+
+    ResolvedMeasurementConfiguration measurementConfiguration = this->resolveConfiguration(configuration);
 
     if (this->isResponseCoolDownActive())
-        return Measurement{0, DistanceUnit::CENTIMETERS, 0, 0, 0, 0, true};
+        return Measurement{0, 0, DistanceUnit::CENTIMETERS, 0, 0, 0, 0, true};
 
-    unsigned int samples = measurementConfiguration.getSamples().orElseGet(this->defaultSamples);
-    DistanceUnit measurementDistanceUnit = measurementConfiguration.getMeasurementDistanceUnit().orElseGet(this->defaultMeasurementDistanceUnit);;
+    DistanceUnit measurementDistanceUnit = measurementConfiguration.measurementDistanceUnit;
+    unsigned long startTimeMS = this->getBackend().getTimeMS();
 
-    HCSR04Response hcsr04Responses[samples];
+#ifdef HCSR04_TIMESTAMPS
+    uint64_t startTimeUS = this->extendedClock.extendTimeUS(this->getBackend().getTimeUS());
+#endif
+
+    unsigned int takenSamples = this->sendAndReceivedToHCSR04(hcsr04Responses, measurementConfiguration);
+    bool isTimeBudgetExhausted = takenSamples < measurementConfiguration.minimumSamples;
+    unsigned long endTimeMS = this->getBackend().getTimeMS();
 
-    this->sendAndReceivedToHCSR04(hcsr04Responses, measurementConfiguration);
+#ifdef HCSR04_TIMESTAMPS
+    uint64_t endTimeUS = this->extendedClock.extendTimeUS(this->getBackend().getTimeUS());
+#endif
 
-    if (this->isResponseCoolDownRequired(hcsr04Responses, samples, measurementConfiguration))
+    float distancePerSignalLengthUS = this->calculateDistancePerSignalLengthUS(measurementConfiguration);
+    HCSR04ResponsesAggregation aggregation = this->aggregateResponses(hcsr04Responses, takenSamples, measurementConfiguration, distancePerSignalLengthUS);
+    HCSR04ResponseErrors& hcsr04ResponseErrors = aggregation.errors;
+
+    if (this->isResponseCoolDownRequired(hcsr04ResponseErrors.responseTimedOutCount, takenSamples, measurementConfiguration))
         this->applyResponseCoolDown(measurementConfiguration);
 
-    HCSR04ResponseErrors hcsr04ResponseErrors = this->countResponseErrors(hcsr04Responses, samples, measurementConfiguration);
-    float averageDistance = this->calculateAverage(hcsr04Responses, samples, measurementConfiguration);
+#ifdef HCSR04_TIMESTAMPS
+    Measurement measurement{aggregation.averageSignalLengthUS, distancePerSignalLengthUS, measurementDistanceUnit, takenSamples, hcsr04ResponseErrors.signalTimedOutCount, hcsr04ResponseErrors.responseTimedOutCount, hcsr04ResponseErrors.maxDistanceExceededCount, false, isTimeBudgetExhausted, aggregation.statistics, startTimeUS, endTimeUS};
+#else
+    Measurement measurement{aggregation.averageSignalLengthUS, distancePerSignalLengthUS, measurementDistanceUnit, takenSamples, hcsr04ResponseErrors.signalTimedOutCount, hcsr04ResponseErrors.responseTimedOutCount, hcsr04ResponseErrors.maxDistanceExceededCount, false, isTimeBudgetExhausted, aggregation.statistics};
+#endif
+
+    if (this->isAdaptivePingRateEnabled)
+        this->addAdaptivePingRateMeasurement(measurement, startTimeMS, endTimeMS);
+
+    this->cachedMeasurement = measurement;
+    this->cachedMeasurementConfiguration = measurementConfiguration;
+    this->cachedMeasurementTimeMS = endTimeMS;
+    this->hasCachedMeasurement = true;
+
+    return measurement;
+}
+
+/**
+ * Will return the last measurement, if it is younger than the given age and was made with a compatible configuration.
+ * Otherwise a new measurement is made. Useful when multiple modules need the distance of the same sensor.
+ *
+ * @param maxAgeMS How old the last measurement can be, counted from its end
+ */
+Measurement HCSR04::measureCached(const MeasurementConfiguration& configuration, const unsigned long& maxAgeMS) {
+
+    if (this->isCachedMeasurementUsable(this->resolveConfiguration(configuration), maxAgeMS)) {
+        this->cacheHitsCount++;
+        return this->cachedMeasurement;
+    }
+
+    this->cacheMissesCount++;
+
+    return this->measure(configuration);
+}
+
+/**
+ * The last measurement is usable if it is young enough, has at least the requested samples and its configuration
+ * gives the same distance and validity of the samples.
+ */
+bool HCSR04::isCachedMeasurementUsable(const ResolvedMeasurementConfiguration& measurementConfiguration, const unsigned long& maxAgeMS) {
+
+    if (!this->hasCachedMeasurement)
+        return false;
+
+    unsigned long ageMS = this->getBackend().getTimeMS() - this->cachedMeasurementTimeMS;
+
+    return ageMS <= maxAgeMS
+           && this->cachedMeasurement.getTakenSamples() >= measurementConfiguration.samples
+           && this->cachedMeasurementConfiguration.isCompatibleWith(measurementConfiguration);
+}
+
+/**
+ * @return How many times measureCached(configuration, maxAgeMS) returned the last measurement
+ */
+unsigned long HCSR04::getCacheHitsCount() const {
+    return this->cacheHitsCount;
+}
+
+/**
+ * @return How many times measureCached(configuration, maxAgeMS) had to make a new measurement
+ */
+unsigned long HCSR04::getCacheMissesCount() const {
+    return this->cacheMissesCount;
+}
+
+/**
+ * Will make the next measureCached(configuration, maxAgeMS) make a new measurement. For example after the sensor was moved.
+ */
+void HCSR04::clearCachedMeasurement() {
+    this->hasCachedMeasurement = false;
+}
+
+/**
+ * Will measure a flat target at a known distance and find the sound speed that gives exactly this distance.
+ * The later measurements use it in place of the one calculated by the temperature, unless they are given a temperature.
+ * It also includes the constant delay of the echo of the sensor, so it is more accurate than a measured temperature
+ * and the measurements need fewer samples. Repeat it from time to time, because the temperature changes. See isCalibrationDue().
+ *
+ * @param knownDistanceValue The real distance to the target
+ * @param knownDistanceUnit The unit of the real distance
+ * @param samples How many pings to average. The calibration is done once, so they can be more than the ones of a measurement
+ * @return If there were valid responses and the found sound speed is plausible. Otherwise the previous calibration stays
+ */
+bool HCSR04::calibrate(const float& knownDistanceValue, const DistanceUnit& knownDistanceUnit, const unsigned int& samples) {
+
+    if (samples == 0)
+        return false;
+
+    ResolvedMeasurementConfiguration measurementConfiguration = this->defaults;
+    measurementConfiguration.samples = samples;
+    measurementConfiguration.timeBudgetMS = 0;
+
+    HCSR04Response hcsr04Responses[samples];
+    unsigned int takenSamples = this->sendAndReceivedToHCSR04(hcsr04Responses, measurementConfiguration);
+
+    float averageSignalLengthUS = 0;
+    unsigned int validSamplesCount = 0;
+
+    for (unsigned int i = 0; i < takenSamples; i++) {
+        const HCSR04Response& hcsr04Response = hcsr04Responses[i];
+
+        if (hcsr04Response.isResponseTimedOut() || hcsr04Response.isSignalTimedOut(TIMEOUT_SIGNAL_LENGTH_US) || hcsr04Response.getHighSignalLengthUS() == 0)
+            continue;
+
+        validSamplesCount++;
+        averageSignalLengthUS += (static_cast<float>(hcsr04Response.getHighSignalLengthUS()) - averageSignalLengthUS) / static_cast<float>(validSamplesCount);
+    }
+
+    if (validSamplesCount == 0)
+        return false;
+
+    float knownDistanceInCM = convertDistanceUnit(knownDistanceValue, knownDistanceUnit, DistanceUnit::CENTIMETERS);
+
+    return this->setCalibratedSoundSpeed(knownDistanceInCM * 2 / averageSignalLengthUS);
+}
+
+/**
+ * Will use the given sound speed in place of the one calculated by the temperature. For example one found by another sensor.
+ *
+ * @return If the sound speed is plausible and was set
+ */
+bool HCSR04::setCalibratedSoundSpeed(const float& soundSpeedCentimetersPerMicrosecond) {
+
+    if (!isCalibratedSoundSpeedPlausible(soundSpeedCentimetersPerMicrosecond))
+        return false;
+
+    this->defaults.calibratedSoundSpeedCentimetersPerMicrosecond = soundSpeedCentimetersPerMicrosecond;
+    this->calibrationTimeMS = this->getBackend().getTimeMS();
+
+    return true;
+}
+
+/**
+ * @return The calibrated sound speed in centimeters per microsecond. 0 if the sensor is not calibrated
+ */
+float HCSR04::getCalibratedSoundSpeed() const {
+    return this->defaults.calibratedSoundSpeedCentimetersPerMicrosecond;
+}
+
+bool HCSR04::isCalibrated() const {
+    return this->defaults.calibratedSoundSpeedCentimetersPerMicrosecond > 0;
+}
+
+/**
+ * @param maxAgeMS How old the calibration can be
+ * @return If the sensor is not calibrated or the calibration is older than the given age
+ */
+bool HCSR04::isCalibrationDue(const unsigned long& maxAgeMS) {
+    return !this->isCalibrated() || this->getBackend().getTimeMS() - this->calibrationTimeMS > maxAgeMS;
+}
+
+/**
+ * Will go back to the sound speed calculated by the temperature.
+ */
+void HCSR04::clearCalibration() {
+    this->defaults.calibratedSoundSpeedCentimetersPerMicrosecond = 0;
+}
+
+/**
+ * Will keep the calibration in the EEPROM, so it survives a restart.
+ *
+ * @param address Where in the EEPROM. It takes sizeof(SoundSpeedCalibrationRecord) bytes
+ * @return If the sensor is calibrated and the calibration was written
+ */
+bool HCSR04::saveCalibration(const int& address) const {
+    return this->isCalibrated() && writeSoundSpeedCalibration(address, this->defaults.calibratedSoundSpeedCentimetersPerMicrosecond);
+}
+
+/**
+ * Will use the calibration from the EEPROM. Its age is counted from now, because the EEPROM doesn't know when it was made.
+ *
+ * @return If there was a valid calibration at the address
+ */
+bool HCSR04::loadCalibration(const int& address) {
+
+    float soundSpeedCentimetersPerMicrosecond;
+
+    if (!readSoundSpeedCalibration(address, soundSpeedCentimetersPerMicrosecond))
+        return false;
+
+    return this->setCalibratedSoundSpeed(soundSpeedCentimetersPerMicrosecond);
+}
+
+/**
+ * @return The state that makes the measurements after a restart as good as before it. See HCSR04SnapshotKeeper
+ */
+HCSR04Snapshot HCSR04::takeSnapshot() {
+
+    /*
+     * Zeroed with the padding, so an unchanged state has the same bytes and the same CRC
+     */
+    HCSR04Snapshot snapshot;
+    memset(static_cast<void*>(&snapshot), 0, sizeof(snapshot));
+
+    snapshot.defaults = this->defaults;
+    snapshot.adaptivePingRate = this->adaptivePingRate;
+    snapshot.adaptivePingRate.rebaseTime(0);
+    snapshot.isAdaptivePingRateEnabled = this->isAdaptivePingRateEnabled;
+    snapshot.responseCoolDownRemainingMS = this->isResponseCoolDownActive() ? this->responseCoolDownEndMS - this->getBackend().getTimeMS() : 0;
+
+    return snapshot;
+}
+
+/**
+ * Will continue from the given state instead of starting cold. Call it in setup(), before the first measurement.
+ * The calibration is counted as made now.
+ */
+void HCSR04::restoreSnapshot(const HCSR04Snapshot& snapshot) {
 
-    return Measurement{averageDistance, measurementDistanceUnit, samples, hcsr04ResponseErrors.signalTimedOutCount, hcsr04ResponseErrors.responseTimedOutCount, hcsr04ResponseErrors.maxDistanceExceededCount, false};
+    unsigned long nowMS = this->getBackend().getTimeMS();
+
+    this->defaults = snapshot.defaults;
+    this->calibrationTimeMS = nowMS;
+
+    this->adaptivePingRate = snapshot.adaptivePingRate;
+    this->adaptivePingRate.rebaseTime(nowMS);
+    this->isAdaptivePingRateEnabled = snapshot.isAdaptivePingRateEnabled;
+
+    this->responseCoolDownEndMS = snapshot.responseCoolDownRemainingMS > 0 ? nowMS + snapshot.responseCoolDownRemainingMS : 0;
+
+    this->clearCachedMeasurement();
+}
+
+/**
+ * Will give the measurement to the adaptive ping rate in centimeters.
+ */
+void HCSR04::addAdaptivePingRateMeasurement(const Measurement& measurement, const unsigned long& startTimeMS, const unsigned long& endTimeMS) {
+
+    bool isValid = measurement.getValidMeasurementsCount() > 0;
+    float distanceCM = measurement.getDistance(DistanceUnit::CENTIMETERS);
+
+    this->adaptivePingRate.addMeasurement(isValid, distanceCM, startTimeMS, endTimeMS);
+}
+
+/**
+ * Will ping the sensor less often while the scene doesn't change. Use isMeasurementDue() to know when to measure.
+ *
+ * @param minPeriodMS The period between the measurements while the distance changes
+ * @param maxPeriodMS The period between the measurements while the distance doesn't change
+ * @param significantChangeValue A change of the distance bigger than this goes back to the min period
+ * @param significantChangeUnit The unit of the significant change
+ */
+void HCSR04::enableAdaptivePingRate(const unsigned long& minPeriodMS, const unsigned long& maxPeriodMS, const float& significantChangeValue, const DistanceUnit& significantChangeUnit) {
+    float significantChangeCM = convertDistanceUnit(significantChangeValue, significantChangeUnit, DistanceUnit::CENTIMETERS);
+
+    this->adaptivePingRate = AdaptivePingRate{minPeriodMS, maxPeriodMS, significantChangeCM};
+    this->isAdaptivePingRateEnabled = true;
+}
+
+void HCSR04::disableAdaptivePingRate() {
+    this->isAdaptivePingRateEnabled = false;
+}
+
+/**
+ * @return If the adaptive ping rate is disabled or its current period has passed since the last measurement
+ */
+bool HCSR04::isMeasurementDue() {
+    return !this->isAdaptivePingRateEnabled || this->adaptivePingRate.isMeasurementDue(this->getBackend().getTimeMS());
+}
+
+/**
+ * @return The current period, effective rate and detection latency of the adaptive ping rate
+ */
+const AdaptivePingRate& HCSR04::getAdaptivePingRate() const {
+    return this->adaptivePingRate;
+}
+
+/**
+ * Will merge the given configuration with the defaults. Every parameter that is not present in the configuration is taken from the defaults.
+ */
+ResolvedMeasurementConfiguration HCSR04::resolveConfiguration(const MeasurementConfiguration& configuration) const {
+    return configuration.resolve(this->defaults);
 }
 
 /**
  * How many times to take measurement. Then the returned distance will be the average of a valid measurements.
  */
 void HCSR04::setDefaultSamples(const unsigned int& defaultSamples) {
-    HCSR04::defaultSamples = defaultSamples;
+    this->defaults.samples = defaultSamples;
 }
 
 /**
  * The maximum distance that is allowed. If a measurement's distance exceeds it, then the measurement is invalid.
  */
 void HCSR04::setDefaultMaxDistance(const float& defaultMaxDistanceValue, const DistanceUnit& defaultMaxDistanceUnit) {
-    HCSR04::defaultMaxDistanceValue = defaultMaxDistanceValue;
-    HCSR04::defaultMaxDistanceUnit = defaultMaxDistanceUnit;
+    this->defaults.maxDistanceValue = defaultMaxDistanceValue;
+    this->defaults.maxDistanceUnit = defaultMaxDistanceUnit;
 }
 
 /**
@@ -313,8 +616,8 @@ void HCSR04::setDefaultMaxDistance(const float& defaultMaxDistanceValue, const D
   * Increases the accuracy of the measurement, because the sound speed is dependent on temperature.
  */
 void HCSR04::setDefaultTemperature(const float& defaultTemperatureValue, const TemperatureUnit& defaultTemperatureUnit) {
-    HCSR04::defaultTemperatureValue = defaultTemperatureValue;
-    HCSR04::defaultTemperatureUnit = defaultTemperatureUnit;
+    this->defaults.temperatureValue = defaultTemperatureValue;
+    this->defaults.temperatureUnit = defaultTemperatureUnit;
 }
 
 /**
@@ -323,14 +626,14 @@ void HCSR04::setDefaultTemperature(const float& defaultTemperatureValue, const T
  * Indication when there is something wrong with the communication to the device eg: not connected
  */
 void HCSR04::setDefaultResponseTimeoutMS(const unsigned long& defaultResponseTimeoutMS) {
-    HCSR04::defaultResponseTimeoutMS = defaultResponseTimeoutMS;
+    this->defaults.responseTimeoutMS = defaultResponseTimeoutMS;
 }
 
 /**
  * In what distance unit the measurement will be returned.
  */
 void HCSR04::setDefaultMeasurementDistanceUnit(const DistanceUnit& defaultMeasurementDistanceUnit) {
-    HCSR04::defaultMeasurementDistanceUnit = defaultMeasurementDistanceUnit;
+    this->defaults.measurementDistanceUnit = defaultMeasurementDistanceUnit;
 }
 
 /**
@@ -340,5 +643,20 @@ void HCSR04::setDefaultMeasurementDistanceUnit(const DistanceUnit& defaultMeasur
  * The cool down will be **activated**, when **all of the samples** that have been measured have **timed out**. If a **measurement fails again**, then it will be **activated again** and so on.
  */
 void HCSR04::setDefaultResponseTimeoutCoolDownMS(const unsigned long& defaultResponseTimeoutCoolDownTimeMS) {
-    HCSR04::defaultResponseTimeoutCoolDownTimeMS = defaultResponseTimeoutCoolDownTimeMS;
+    this->defaults.responseTimeoutCoolDownTimeMS = defaultResponseTimeoutCoolDownTimeMS;
+}
+
+/**
+ * The maximum time that the whole measurement can take. 0 for no limit.
+ * Samples are taken only while the remaining time can fit another echo and the spacing between the pings.
+ */
+void HCSR04::setDefaultTimeBudgetMS(const unsigned long& defaultTimeBudgetMS) {
+    this->defaults.timeBudgetMS = defaultTimeBudgetMS;
+}
+
+/**
+ * How many samples have to be taken at least. If the time budget doesn't allow them, the measurement will be flagged.
+ */
+void HCSR04::setDefaultMinimumSamples(const unsigned int& defaultMinimumSamples) {
+    this->defaults.minimumSamples = defaultMinimumSamples;
 }
@@ -7,8 +7,15 @@
 #include "Measurement.h"
 #include "HCSR04Response.h"
 #include "HCSR04ResponseErrors.h"
+#include "HCSR04ResponsesAggregation.h"
+#include "HCSR04Backend.h"
+#include "HCSR04PinBackend.h"
+#include "SoundSpeed.h"
+#include "ExtendedClock.h"
+#include "AdaptivePingRate.h"
+#include "SoundSpeedCalibration.h"
+#include "HCSR04Snapshot.h"
 
-#define TRIGGER_SIGNAL_LENGTH_US 10
 #define TIMEOUT_SIGNAL_LENGTH_US 38000
 #define COOL_DOWN_DELAY_MS 60
 
@@ -17,6 +24,9 @@
 #define DEFAULT_TEMPERATURE_CELSIUS 25.00f
 #define DEFAULT_MAX_DISTANCE_CENTIMETERS 400.00f
 #define DEFAULT_RESPONSE_COOL_DOWN_MS 0
+#define DEFAULT_TIME_BUDGET_MS 0
+#define DEFAULT_MINIMUM_SAMPLES 1
+#define DEFAULT_CALIBRATION_SAMPLES 10
 
 /*
  * TODO: ONE WIRE MODE
@@ -32,45 +42,49 @@ class HCSR04 {
 
 private:
 
-    uint8_t oneWirePin;
-    uint8_t triggerPin;
-    uint8_t echoPin;
+    HCSR04PinBackend pinBackend;
+    HCSR04Backend* backend;
 
-    bool isOneWireMode;
-
-    unsigned int defaultSamples;
-    float defaultMaxDistanceValue;
-    DistanceUnit defaultMaxDistanceUnit;
-    float defaultTemperatureValue;
-    TemperatureUnit defaultTemperatureUnit;
-    unsigned long defaultResponseTimeoutMS;
-    DistanceUnit defaultMeasurementDistanceUnit;
-    unsigned long defaultResponseTimeoutCoolDownTimeMS;
+    ResolvedMeasurementConfiguration defaults;
 
     unsigned long responseCoolDownEndMS;
 
+    unsigned long lastPingEndMS;
+    bool isPingSpacingPending;
+
+#ifdef HCSR04_TIMESTAMPS
+    ExtendedClock extendedClock;
+#endif
 
-    float calculateDistanceBySignalLengthAndSoundSpeed(const unsigned int& signalLength, const float& soundSpeed, const DistanceUnit& distanceUnit);
+    Measurement cachedMeasurement;
+    ResolvedMeasurementConfiguration cachedMeasurementConfiguration;
+    unsigned long cachedMeasurementTimeMS;
+    bool hasCachedMeasurement;
+    unsigned long cacheHitsCount;
+    unsigned long cacheMissesCount;
 
-    float convertMetersPerSecondToCentimetersPerMicrosecond(const float& metersPerSecond);
+    AdaptivePingRate adaptivePingRate;
+    bool isAdaptivePingRateEnabled;
 
-    float calculateSoundSpeedByTemperature(const float& temperature, const TemperatureUnit& temperatureUnit);
+    unsigned long calibrationTimeMS;
 
-    void sendTriggerSignalToHCSR04();
+    unsigned long calculateRemainingPingSpacingMS();
 
-    HCSR04Response sendAndReceivedToHCSR04(const MeasurementConfiguration& measurementConfiguration);
+    unsigned long calculateEchoWindowMS(const ResolvedMeasurementConfiguration& measurementConfiguration);
 
-    bool isMaxDistanceExceeded(const HCSR04Response& hcsr04Response, const MeasurementConfiguration& measurementConfiguration);
+    HCSR04Response sendAndReceivedToHCSR04(const unsigned long& responseTimeOutMS);
 
-    bool isResponseValid(const MeasurementConfiguration& measurementConfiguration, const HCSR04Response& hcsr04Response);
+    float calculateDistancePerSignalLengthUS(const ResolvedMeasurementConfiguration& measurementConfiguration);
 
-    HCSR04ResponseErrors HCSR04::countResponseErrors(HCSR04Response hcsr04Responses[], const unsigned int& responsesCount, const MeasurementConfiguration& measurementConfiguration);
+    HCSR04ResponsesAggregation aggregateResponses(const HCSR04Response* hcsr04Responses, const unsigned int& responsesCount, const ResolvedMeasurementConfiguration& measurementConfiguration, const float& distancePerSignalLengthUS);
 
-    float calculateDistance(const HCSR04Response& hcsr04Response, const MeasurementConfiguration& measurementConfiguration);
+    bool isResponseCoolDownRequired(const unsigned int& timedOutResponsesCount, const unsigned int& responsesCount, const ResolvedMeasurementConfiguration& measurementConfiguration);
 
-    float calculateAverage(HCSR04Response* hcsr04Responses, const unsigned int& responsesCount, const MeasurementConfiguration& measurementConfiguration);
+    unsigned int sendAndReceivedToHCSR04(HCSR04Response* hcsr04Responses, const ResolvedMeasurementConfiguration& measurementConfiguration);
 
-    void sendAndReceivedToHCSR04(HCSR04Response* hcsr04Responses, const MeasurementConfiguration& measurementConfiguration);
+    bool isCachedMeasurementUsable(const ResolvedMeasurementConfiguration& measurementConfiguration, const unsigned long& maxAgeMS);
+
+    void addAdaptivePingRateMeasurement(const Measurement& measurement, const unsigned long& startTimeMS, const unsigned long& endTimeMS);
 
     void initializeDefaults();
 public:
@@ -79,27 +93,87 @@ public:
 
     HCSR04(const uint8_t& triggerPin, const uint8_t& echoPin);
 
+    HCSR04(HCSR04Backend& backend);
+
+    void setBackend(HCSR04Backend& backend);
+
+    HCSR04Backend& getBackend();
+
     Measurement measure();
 
     Measurement measure(const MeasurementConfiguration& configuration);
 
+    Measurement measure(const MeasurementConfiguration& configuration, HCSR04Response* hcsr04Responses);
+
+    Measurement measureCached(const MeasurementConfiguration& configuration, const unsigned long& maxAgeMS);
+
+    ResolvedMeasurementConfiguration resolveConfiguration(const MeasurementConfiguration& configuration) const;
+
     void setDefaultSamples(const unsigned int& defaultSamples);
 
     void setDefaultMaxDistance(const float& defaultMaxDistanceValue, const DistanceUnit& defaultMaxDistanceUnit);
 
+    template<typename Unit>
+    void setDefaultMaxDistance(const Length<Unit>& defaultMaxDistance) {
+        this->setDefaultMaxDistance(defaultMaxDistance.getValue(), Unit::unit());
+    }
+
     void setDefaultTemperature(const float& defaultTemperatureValue, const TemperatureUnit& defaultTemperatureUnit);
 
+    template<typename Unit>
+    void setDefaultTemperature(const Temperature<Unit>& defaultTemperature) {
+        this->setDefaultTemperature(defaultTemperature.getValue(), Unit::unit());
+    }
+
     void setDefaultResponseTimeoutMS(const unsigned long& defaultResponseTimeoutMS);
 
     void setDefaultMeasurementDistanceUnit(const DistanceUnit& defaultMeasurementDistanceUnit);
 
     void setDefaultResponseTimeoutCoolDownMS(const unsigned long& defaultResponseTimeoutCoolDownTimeMS);
 
-    bool isResponseCoolDownRequired(HCSR04Response* hcsr04Responses, const unsigned int& responsesCount, const MeasurementConfiguration& measurementConfiguration);
+    void setDefaultTimeBudgetMS(const unsigned long& defaultTimeBudgetMS);
+
+    void setDefaultMinimumSamples(const unsigned int& defaultMinimumSamples);
 
-    void applyResponseCoolDown(const MeasurementConfiguration& measurementConfiguration);
+    bool isResponseCoolDownRequired(HCSR04Response* hcsr04Responses, const unsigned int& responsesCount, const ResolvedMeasurementConfiguration& measurementConfiguration);
+
+    void applyResponseCoolDown(const ResolvedMeasurementConfiguration& measurementConfiguration);
 
     bool isResponseCoolDownActive();
+
+    void enableAdaptivePingRate(const unsigned long& minPeriodMS, const unsigned long& maxPeriodMS, const float& significantChangeValue, const DistanceUnit& significantChangeUnit);
+
+    void disableAdaptivePingRate();
+
+    bool isMeasurementDue();
+
+    const AdaptivePingRate& getAdaptivePingRate() const;
+
+    unsigned long getCacheHitsCount() const;
+
+    unsigned long getCacheMissesCount() const;
+
+    void clearCachedMeasurement();
+
+    bool calibrate(const float& knownDistanceValue, const DistanceUnit& knownDistanceUnit, const unsigned int& samples = DEFAULT_CALIBRATION_SAMPLES);
+
+    bool setCalibratedSoundSpeed(const float& soundSpeedCentimetersPerMicrosecond);
+
+    float getCalibratedSoundSpeed() const;
+
+    bool isCalibrated() const;
+
+    bool isCalibrationDue(const unsigned long& maxAgeMS);
+
+    void clearCalibration();
+
+    bool saveCalibration(const int& address) const;
+
+    bool loadCalibration(const int& address);
+
+    HCSR04Snapshot takeSnapshot();
+
+    void restoreSnapshot(const HCSR04Snapshot& snapshot);
 };
 
 
@@ -0,0 +1,41 @@
+#ifndef HC_SR04_HCSR04BACKEND_H
+#define HC_SR04_HCSR04BACKEND_H
+
+#include "HCSR04Response.h"
+
+/**
+ * The source of the echoes and the time for the HCSR04.
+ *
+ * By default the HCSR04 communicates with the sensor through its pins (HCSR04PinBackend).
+ * Other backends can record the echoes or feed recorded/simulated ones back, so the same measurement code can run on the host.
+ */
+class HCSR04Backend {
+
+public:
+
+    /**
+     * Will trigger the sensor and wait for its echo.
+     *
+     * @param responseTimeoutMS The maximum time that the response has to arrive
+     * @return The echo of the sensor
+     */
+    virtual HCSR04Response ping(const unsigned long& responseTimeoutMS) = 0;
+
+    /**
+     * @return The current time in milliseconds, same as millis()
+     */
+    virtual unsigned long getTimeMS() = 0;
+
+    /**
+     * @return The current time in microseconds, same as micros()
+     */
+    virtual unsigned long getTimeUS() = 0;
+
+    /**
+     * Will wait for the given time, same as delay()
+     */
+    virtual void delayMS(const unsigned long& delayMS) = 0;
+};
+
+
+#endif //HC_SR04_HCSR04BACKEND_H
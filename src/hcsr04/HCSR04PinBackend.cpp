@@ -0,0 +1,61 @@
+#include "HCSR04PinBackend.h"
+
+HCSR04PinBackend::HCSR04PinBackend(const uint8_t& oneWirePin) : oneWirePin(oneWirePin) {
+    this->triggerPin = oneWirePin;
+    this->echoPin = oneWirePin;
+    this->isOneWireMode = true;
+}
+
+HCSR04PinBackend::HCSR04PinBackend(const uint8_t& triggerPin, const uint8_t& echoPin) : triggerPin(triggerPin), echoPin(echoPin) {
+
+    pinMode(this->triggerPin, OUTPUT);
+    pinMode(this->echoPin, INPUT);
+
+    this->oneWirePin = triggerPin;
+    this->isOneWireMode = false;
+}
+
+/**
+ * Will send the trigger signal to the HCSR04. It consists of holding a high signal for specific period.
+ * This method works in both one wire and two wire (trigger/echo) mode
+ */
+void HCSR04PinBackend::sendTriggerSignal() {
+
+    uint8_t pin = this->isOneWireMode ? this->oneWirePin : this->triggerPin;
+
+    pinMode(pin, OUTPUT);
+
+    digitalWrite(pin, HIGH);
+    delayMicroseconds(TRIGGER_SIGNAL_LENGTH_US);
+    digitalWrite(pin, LOW);
+}
+
+/**
+ * Will send a request for measurement to the HCSR04 and wait for its response.
+ * If the response doesn't arrive in the given timeout time, then it will be time outed
+ *
+ * @param responseTimeoutMS The maximum time that the response has to arrive
+ * @return The results from the measurement.
+ */
+HCSR04Response HCSR04PinBackend::ping(const unsigned long& responseTimeoutMS) {
+
+    uint8_t measurementPin = this->isOneWireMode ? this->oneWirePin : this->echoPin;
+
+    this->sendTriggerSignal();
+
+    SignalLengthMeasurementUS signalLengthMeasurementUs = measureSignalLength(measurementPin, HIGH, responseTimeoutMS);
+
+    return {signalLengthMeasurementUs.signalLengthUS, signalLengthMeasurementUs.isTimedOut};
+}
+
+unsigned long HCSR04PinBackend::getTimeMS() {
+    return millis();
+}
+
+unsigned long HCSR04PinBackend::getTimeUS() {
+    return micros();
+}
+
+void HCSR04PinBackend::delayMS(const unsigned long& delayMS) {
+    delay(delayMS);
+}
@@ -0,0 +1,41 @@
+#ifndef HC_SR04_HCSR04PINBACKEND_H
+#define HC_SR04_HCSR04PINBACKEND_H
+
+#include <Arduino.h>
+#include "HCSR04Backend.h"
+#include "Utils.h"
+
+#define TRIGGER_SIGNAL_LENGTH_US 10
+
+/**
+ * Communicates with a real HC-SR04 through its pins in one wire or two wire (trigger/echo) mode.
+ */
+class HCSR04PinBackend : public HCSR04Backend {
+
+private:
+
+    uint8_t oneWirePin;
+    uint8_t triggerPin;
+    uint8_t echoPin;
+
+    bool isOneWireMode;
+
+    void sendTriggerSignal();
+
+public:
+
+    HCSR04PinBackend(const uint8_t& oneWirePin);
+
+    HCSR04PinBackend(const uint8_t& triggerPin, const uint8_t& echoPin);
+
+    HCSR04Response ping(const unsigned long& responseTimeoutMS) override;
+
+    unsigned long getTimeMS() override;
+
+    unsigned long getTimeUS() override;
+
+    void delayMS(const unsigned long& delayMS) override;
+};
+
+
+#endif //HC_SR04_HCSR04PINBACKEND_H
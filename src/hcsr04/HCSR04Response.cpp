@@ -4,10 +4,17 @@ HCSR04Response::HCSR04Response() {
     this->mHighSignalLengthUS = 0;
     this->mIsResponseTimedOut = false;
     this->mIsSignalTimedOut = false;
+#ifdef HCSR04_TIMESTAMPS
+    this->mTriggerTimeUS = 0;
+#endif
 }
 
 HCSR04Response::HCSR04Response(unsigned long mHighSignalLengthUs, bool mIsResponseTimedOut) : mHighSignalLengthUS(
         mHighSignalLengthUs), mIsResponseTimedOut(mIsResponseTimedOut) {
+    this->mIsSignalTimedOut = false;
+#ifdef HCSR04_TIMESTAMPS
+    this->mTriggerTimeUS = 0;
+#endif
 }
 
 unsigned long HCSR04Response::getHighSignalLengthUS() const {
@@ -21,3 +28,16 @@ bool HCSR04Response::isResponseTimedOut() const {
 bool HCSR04Response::isSignalTimedOut(const unsigned long& timedOutSignalLengthUS) const {
     return this->mHighSignalLengthUS >= timedOutSignalLengthUS;
 }
+
+#ifdef HCSR04_TIMESTAMPS
+/**
+ * @return When the trigger signal was sent, on the extended (64 bit) micros() time base
+ */
+uint64_t HCSR04Response::getTriggerTimeUS() const {
+    return this->mTriggerTimeUS;
+}
+
+void HCSR04Response::setTriggerTimeUS(const uint64_t& triggerTimeUS) {
+    this->mTriggerTimeUS = triggerTimeUS;
+}
+#endif
@@ -1,6 +1,8 @@
 #ifndef HC_SR04_HCSR04RESPONSE_H
 #define HC_SR04_HCSR04RESPONSE_H
 
+#include <stdint.h>
+
 
 class HCSR04Response {
 
@@ -9,6 +11,10 @@ private:
     bool mIsResponseTimedOut;
     bool mIsSignalTimedOut;
 
+#ifdef HCSR04_TIMESTAMPS
+    uint64_t mTriggerTimeUS;
+#endif
+
 public:
 
     HCSR04Response();
@@ -20,6 +26,12 @@ public:
     bool isResponseTimedOut() const;
 
     bool isSignalTimedOut(const unsigned long& timedOutSignalLengthUS) const;
+
+#ifdef HCSR04_TIMESTAMPS
+    uint64_t getTriggerTimeUS() const;
+
+    void setTriggerTimeUS(const uint64_t& triggerTimeUS);
+#endif
 };
 
 
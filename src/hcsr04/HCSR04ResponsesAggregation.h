@@ -0,0 +1,19 @@
+#ifndef HC_SR04_HCSR04RESPONSESAGGREGATION_H
+#define HC_SR04_HCSR04RESPONSESAGGREGATION_H
+
+#include "HCSR04ResponseErrors.h"
+#include "MeasurementStatistics.h"
+
+/**
+ * Everything a measurement needs from its responses, collected in a single pass over them.
+ */
+struct HCSR04ResponsesAggregation {
+
+    HCSR04ResponseErrors errors;
+    unsigned int validSamplesCount;
+    float averageSignalLengthUS;
+    MeasurementStatistics statistics;
+};
+
+
+#endif //HC_SR04_HCSR04RESPONSESAGGREGATION_H
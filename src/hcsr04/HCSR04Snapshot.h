@@ -0,0 +1,23 @@
+#ifndef HC_SR04_HCSR04SNAPSHOT_H
+#define HC_SR04_HCSR04SNAPSHOT_H
+
+#include <stdint.h>
+#include "ResolvedMeasurementConfiguration.h"
+#include "AdaptivePingRate.h"
+
+/**
+ * The runtime state of a HCSR04, which is worth keeping over a restart: the defaults with the calibration,
+ * the learned period of the adaptive ping rate and the remaining response cool down. The times are relative, so they survive millis() starting from 0.
+ */
+struct HCSR04Snapshot {
+
+    ResolvedMeasurementConfiguration defaults;
+    AdaptivePingRate adaptivePingRate;
+    uint32_t responseCoolDownRemainingMS;
+    bool isAdaptivePingRateEnabled;
+};
+
+static_assert(__is_trivially_copyable(HCSR04Snapshot), "The snapshot must stay trivially copyable");
+
+
+#endif //HC_SR04_HCSR04SNAPSHOT_H
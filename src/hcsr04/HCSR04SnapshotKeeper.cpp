@@ -0,0 +1,149 @@
+#include "HCSR04SnapshotKeeper.h"
+
+static_assert(sizeof(HCSR04Snapshot) <= 0xFF, "The size of the snapshot must fit in its header");
+
+/**
+ * @param address Where the two slots start in the storage. They take getRequiredLength() bytes
+ * @param intervalMS How often poll() saves the snapshot
+ */
+HCSR04SnapshotKeeper::HCSR04SnapshotKeeper(HCSR04& hcsr04, SnapshotStorage& storage, const size_t& address, const unsigned long& intervalMS) : hcsr04(hcsr04), storage(storage) {
+    this->address = address;
+    this->intervalMS = intervalMS;
+    this->sequence = 0;
+    this->nextSlotIndex = 0;
+    this->savedCRC = 0;
+    this->isSaved = false;
+    this->lastSaveTimeMS = 0;
+    this->savesCount = 0;
+}
+
+/**
+ * CRC-16/CCITT-FALSE, bit by bit, so it needs no table in the memory of the AVR.
+ */
+uint16_t calculateSnapshotCRC(const uint8_t* data, const size_t& length) {
+
+    uint16_t crc = 0xFFFF;
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = crc & 0x8000 ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+    }
+
+    return crc;
+}
+
+size_t HCSR04SnapshotKeeper::getRequiredLength() {
+    return 2 * (sizeof(HCSR04SnapshotHeader) + sizeof(HCSR04Snapshot));
+}
+
+size_t HCSR04SnapshotKeeper::getSlotAddress(const uint8_t& slotIndex) const {
+    return this->address + slotIndex * (sizeof(HCSR04SnapshotHeader) + sizeof(HCSR04Snapshot));
+}
+
+/**
+ * @return If the slot has a snapshot of this version and layout, which is not corrupted
+ */
+bool HCSR04SnapshotKeeper::readSlot(const uint8_t& slotIndex, HCSR04SnapshotHeader& header, HCSR04Snapshot& snapshot) {
+
+    size_t slotAddress = this->getSlotAddress(slotIndex);
+
+    this->storage.read(slotAddress, reinterpret_cast<uint8_t*>(&header), sizeof(header));
+
+    if (header.magic != HCSR04_SNAPSHOT_MAGIC || header.version != HCSR04_SNAPSHOT_VERSION || header.size != sizeof(HCSR04Snapshot))
+        return false;
+
+    this->storage.read(slotAddress + sizeof(header), reinterpret_cast<uint8_t*>(&snapshot), sizeof(snapshot));
+
+    return header.crc == calculateSnapshotCRC(reinterpret_cast<const uint8_t*>(&snapshot), sizeof(snapshot));
+}
+
+/**
+ * Will restore the newest valid snapshot into the HCSR04. Call it in setup(), before the first measurement.
+ *
+ * @return If there was a valid snapshot. Otherwise the HCSR04 starts cold
+ */
+bool HCSR04SnapshotKeeper::restore() {
+
+    if (this->address + getRequiredLength() > this->storage.getLength())
+        return false;
+
+    HCSR04SnapshotHeader headers[2];
+    HCSR04Snapshot snapshots[2];
+    bool isValid[2];
+
+    for (uint8_t i = 0; i < 2; i++)
+        isValid[i] = this->readSlot(i, headers[i], snapshots[i]);
+
+    if (!isValid[0] && !isValid[1])
+        return false;
+
+    uint8_t newestSlotIndex = isValid[0] ? 0 : 1;
+
+    if (isValid[0] && isValid[1] && static_cast<int16_t>(headers[1].sequence - headers[0].sequence) > 0)
+        newestSlotIndex = 1;
+
+    this->hcsr04.restoreSnapshot(snapshots[newestSlotIndex]);
+
+    this->sequence = headers[newestSlotIndex].sequence;
+    this->nextSlotIndex = newestSlotIndex ^ 1;
+    this->savedCRC = headers[newestSlotIndex].crc;
+    this->isSaved = true;
+
+    return true;
+}
+
+/**
+ * Will save the snapshot of the HCSR04 now, into the older slot. The snapshot is written before its header,
+ * so a slot that was cut by a power loss has a wrong CRC.
+ *
+ * @return If the snapshot was written. It isn't, when it didn't change since the last save
+ */
+bool HCSR04SnapshotKeeper::save() {
+
+    if (this->address + getRequiredLength() > this->storage.getLength())
+        return false;
+
+    HCSR04Snapshot snapshot = this->hcsr04.takeSnapshot();
+    uint16_t crc = calculateSnapshotCRC(reinterpret_cast<const uint8_t*>(&snapshot), sizeof(snapshot));
+
+    this->lastSaveTimeMS = this->hcsr04.getBackend().getTimeMS();
+
+    if (this->isSaved && crc == this->savedCRC)
+        return false;
+
+    HCSR04SnapshotHeader header = {HCSR04_SNAPSHOT_MAGIC, HCSR04_SNAPSHOT_VERSION, sizeof(HCSR04Snapshot), 0, static_cast<uint16_t>(this->sequence + 1), crc};
+    size_t slotAddress = this->getSlotAddress(this->nextSlotIndex);
+
+    this->storage.write(slotAddress + sizeof(header), reinterpret_cast<const uint8_t*>(&snapshot), sizeof(snapshot));
+    this->storage.write(slotAddress, reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+
+    this->sequence = header.sequence;
+    this->nextSlotIndex ^= 1;
+    this->savedCRC = crc;
+    this->isSaved = true;
+    this->savesCount++;
+
+    return true;
+}
+
+/**
+ * Will save the snapshot once per interval. The first one is saved an interval after the start, when the sensor has settled.
+ *
+ * @return If the snapshot was written
+ */
+bool HCSR04SnapshotKeeper::poll() {
+
+    if (this->hcsr04.getBackend().getTimeMS() - this->lastSaveTimeMS < this->intervalMS)
+        return false;
+
+    return this->save();
+}
+
+/**
+ * @return How many times the snapshot was written
+ */
+unsigned long HCSR04SnapshotKeeper::getSavesCount() const {
+    return this->savesCount;
+}
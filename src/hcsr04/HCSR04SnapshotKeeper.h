@@ -0,0 +1,78 @@
+#ifndef HC_SR04_HCSR04SNAPSHOTKEEPER_H
+#define HC_SR04_HCSR04SNAPSHOTKEEPER_H
+
+#include <Arduino.h>
+#include "HCSR04.h"
+#include "HCSR04Snapshot.h"
+#include "SnapshotStorage.h"
+
+#define HCSR04_SNAPSHOT_MAGIC 0x5C
+#define HCSR04_SNAPSHOT_VERSION 1
+#define DEFAULT_SNAPSHOT_INTERVAL_MS 3600000UL
+
+/**
+ * The header of a stored snapshot. The size tells if the layout of the snapshot changed (for example with HCSR04_TIMESTAMPS).
+ */
+struct HCSR04SnapshotHeader {
+
+    uint8_t magic;
+    uint8_t version;
+    uint8_t size;
+    uint8_t reserved;
+    uint16_t sequence;
+    uint16_t crc;
+};
+
+/**
+ * Keeps the snapshot of a HCSR04 in a storage, so the sensor starts warm after a restart.
+ *
+ * There are two slots, which are written in turns. A write that is cut by a power loss breaks only its own slot,
+ * the other one still has the previous snapshot. The newest valid slot is restored.
+ * A snapshot is saved at most once per interval and only if it changed, and only its changed bytes are written.
+ * The EEPROM of the AVR lasts ~100000 writes per byte, which is more than 20 years of saving every hour in two slots.
+ *
+ * HCSR04SnapshotKeeper snapshotKeeper(hcsr04, eepromSnapshotStorage, 0);
+ *
+ * setup(): snapshotKeeper.restore();
+ * loop(): snapshotKeeper.poll();
+ */
+class HCSR04SnapshotKeeper {
+
+private:
+
+    HCSR04& hcsr04;
+    SnapshotStorage& storage;
+
+    size_t address;
+    unsigned long intervalMS;
+
+    uint16_t sequence;
+    uint8_t nextSlotIndex;
+    uint16_t savedCRC;
+    bool isSaved;
+    unsigned long lastSaveTimeMS;
+    unsigned long savesCount;
+
+    size_t getSlotAddress(const uint8_t& slotIndex) const;
+
+    bool readSlot(const uint8_t& slotIndex, HCSR04SnapshotHeader& header, HCSR04Snapshot& snapshot);
+
+public:
+
+    HCSR04SnapshotKeeper(HCSR04& hcsr04, SnapshotStorage& storage, const size_t& address, const unsigned long& intervalMS = DEFAULT_SNAPSHOT_INTERVAL_MS);
+
+    bool restore();
+
+    bool save();
+
+    bool poll();
+
+    static size_t getRequiredLength();
+
+    unsigned long getSavesCount() const;
+};
+
+uint16_t calculateSnapshotCRC(const uint8_t* data, const size_t& length);
+
+
+#endif //HC_SR04_HCSR04SNAPSHOTKEEPER_H
@@ -0,0 +1,87 @@
+#ifndef HC_SR04_LENGTH_H
+#define HC_SR04_LENGTH_H
+
+#include "DistanceUnits.h"
+
+/*
+ * The distance units as types. Each of them knows its DistanceUnit and how many centimeters it is,
+ * so the conversions between units known at compile time are calculated by the compiler.
+ */
+
+struct Centimeters {
+    static constexpr DistanceUnit unit() { return DistanceUnit::CENTIMETERS; }
+    static constexpr float centimeters() { return 1.00f; }
+};
+
+struct Meters {
+    static constexpr DistanceUnit unit() { return DistanceUnit::METERS; }
+    static constexpr float centimeters() { return 100.00f; }
+};
+
+struct Inches {
+    static constexpr DistanceUnit unit() { return DistanceUnit::INCH; }
+    static constexpr float centimeters() { return 2.54f; }
+};
+
+struct Feet {
+    static constexpr DistanceUnit unit() { return DistanceUnit::FOOT; }
+    static constexpr float centimeters() { return 30.48f; }
+};
+
+struct Yards {
+    static constexpr DistanceUnit unit() { return DistanceUnit::YARD; }
+    static constexpr float centimeters() { return 91.44f; }
+};
+
+/**
+ * The factor between two different distance units, a constant.
+ */
+template<typename FromUnit, typename ToUnit>
+struct LengthConversion {
+    static constexpr float convert(const float value) { return value * (FromUnit::centimeters() / ToUnit::centimeters()); }
+};
+
+/**
+ * A conversion to the same unit is nothing.
+ */
+template<typename Unit>
+struct LengthConversion<Unit, Unit> {
+    static constexpr float convert(const float value) { return value; }
+};
+
+/**
+ * A distance, which unit is part of its type. For example Length<Centimeters>{20}
+ * It can be converted to any other unit with to<Unit>() or implicitly when a Length of another unit is expected.
+ */
+template<typename Unit>
+class Length {
+
+private:
+
+    float value;
+
+public:
+
+    constexpr explicit Length(const float value) : value(value) {
+    }
+
+    template<typename FromUnit>
+    constexpr Length(const Length<FromUnit>& other) : value(LengthConversion<FromUnit, Unit>::convert(other.getValue())) {
+    }
+
+    constexpr float getValue() const {
+        return this->value;
+    }
+
+    static constexpr DistanceUnit getUnit() {
+        return Unit::unit();
+    }
+
+    template<typename ToUnit>
+    constexpr Length<ToUnit> to() const {
+        return Length<ToUnit>(LengthConversion<Unit, ToUnit>::convert(this->value));
+    }
+};
+
+
+#endif //HC_SR04_LENGTH_H
@@ -1,40 +1,136 @@
 #include "Measurement.h"
 
 Measurement::Measurement() {
-    this->distance = 0.00f;
+    this->signalLengthUS = 0.00f;
+    this->distancePerSignalLengthUS = 0.00f;
     this->distanceUnit = DistanceUnit::CENTIMETERS;
+    this->takenSamples = 0;
     this->signalTimedOutCount = 0;
     this->responseTimedOutCount = 0;
     this->maxDistanceExceededCount = 0;
     this->isResponseCoolDownActive = false;
+    this->isTimeBudgetExhausted = false;
+    this->statistics = MeasurementStatistics{0, 0, 0};
+#ifdef HCSR04_TIMESTAMPS
+    this->startTimeUS = 0;
+    this->endTimeUS = 0;
+#endif
 }
 
-Measurement::Measurement(float distance,
+Measurement::Measurement(float signalLengthUS,
+                         float distancePerSignalLengthUS,
                          DistanceUnit distanceUnit,
                          unsigned int takenSamples,
                          unsigned int signalTimedOutCount,
                          unsigned int responseTimedOutCount,
                          unsigned int maxDistanceExceededCount,
-                         bool isResponseCoolDownActive)
+                         bool isResponseCoolDownActive,
+                         bool isTimeBudgetExhausted,
+                         MeasurementStatistics statistics)
                          :
-                         distance(distance),
+                         signalLengthUS(signalLengthUS),
+                         distancePerSignalLengthUS(distancePerSignalLengthUS),
                          distanceUnit(distanceUnit),
                          takenSamples(takenSamples),
                          signalTimedOutCount(signalTimedOutCount),
                          responseTimedOutCount(responseTimedOutCount),
                          maxDistanceExceededCount(maxDistanceExceededCount),
-                         isResponseCoolDownActive(isResponseCoolDownActive){
+                         isResponseCoolDownActive(isResponseCoolDownActive),
+                         isTimeBudgetExhausted(isTimeBudgetExhausted),
+                         statistics(statistics){
+#ifdef HCSR04_TIMESTAMPS
+    this->startTimeUS = 0;
+    this->endTimeUS = 0;
+#endif
 }
 
+#ifdef HCSR04_TIMESTAMPS
+Measurement::Measurement(float signalLengthUS,
+                         float distancePerSignalLengthUS,
+                         DistanceUnit distanceUnit,
+                         unsigned int takenSamples,
+                         unsigned int signalTimedOutCount,
+                         unsigned int responseTimedOutCount,
+                         unsigned int maxDistanceExceededCount,
+                         bool isResponseCoolDownActive,
+                         bool isTimeBudgetExhausted,
+                         MeasurementStatistics statistics,
+                         uint64_t startTimeUS,
+                         uint64_t endTimeUS)
+                         :
+                         signalLengthUS(signalLengthUS),
+                         distancePerSignalLengthUS(distancePerSignalLengthUS),
+                         distanceUnit(distanceUnit),
+                         takenSamples(takenSamples),
+                         signalTimedOutCount(signalTimedOutCount),
+                         responseTimedOutCount(responseTimedOutCount),
+                         maxDistanceExceededCount(maxDistanceExceededCount),
+                         isResponseCoolDownActive(isResponseCoolDownActive),
+                         isTimeBudgetExhausted(isTimeBudgetExhausted),
+                         statistics(statistics),
+                         startTimeUS(startTimeUS),
+                         endTimeUS(endTimeUS){
+}
+#endif
+
 
+/**
+ * @return The distance in the distance unit of the measurement. 0 If there were no valid samples
+ */
 float Measurement::getDistance() const {
-    return this->distance;
+    return this->signalLengthUS * this->distancePerSignalLengthUS;
+}
+
+/**
+ * The same measurement can serve consumers, which want different units, without converting the distance through the unit of the measurement.
+ *
+ * @return The distance in the given unit. -1 If the unit is not yet implemented
+ */
+float Measurement::getDistance(const DistanceUnit& distanceUnit) const {
+    return this->convertSignalLengthUS(this->signalLengthUS, distanceUnit);
+}
+
+/**
+ * @return The distance of the signal length in the given unit. -1 If the unit is not yet implemented
+ */
+float Measurement::convertSignalLengthUS(const float& signalLengthUS, const DistanceUnit& distanceUnit) const {
+
+    float distancePerSignalLengthUS = this->calculateDistancePerSignalLengthUS(distanceUnit);
+
+    return distancePerSignalLengthUS < 0 ? -1 : signalLengthUS * distancePerSignalLengthUS;
+}
+
+/**
+ * @return The distance that one microsecond of the echo signal represents in the given unit. -1 If the unit is not yet implemented
+ */
+float Measurement::calculateDistancePerSignalLengthUS(const DistanceUnit& distanceUnit) const {
+
+    if (distanceUnit == this->distanceUnit)
+        return this->distancePerSignalLengthUS;
+
+    float conversionFactor = getDistanceUnitConversionFactor(this->distanceUnit, distanceUnit);
+
+    return conversionFactor < 0 ? -1 : this->distancePerSignalLengthUS * conversionFactor;
 }
 
 DistanceUnit Measurement::getDistanceUnit() const {
     return this->distanceUnit;
 }
 
+/**
+ * @return The average length of the echo signals of the valid samples
+ */
+float Measurement::getSignalLengthUS() const {
+    return this->signalLengthUS;
+}
+
+/**
+ * @return The distance that one microsecond of the echo signal represents in the distance unit of the measurement. It is resolved from the sound speed
+ */
+float Measurement::getDistancePerSignalLengthUS() const {
+    return this->distancePerSignalLengthUS;
+}
+
 unsigned int Measurement::getTakenSamples() const {
     return this->takenSamples;
 }
@@ -51,14 +147,100 @@ unsigned int Measurement::getMaxDistanceExceededCount() const {
     return this->maxDistanceExceededCount;
 }
 
-unsigned long Measurement::getInvalidMeasurementsCount() {
+unsigned long Measurement::getInvalidMeasurementsCount() const {
     return this->getSignalTimedOutCount() + this->getResponseTimedOutCount() + this->getMaxDistanceExceededCount();
 }
 
-unsigned long Measurement::getValidMeasurementsCount() {
+unsigned long Measurement::getValidMeasurementsCount() const {
     return this->takenSamples - this->getInvalidMeasurementsCount();
 }
 
 bool Measurement::getIsResponseCoolDownActive() const {
     return this->isResponseCoolDownActive;
 }
+
+/**
+ * @return If the time budget of the measurement didn't allow the minimum samples to be taken
+ */
+bool Measurement::getIsTimeBudgetExhausted() const {
+    return this->isTimeBudgetExhausted;
+}
+
+/**
+ * @return The standard deviation of the distances of the valid samples. 0 If there are less than two of them
+ */
+float Measurement::getStandardDeviation() const {
+    return this->statistics.signalLengthStandardDeviationUS * this->distancePerSignalLengthUS;
+}
+
+/**
+ * @return The standard deviation in the given unit. -1 If the unit is not yet implemented
+ */
+float Measurement::getStandardDeviation(const DistanceUnit& distanceUnit) const {
+    return this->convertSignalLengthUS(this->statistics.signalLengthStandardDeviationUS, distanceUnit);
+}
+
+/**
+ * @return The shortest distance of the valid samples
+ */
+float Measurement::getMinDistance() const {
+    return this->statistics.minSignalLengthUS * this->distancePerSignalLengthUS;
+}
+
+/**
+ * @return The shortest distance in the given unit. -1 If the unit is not yet implemented
+ */
+float Measurement::getMinDistance(const DistanceUnit& distanceUnit) const {
+    return this->convertSignalLengthUS(this->statistics.minSignalLengthUS, distanceUnit);
+}
+
+/**
+ * @return The longest distance of the valid samples
+ */
+float Measurement::getMaxDistance() const {
+    return this->statistics.maxSignalLengthUS * this->distancePerSignalLengthUS;
+}
+
+/**
+ * @return The longest distance in the given unit. -1 If the unit is not yet implemented
+ */
+float Measurement::getMaxDistance(const DistanceUnit& distanceUnit) const {
+    return this->convertSignalLengthUS(this->statistics.maxSignalLengthUS, distanceUnit);
+}
+
+/**
+ * @return The difference between the longest and the shortest distance of the valid samples
+ */
+float Measurement::getSpread() const {
+    return (this->statistics.maxSignalLengthUS - this->statistics.minSignalLengthUS) * this->distancePerSignalLengthUS;
+}
+
+/**
+ * @return The spread in the given unit. -1 If the unit is not yet implemented
+ */
+float Measurement::getSpread(const DistanceUnit& distanceUnit) const {
+    return this->convertSignalLengthUS(this->statistics.maxSignalLengthUS - this->statistics.minSignalLengthUS, distanceUnit);
+}
+
+#ifdef HCSR04_TIMESTAMPS
+/**
+ * @return When the measurement started, on the extended (64 bit) micros() time base
+ */
+uint64_t Measurement::getStartTimeUS() const {
+    return this->startTimeUS;
+}
+
+/**
+ * @return When the measurement ended, on the extended (64 bit) micros() time base
+ */
+uint64_t Measurement::getEndTimeUS() const {
+    return this->endTimeUS;
+}
+
+/**
+ * @return How long the measurement took
+ */
+unsigned long Measurement::getElapsedTimeUS() const {
+    return static_cast<unsigned long>(this->endTimeUS - this->startTimeUS);
+}
+#endif
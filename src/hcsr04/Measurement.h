@@ -1,12 +1,21 @@
 #ifndef HC_SR04_MEASUREMENT_H
 #define HC_SR04_MEASUREMENT_H
 
+#include <stdint.h>
 #include "hcsr04/DistanceUnits.h"
-
+#include "hcsr04/MeasurementStatistics.h"
+#include "hcsr04/Length.h"
+
+/**
+ * Keeps the aggregated length of the echo signals and the distance that one microsecond of them represents.
+ * The distances are calculated only when they are requested, with a single multiplication in the unit of the measurement
+ * and one more by a factor from a table in any other unit.
+ */
 class Measurement {
 
 private:
-    float distance;
+    float signalLengthUS;
+    float distancePerSignalLengthUS;
     DistanceUnit distanceUnit;
 
     unsigned int takenSamples;
@@ -16,17 +25,47 @@ private:
     unsigned int maxDistanceExceededCount;
 
     bool isResponseCoolDownActive;
+    bool isTimeBudgetExhausted;
+
+    MeasurementStatistics statistics;
+
+#ifdef HCSR04_TIMESTAMPS
+    uint64_t startTimeUS;
+    uint64_t endTimeUS;
+#endif
+
+    float calculateDistancePerSignalLengthUS(const DistanceUnit& distanceUnit) const;
+
+    float convertSignalLengthUS(const float& signalLengthUS, const DistanceUnit& distanceUnit) const;
 
 public:
 
     Measurement();
 
-    Measurement(float distance, DistanceUnit distanceUnit, unsigned int takenSamples, unsigned int signalTimedOutCount, unsigned int responseTimedOutCount, unsigned int maxDistanceExceededCount, bool isResponseCoolDownActive);
+    Measurement(float signalLengthUS, float distancePerSignalLengthUS, DistanceUnit distanceUnit, unsigned int takenSamples, unsigned int signalTimedOutCount, unsigned int responseTimedOutCount, unsigned int maxDistanceExceededCount, bool isResponseCoolDownActive, bool isTimeBudgetExhausted = false, MeasurementStatistics statistics = MeasurementStatistics{0, 0, 0});
+
+#ifdef HCSR04_TIMESTAMPS
+    Measurement(float signalLengthUS, float distancePerSignalLengthUS, DistanceUnit distanceUnit, unsigned int takenSamples, unsigned int signalTimedOutCount, unsigned int responseTimedOutCount, unsigned int maxDistanceExceededCount, bool isResponseCoolDownActive, bool isTimeBudgetExhausted, MeasurementStatistics statistics, uint64_t startTimeUS, uint64_t endTimeUS);
+#endif
 
     float getDistance() const;
 
+    float getDistance(const DistanceUnit& distanceUnit) const;
+
     DistanceUnit getDistanceUnit() const;
 
+    /**
+     * @return The distance in the given unit. For example measurement.getDistanceAs<Centimeters>()
+     */
+    template<typename Unit>
+    Length<Unit> getDistanceAs() const {
+        return Length<Unit>(this->getDistance(Unit::unit()));
+    }
+
+    float getSignalLengthUS() const;
+
+    float getDistancePerSignalLengthUS() const;
+
     unsigned int getTakenSamples() const;
 
     unsigned int getSignalTimedOutCount() const;
@@ -35,11 +74,37 @@ public:
 
     unsigned int getMaxDistanceExceededCount() const;
 
-    unsigned long getInvalidMeasurementsCount();
+    unsigned long getInvalidMeasurementsCount() const;
 
-    unsigned long getValidMeasurementsCount();
+    unsigned long getValidMeasurementsCount() const;
 
     bool getIsResponseCoolDownActive() const;
+
+    bool getIsTimeBudgetExhausted() const;
+
+    float getStandardDeviation() const;
+
+    float getStandardDeviation(const DistanceUnit& distanceUnit) const;
+
+    float getMinDistance() const;
+
+    float getMinDistance(const DistanceUnit& distanceUnit) const;
+
+    float getMaxDistance() const;
+
+    float getMaxDistance(const DistanceUnit& distanceUnit) const;
+
+    float getSpread() const;
+
+    float getSpread(const DistanceUnit& distanceUnit) const;
+
+#ifdef HCSR04_TIMESTAMPS
+    uint64_t getStartTimeUS() const;
+
+    uint64_t getEndTimeUS() const;
+
+    unsigned long getElapsedTimeUS() const;
+#endif
 };
 
 
@@ -4,109 +4,164 @@
 #include "Arduino.h"
 #include "TemperatureUnits.h"
 #include "hcsr04/DistanceUnits.h"
+#include "Length.h"
+#include "Temperature.h"
 #include "Optional.h"
+#include "ResolvedMeasurementConfiguration.h"
 
+/**
+ * The parameters of a measurement. Every parameter that is not present will be taken from the defaults of the HCSR04.
+ *
+ * The values are stored in the configuration itself and a bitmask marks which of them are present.
+ * It is trivially copyable, so it can be kept in PROGMEM/EEPROM and different measurement profiles can be swapped with a simple copy.
+ */
 class MeasurementConfiguration {
 
 private:
 
-    unsigned int* samples;
-    float* maxDistanceValue;
-    DistanceUnit* maxDistanceUnit;
-    float* temperatureValue;
-    TemperatureUnit* temperatureUnit;
-    unsigned long* responseTimeoutMS;
-    DistanceUnit* measurementDistanceUnit;
+    enum Parameter : uint8_t {
+        SAMPLES = 1 << 0,
+        MAX_DISTANCE = 1 << 1,
+        TEMPERATURE = 1 << 2,
+        RESPONSE_TIMEOUT = 1 << 3,
+        MEASUREMENT_DISTANCE_UNIT = 1 << 4,
+        RESPONSE_TIMEOUT_COOL_DOWN = 1 << 5,
+        TIME_BUDGET = 1 << 6,
+        MINIMUM_SAMPLES = 1 << 7
+    };
 
-    unsigned long* responseTimeoutCoolDownTimeMS;
+    uint8_t presentParameters;
+
+    DistanceUnit maxDistanceUnit;
+    TemperatureUnit temperatureUnit;
+    DistanceUnit measurementDistanceUnit;
+    uint16_t samples;
+    uint16_t minimumSamples;
+    float maxDistanceValue;
+    float temperatureValue;
+    uint32_t responseTimeoutMS;
+    uint32_t responseTimeoutCoolDownTimeMS;
+    uint32_t timeBudgetMS;
+
+    bool has(const Parameter& parameter) const {
+        return (this->presentParameters & parameter) != 0;
+    }
 
 public:
     class builder;
 
-    MeasurementConfiguration(unsigned int* samples,
-                             float* maxDistanceValue,
-                             DistanceUnit* maxDistanceUnit,
-                             float* temperatureValue,
-                             TemperatureUnit* temperatureUnit,
-                             unsigned long* responseTimeoutMS,
-                             DistanceUnit* measurementDistanceUnit,
-                             unsigned long* responseTimeoutCoolDownTimeMS
-                             )
-                             :
-                             samples(samples),
-                             maxDistanceValue(maxDistanceValue),
-                             maxDistanceUnit(maxDistanceUnit),
-                             temperatureValue(temperatureValue),
-                             temperatureUnit(temperatureUnit),
-                             responseTimeoutMS(responseTimeoutMS),
-                             measurementDistanceUnit(measurementDistanceUnit),
-                             responseTimeoutCoolDownTimeMS(responseTimeoutCoolDownTimeMS)
+    MeasurementConfiguration() :
+                             presentParameters(0),
+                             maxDistanceUnit(DistanceUnit::CENTIMETERS),
+                             temperatureUnit(TemperatureUnit::CELSIUS),
+                             measurementDistanceUnit(DistanceUnit::CENTIMETERS),
+                             samples(0),
+                             minimumSamples(0),
+                             maxDistanceValue(0),
+                             temperatureValue(0),
+                             responseTimeoutMS(0),
+                             responseTimeoutCoolDownTimeMS(0),
+                             timeBudgetMS(0)
                              {
     }
 
     Optional<unsigned int> getSamples() const {
-        return {this->samples};
+        return {this->samples, this->has(SAMPLES)};
     }
 
     Optional<float> getMaxDistanceValue() const {
-        return {this->maxDistanceValue};
+        return {this->maxDistanceValue, this->has(MAX_DISTANCE)};
     }
 
     Optional<DistanceUnit> getMaxDistanceUnit() const {
-        return {this->maxDistanceUnit};
+        return {this->maxDistanceUnit, this->has(MAX_DISTANCE)};
     }
 
     Optional<float> getTemperatureValue() const {
-        return {this->temperatureValue};
+        return {this->temperatureValue, this->has(TEMPERATURE)};
     }
 
     Optional<TemperatureUnit> getTemperatureUnit() const {
-        return {this->temperatureUnit};
+        return {this->temperatureUnit, this->has(TEMPERATURE)};
     }
 
     Optional<unsigned long> getResponseTimeoutMS() const {
-        return {this->responseTimeoutMS};
+        return {this->responseTimeoutMS, this->has(RESPONSE_TIMEOUT)};
     }
 
     Optional<DistanceUnit> getMeasurementDistanceUnit() const {
-        return {this->measurementDistanceUnit};
+        return {this->measurementDistanceUnit, this->has(MEASUREMENT_DISTANCE_UNIT)};
     }
 
     Optional<unsigned long> getResponseTimeoutCoolDownTimeMS() const {
-        return {this->responseTimeoutCoolDownTimeMS};
+        return {this->responseTimeoutCoolDownTimeMS, this->has(RESPONSE_TIMEOUT_COOL_DOWN)};
+    }
+
+    Optional<unsigned long> getTimeBudgetMS() const {
+        return {this->timeBudgetMS, this->has(TIME_BUDGET)};
+    }
+
+    Optional<unsigned int> getMinimumSamples() const {
+        return {this->minimumSamples, this->has(MINIMUM_SAMPLES)};
+    }
+
+    /**
+     * Will merge the configuration with the given defaults in one step. Every parameter that is not present is taken from the defaults.
+     */
+    ResolvedMeasurementConfiguration resolve(const ResolvedMeasurementConfiguration& defaults) const {
+
+        ResolvedMeasurementConfiguration resolved = defaults;
+
+        if (this->has(SAMPLES))
+            resolved.samples = this->samples;
+
+        if (this->has(MAX_DISTANCE)) {
+            resolved.maxDistanceValue = this->maxDistanceValue;
+            resolved.maxDistanceUnit = this->maxDistanceUnit;
+        }
+
+        if (this->has(TEMPERATURE)) {
+            resolved.temperatureValue = this->temperatureValue;
+            resolved.temperatureUnit = this->temperatureUnit;
+            resolved.calibratedSoundSpeedCentimetersPerMicrosecond = 0;
+        }
+
+        if (this->has(RESPONSE_TIMEOUT))
+            resolved.responseTimeoutMS = this->responseTimeoutMS;
+
+        if (this->has(MEASUREMENT_DISTANCE_UNIT))
+            resolved.measurementDistanceUnit = this->measurementDistanceUnit;
+
+        if (this->has(RESPONSE_TIMEOUT_COOL_DOWN))
+            resolved.responseTimeoutCoolDownTimeMS = this->responseTimeoutCoolDownTimeMS;
+
+        if (this->has(TIME_BUDGET))
+            resolved.timeBudgetMS = this->timeBudgetMS;
+
+        if (this->has(MINIMUM_SAMPLES))
+            resolved.minimumSamples = this->minimumSamples;
+
+        return resolved;
     }
 };
 
+static_assert(__is_trivially_copyable(MeasurementConfiguration), "The measurement configuration must stay trivially copyable");
+
 class MeasurementConfiguration::builder {
 
 private:
-    unsigned int* mSamples;
-    float* mMaxDistanceValue;
-    DistanceUnit* mMaxDistanceUnit;
-    float* mTemperatureValue;
-    TemperatureUnit* mTemperatureUnit;
-    unsigned long* mResponseTimeoutMS;
-    DistanceUnit* mMeasurementDistanceUnit;
-
-    unsigned long* mResponseTimeoutCoolDownTimeMS;
+    MeasurementConfiguration mConfiguration;
 
 public:
-    builder() {
-        this->mSamples = nullptr;
-        this->mMaxDistanceValue = nullptr;
-        this->mMaxDistanceUnit = nullptr;
-        this->mTemperatureValue = nullptr;
-        this->mTemperatureUnit = nullptr;
-        this->mResponseTimeoutMS = nullptr;
-        this->mMeasurementDistanceUnit = nullptr;
-        this->mResponseTimeoutCoolDownTimeMS = nullptr;
+    builder() : mConfiguration() {
     }
 
     /**
       * How many times to take measurement. Then the returned distance will be the average of a valid measurements.
       */
     builder& withSamples(const unsigned int& samples) {
-        this->mSamples = &const_cast<unsigned int&>(samples);
+        this->mConfiguration.samples = samples;
+        this->mConfiguration.presentParameters |= SAMPLES;
         return *this;
     }
 
@@ -114,28 +169,42 @@ public:
       * The maximum distance that is allowed. If a measurement's distance exceeds it, then the measurement is invalid.
       */
     builder& withMaxDistance(const float& maxDistance, const DistanceUnit& maxDistanceUnit) {
-        this->mMaxDistanceValue = &const_cast<float&>(maxDistance);
-        this->mMaxDistanceUnit = &const_cast<DistanceUnit&>(maxDistanceUnit);
+        this->mConfiguration.maxDistanceValue = maxDistance;
+        this->mConfiguration.maxDistanceUnit = maxDistanceUnit;
+        this->mConfiguration.presentParameters |= MAX_DISTANCE;
         return *this;
     }
 
+    template<typename Unit>
+    builder& withMaxDistance(const Length<Unit>& maxDistance) {
+        return this->withMaxDistance(maxDistance.getValue(), Unit::unit());
+    }
+
     /**
       *  The ambient temperature.
       * Increases the accuracy of the measurement, because the sound speed is dependent on temperature.
+      * It replaces the calibrated sound speed of the sensor for this measurement.
       */
     builder& withTemperature(const float& temperature, const TemperatureUnit& temperatureUnit) {
-        this->mTemperatureValue = &const_cast<float&>(temperature);
-        this->mTemperatureUnit = &const_cast<TemperatureUnit&>(temperatureUnit);
+        this->mConfiguration.temperatureValue = temperature;
+        this->mConfiguration.temperatureUnit = temperatureUnit;
+        this->mConfiguration.presentParameters |= TEMPERATURE;
         return *this;
     }
 
+    template<typename Unit>
+    builder& withTemperature(const Temperature<Unit>& temperature) {
+        return this->withTemperature(temperature.getValue(), Unit::unit());
+    }
+
     /**
       * The maximum time to take a measurement.
       * If the time is exceeded then the measurement is invalid.
       * Indication when there is something wrong with the communication to the device eg: not connected
       */
     builder& withResponseTimeoutMS(const unsigned long& responseTimeoutMS) {
-        this->mResponseTimeoutMS = &const_cast<unsigned long&>(responseTimeoutMS);
+        this->mConfiguration.responseTimeoutMS = responseTimeoutMS;
+        this->mConfiguration.presentParameters |= RESPONSE_TIMEOUT;
         return *this;
     }
 
@@ -143,7 +212,8 @@ public:
       * In what distance unit the measurement will be returned.
       */
     builder& withMeasurementDistanceUnit(const DistanceUnit& measurementDistanceUnit) {
-        this->mMeasurementDistanceUnit = &const_cast<DistanceUnit&>(measurementDistanceUnit);
+        this->mConfiguration.measurementDistanceUnit = measurementDistanceUnit;
+        this->mConfiguration.presentParameters |= MEASUREMENT_DISTANCE_UNIT;
         return *this;
     }
 
@@ -154,19 +224,33 @@ public:
       * The cool down will be **activated**, when **all of the samples** that have been measured have **timed out**. If a **measurement fails again**, then it will be **activated again** and so on.
       */
     builder& withResponseTimeoutCoolDown(const unsigned long& responseTimeoutCoolDownTimeMS) {
-        this->mResponseTimeoutCoolDownTimeMS = &const_cast<unsigned long&>(responseTimeoutCoolDownTimeMS);
+        this->mConfiguration.responseTimeoutCoolDownTimeMS = responseTimeoutCoolDownTimeMS;
+        this->mConfiguration.presentParameters |= RESPONSE_TIMEOUT_COOL_DOWN;
+        return *this;
+    }
+
+    /**
+      * The maximum time that the whole measurement can take. 0 for no limit.
+      * Samples are taken only while the remaining time can fit another echo and the spacing between the pings.
+      * The echo has to fit the response timeout and the distance of the max distance.
+      */
+    builder& withTimeBudgetMS(const unsigned long& timeBudgetMS) {
+        this->mConfiguration.timeBudgetMS = timeBudgetMS;
+        this->mConfiguration.presentParameters |= TIME_BUDGET;
+        return *this;
+    }
+
+    /**
+      * How many samples have to be taken at least. If the time budget doesn't allow them, the measurement will be flagged.
+      */
+    builder& withMinimumSamples(const unsigned int& minimumSamples) {
+        this->mConfiguration.minimumSamples = minimumSamples;
+        this->mConfiguration.presentParameters |= MINIMUM_SAMPLES;
         return *this;
     }
 
     MeasurementConfiguration build() const {
-        return {this->mSamples,
-                this->mMaxDistanceValue,
-                this->mMaxDistanceUnit,
-                this->mTemperatureValue,
-                this->mTemperatureUnit,
-                this->mResponseTimeoutMS,
-                this->mMeasurementDistanceUnit,
-                this->mResponseTimeoutCoolDownTimeMS};
+        return this->mConfiguration;
     }
 
 };
@@ -0,0 +1,209 @@
+#ifndef HC_SR04_MEASUREMENTROLLUPS_H
+#define HC_SR04_MEASUREMENTROLLUPS_H
+
+#include <Arduino.h>
+#include "Measurement.h"
+
+/**
+ * The min, max, mean and count of the distances in a period of time, which starts at startTimeMS and is as long as the resolution of its level.
+ */
+struct RollupAggregate {
+
+    uint32_t startTimeMS;
+    float minDistance;
+    float maxDistance;
+    float meanDistance;
+    uint32_t count;
+};
+
+/**
+ * Downsampled history of distances at several resolutions, in fixed memory.
+ *
+ * Each level has a ring of the last SLOTS aggregates and the aggregate that is still open. Only the finest level takes the distances,
+ * when its aggregate closes it is merged into the open aggregate of the next level and so on, so adding a distance is O(1) amortized.
+ * Periods without distances (for example an outage) take no slots.
+ *
+ * The resolutions are given from the finest to the coarsest and each one should be a multiple of the previous, so the periods of the levels are aligned.
+ * The memory is LEVELS * (SLOTS + 1) aggregates of 20 bytes, for example 3 levels of 12 slots take about 800 bytes.
+ *
+ * @tparam LEVELS How many resolutions
+ * @tparam SLOTS How many closed aggregates each resolution keeps
+ */
+template<uint8_t LEVELS, uint8_t SLOTS>
+class MeasurementRollups {
+
+    static_assert(LEVELS >= 1 && SLOTS >= 1, "There must be at least one level with one slot");
+
+private:
+
+    struct RollupLevel {
+
+        uint32_t resolutionMS;
+        RollupAggregate slots[SLOTS];
+        uint8_t newestSlotIndex;
+        uint8_t slotsCount;
+        RollupAggregate open;
+    };
+
+    RollupLevel levels[LEVELS];
+
+    static bool isAtOrAfter(const uint32_t& timeMS, const uint32_t& otherTimeMS) {
+        return static_cast<int32_t>(timeMS - otherTimeMS) >= 0;
+    }
+
+    static void mergeAggregate(RollupAggregate& into, const RollupAggregate& aggregate) {
+
+        if (into.count == 0) {
+            uint32_t startTimeMS = into.startTimeMS;
+            into = aggregate;
+            into.startTimeMS = startTimeMS;
+            return;
+        }
+
+        //Saturated, so the min, max and mean are still merged. A day at 25 Hz is only ~2.2 million distances
+        uint32_t count = into.count > UINT32_MAX - aggregate.count ? UINT32_MAX : into.count + aggregate.count;
+
+        into.minDistance = min(into.minDistance, aggregate.minDistance);
+        into.maxDistance = max(into.maxDistance, aggregate.maxDistance);
+        into.meanDistance += (aggregate.meanDistance - into.meanDistance) * static_cast<float>(aggregate.count) / static_cast<float>(count);
+        into.count = count;
+    }
+
+    /**
+     * Will close the open aggregate of the level if the given time is after its period, and start a new one, aligned to the resolution.
+     */
+    void advanceLevel(const uint8_t& levelIndex, const uint32_t& timeMS) {
+
+        RollupLevel& level = this->levels[levelIndex];
+
+        if (level.open.count > 0 && !isAtOrAfter(timeMS, level.open.startTimeMS + level.resolutionMS))
+            return;
+
+        if (level.open.count > 0) {
+            level.newestSlotIndex = static_cast<uint8_t>((level.newestSlotIndex + 1) % SLOTS);
+            level.slots[level.newestSlotIndex] = level.open;
+            level.slotsCount = min(static_cast<uint8_t>(level.slotsCount + 1), SLOTS);
+
+            if (levelIndex + 1 < LEVELS) {
+                this->advanceLevel(levelIndex + 1, level.open.startTimeMS);
+                mergeAggregate(this->levels[levelIndex + 1].open, level.open);
+            }
+        }
+
+        level.open = {timeMS - timeMS % level.resolutionMS, 0, 0, 0, 0};
+    }
+
+    /**
+     * @return The closed aggregate of the level. 0 is the oldest
+     */
+    const RollupAggregate& getSlot(const RollupLevel& level, const uint8_t& index) const {
+        return level.slots[(level.newestSlotIndex + SLOTS - level.slotsCount + 1 + index) % SLOTS];
+    }
+
+public:
+
+    /**
+     * @param resolutionsMS The length of the aggregates of each level, from the finest to the coarsest. For example {60000, 900000, 3600000}
+     */
+    MeasurementRollups(const uint32_t (&resolutionsMS)[LEVELS]) {
+
+        for (uint8_t i = 0; i < LEVELS; i++) {
+            this->levels[i].resolutionMS = max(resolutionsMS[i], static_cast<uint32_t>(1));
+            this->levels[i].newestSlotIndex = SLOTS - 1;
+            this->levels[i].slotsCount = 0;
+            this->levels[i].open = {0, 0, 0, 0, 0};
+        }
+    }
+
+    void add(const uint32_t& timeMS, const float& distance) {
+
+        this->advanceLevel(0, timeMS);
+
+        RollupAggregate& open = this->levels[0].open;
+
+        if (open.count == UINT32_MAX)
+            return;
+
+        open.count++;
+        open.minDistance = open.count == 1 ? distance : min(open.minDistance, distance);
+        open.maxDistance = open.count == 1 ? distance : max(open.maxDistance, distance);
+        open.meanDistance += (distance - open.meanDistance) / open.count;
+    }
+
+    /**
+     * Will add the distance of the measurement, if it has valid samples.
+     */
+    void add(const uint32_t& timeMS, const Measurement& measurement) {
+
+        if (measurement.getValidMeasurementsCount() > 0)
+            this->add(timeMS, measurement.getDistance());
+    }
+
+    /**
+     * Will find the aggregates of the given time range at the finest level, which still has the beginning of the range.
+     * If no level reaches back to the beginning, the coarsest level is used.
+     *
+     * @param fromTimeMS The beginning of the range
+     * @param toTimeMS The end of the range
+     * @param aggregates Will be filled with the aggregates, from the oldest to the newest. The last one can still be open
+     * @param maxAggregates The capacity of the aggregates. At most SLOTS + 1
+     * @param levelIndex Will be filled with the level of the aggregates
+     * @return How many aggregates were filled
+     */
+    uint8_t query(const uint32_t& fromTimeMS, const uint32_t& toTimeMS, RollupAggregate* aggregates, const uint8_t& maxAggregates, uint8_t& levelIndex) const {
+
+        levelIndex = LEVELS - 1;
+
+        for (uint8_t i = 0; i < LEVELS; i++) {
+            const RollupLevel& level = this->levels[i];
+            uint32_t oldestStartTimeMS = level.slotsCount > 0 ? this->getSlot(level, 0).startTimeMS : level.open.startTimeMS;
+
+            if (isAtOrAfter(fromTimeMS, oldestStartTimeMS) && (level.slotsCount > 0 || level.open.count > 0)) {
+                levelIndex = i;
+                break;
+            }
+        }
+
+        const RollupLevel& level = this->levels[levelIndex];
+        uint8_t aggregatesCount = 0;
+
+        for (uint8_t i = 0; i <= level.slotsCount && aggregatesCount < maxAggregates; i++) {
+            const RollupAggregate& aggregate = i < level.slotsCount ? this->getSlot(level, i) : level.open;
+
+            bool isInRange = isAtOrAfter(aggregate.startTimeMS + level.resolutionMS, fromTimeMS + 1) && isAtOrAfter(toTimeMS, aggregate.startTimeMS);
+
+            if (aggregate.count > 0 && isInRange)
+                aggregates[aggregatesCount++] = aggregate;
+        }
+
+        return aggregatesCount;
+    }
+
+    uint32_t getResolutionMS(const uint8_t& levelIndex) const {
+        return this->levels[levelIndex].resolutionMS;
+    }
+
+    /**
+     * @return How many closed aggregates the level has
+     */
+    uint8_t getAggregatesCount(const uint8_t& levelIndex) const {
+        return this->levels[levelIndex].slotsCount;
+    }
+
+    /**
+     * @return The closed aggregate of the level. 0 is the oldest
+     */
+    const RollupAggregate& getAggregate(const uint8_t& levelIndex, const uint8_t& index) const {
+        return this->getSlot(this->levels[levelIndex], index);
+    }
+
+    /**
+     * @return The aggregate of the level, which still takes distances
+     */
+    const RollupAggregate& getOpenAggregate(const uint8_t& levelIndex) const {
+        return this->levels[levelIndex].open;
+    }
+};
+
+
+#endif //HC_SR04_MEASUREMENTROLLUPS_H
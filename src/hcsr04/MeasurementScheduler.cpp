@@ -0,0 +1,172 @@
+#include "MeasurementScheduler.h"
+
+MeasurementScheduler::MeasurementScheduler() : MeasurementScheduler(millis) {
+}
+
+MeasurementScheduler::MeasurementScheduler(unsigned long (*clock)()) : clock(clock) {
+    this->scheduledSensorsCount = 0;
+}
+
+/**
+ * Wrap safe comparison of two millis() timestamps.
+ *
+ * @return If the first timestamp is before the second one
+ */
+bool MeasurementScheduler::isBefore(const unsigned long& first, const unsigned long& second) {
+    return static_cast<long>(first - second) < 0;
+}
+
+/**
+ * Will register a sensor, which will be measured periodically.
+ *
+ * @param sensor The sensor that will be measured
+ * @param periodMS How often the sensor needs fresh data
+ * @param deadlineMS Until when (relative to the start of the period) the measurement has to be completed
+ * @param samples How many samples will be taken on each measurement
+ * @return The index of the sensor in the scheduler. -1 If there is no more space for sensors or the period is 0.
+ */
+int MeasurementScheduler::addSensor(HCSR04& sensor, const unsigned long& periodMS, const unsigned long& deadlineMS, const unsigned int& samples) {
+
+    if (this->scheduledSensorsCount >= MAX_SCHEDULED_SENSORS || periodMS == 0)
+        return -1;
+
+    unsigned long nowMS = this->clock();
+
+    ScheduledSensor& scheduledSensor = this->scheduledSensors[this->scheduledSensorsCount];
+    scheduledSensor.sensor = &sensor;
+    scheduledSensor.periodMS = periodMS;
+    scheduledSensor.deadlineMS = deadlineMS;
+    scheduledSensor.samples = samples;
+    scheduledSensor.releaseMS = nowMS;
+    scheduledSensor.firstReleaseMS = nowMS;
+    scheduledSensor.completedCount = 0;
+    scheduledSensor.deadlineMissCount = 0;
+    scheduledSensor.lastMeasurement = Measurement();
+
+    return this->scheduledSensorsCount++;
+}
+
+/**
+ * If the scheduler fell behind a sensor by more than one period, the missed periods are counted as deadline misses
+ * and the sensor is released for the latest period only. That way the sensor doesn't get measured back to back to catch up.
+ * The missed periods are counted with a single division, so a long starvation doesn't take a loop per period.
+ * The sensor must be released already.
+ */
+void MeasurementScheduler::skipOverdueReleases(ScheduledSensor& scheduledSensor, const unsigned long& nowMS) {
+
+    unsigned long missedPeriodsCount = (nowMS - scheduledSensor.releaseMS) / scheduledSensor.periodMS;
+
+    scheduledSensor.releaseMS += missedPeriodsCount * scheduledSensor.periodMS;
+    scheduledSensor.deadlineMissCount += missedPeriodsCount;
+}
+
+/**
+ * @return The index of the released sensor with the earliest absolute deadline. -1 If no sensor is released yet.
+ */
+int MeasurementScheduler::findEarliestDeadlineReadySensor(const unsigned long& nowMS) {
+
+    int earliestIndex = -1;
+    unsigned long earliestDeadlineMS = 0;
+
+    for (uint8_t i = 0; i < this->scheduledSensorsCount; i++) {
+        ScheduledSensor& scheduledSensor = this->scheduledSensors[i];
+
+        if (isBefore(nowMS, scheduledSensor.releaseMS))
+            continue;
+
+        this->skipOverdueReleases(scheduledSensor, nowMS);
+
+        unsigned long deadlineMS = scheduledSensor.releaseMS + scheduledSensor.deadlineMS;
+
+        if (earliestIndex == -1 || isBefore(deadlineMS, earliestDeadlineMS)) {
+            earliestIndex = i;
+            earliestDeadlineMS = deadlineMS;
+        }
+    }
+
+    return earliestIndex;
+}
+
+/**
+ * Will measure the released sensor with the earliest deadline. Should be called as often as possible, for example on each loop.
+ *
+ * @return If a sensor was measured
+ */
+bool MeasurementScheduler::poll() {
+
+    int index = this->findEarliestDeadlineReadySensor(this->clock());
+
+    if (index == -1)
+        return false;
+
+    ScheduledSensor& scheduledSensor = this->scheduledSensors[index];
+    unsigned int samples = scheduledSensor.samples;
+
+    scheduledSensor.lastMeasurement = scheduledSensor.sensor->measure(MeasurementConfiguration::builder().withSamples(samples).build());
+    scheduledSensor.completedCount++;
+
+    unsigned long completedMS = this->clock();
+
+    if (isBefore(scheduledSensor.releaseMS + scheduledSensor.deadlineMS, completedMS))
+        scheduledSensor.deadlineMissCount++;
+
+    scheduledSensor.releaseMS += scheduledSensor.periodMS;
+
+    return true;
+}
+
+/**
+ * @return How much time is left until a sensor is released. 0 If there is a sensor waiting to be measured or no sensors at all.
+ */
+unsigned long MeasurementScheduler::getTimeUntilNextReleaseMS() {
+
+    if (this->scheduledSensorsCount == 0)
+        return 0;
+
+    unsigned long nowMS = this->clock();
+    unsigned long untilNextReleaseMS = this->scheduledSensors[0].periodMS;
+
+    for (uint8_t i = 0; i < this->scheduledSensorsCount; i++) {
+        const ScheduledSensor& scheduledSensor = this->scheduledSensors[i];
+
+        if (!isBefore(nowMS, scheduledSensor.releaseMS))
+            return 0;
+
+        untilNextReleaseMS = min(untilNextReleaseMS, scheduledSensor.releaseMS - nowMS);
+    }
+
+    return untilNextReleaseMS;
+}
+
+uint8_t MeasurementScheduler::getSensorsCount() const {
+    return this->scheduledSensorsCount;
+}
+
+unsigned long MeasurementScheduler::getCompletedCount(const uint8_t& index) const {
+    return this->scheduledSensors[index].completedCount;
+}
+
+/**
+ * @return How many times the measurement was completed after its deadline or its period was skipped at all
+ */
+unsigned long MeasurementScheduler::getDeadlineMissCount(const uint8_t& index) const {
+    return this->scheduledSensors[index].deadlineMissCount;
+}
+
+/**
+ * @return The measurements per second that the sensor actually received since it was registered
+ */
+float MeasurementScheduler::getAchievedRateHz(const uint8_t& index) {
+
+    const ScheduledSensor& scheduledSensor = this->scheduledSensors[index];
+    unsigned long elapsedMS = this->clock() - scheduledSensor.firstReleaseMS;
+
+    if (elapsedMS == 0)
+        return 0;
+
+    return static_cast<float>(scheduledSensor.completedCount) * 1000.00f / static_cast<float>(elapsedMS);
+}
+
+Measurement MeasurementScheduler::getLastMeasurement(const uint8_t& index) const {
+    return this->scheduledSensors[index].lastMeasurement;
+}
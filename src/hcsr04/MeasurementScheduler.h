@@ -0,0 +1,73 @@
+#ifndef HC_SR04_MEASUREMENTSCHEDULER_H
+#define HC_SR04_MEASUREMENTSCHEDULER_H
+
+#include <Arduino.h>
+#include "HCSR04.h"
+
+#define MAX_SCHEDULED_SENSORS 4
+
+/**
+ * Shares one MCU between multiple HC-SR04 sensors that have different freshness needs.
+ *
+ * Each sensor is registered with the period at which it needs fresh data, the deadline (relative to the start of the period)
+ * until which the measurement has to be completed and its sample budget. On every poll the ready sensor with the
+ * earliest absolute deadline is measured (Earliest Deadline First).
+ *
+ * The time is taken from the given clock function, which by default is millis(). On the host it can be replaced with a virtual clock.
+ */
+class MeasurementScheduler {
+
+private:
+
+    struct ScheduledSensor {
+
+        HCSR04* sensor;
+        unsigned long periodMS;
+        unsigned long deadlineMS;
+        unsigned int samples;
+
+        unsigned long releaseMS;
+        unsigned long firstReleaseMS;
+
+        unsigned long completedCount;
+        unsigned long deadlineMissCount;
+
+        Measurement lastMeasurement;
+    };
+
+    unsigned long (*clock)();
+
+    ScheduledSensor scheduledSensors[MAX_SCHEDULED_SENSORS];
+    uint8_t scheduledSensorsCount;
+
+    static bool isBefore(const unsigned long& first, const unsigned long& second);
+
+    int findEarliestDeadlineReadySensor(const unsigned long& nowMS);
+
+    void skipOverdueReleases(ScheduledSensor& scheduledSensor, const unsigned long& nowMS);
+
+public:
+
+    MeasurementScheduler();
+
+    MeasurementScheduler(unsigned long (*clock)());
+
+    int addSensor(HCSR04& sensor, const unsigned long& periodMS, const unsigned long& deadlineMS, const unsigned int& samples);
+
+    bool poll();
+
+    unsigned long getTimeUntilNextReleaseMS();
+
+    uint8_t getSensorsCount() const;
+
+    unsigned long getCompletedCount(const uint8_t& index) const;
+
+    unsigned long getDeadlineMissCount(const uint8_t& index) const;
+
+    float getAchievedRateHz(const uint8_t& index);
+
+    Measurement getLastMeasurement(const uint8_t& index) const;
+};
+
+
+#endif //HC_SR04_MEASUREMENTSCHEDULER_H
@@ -0,0 +1,16 @@
+#ifndef HC_SR04_MEASUREMENTSTATISTICS_H
+#define HC_SR04_MEASUREMENTSTATISTICS_H
+
+
+/**
+ * How the echo signals of the valid samples of a measurement are spread. In microseconds, the Measurement converts them to distances.
+ */
+struct MeasurementStatistics {
+
+    float signalLengthStandardDeviationUS;
+    float minSignalLengthUS;
+    float maxSignalLengthUS;
+};
+
+
+#endif //HC_SR04_MEASUREMENTSTATISTICS_H
@@ -0,0 +1,157 @@
+#ifndef HC_SR04_OCCUPANCYGRID_H
+#define HC_SR04_OCCUPANCYGRID_H
+
+#include <Arduino.h>
+#include "PolarReading.h"
+
+#define OCCUPANCY_HIT_LOG_ODDS 16
+#define OCCUPANCY_MISS_LOG_ODDS -6
+#define OCCUPANCY_MAX_LOG_ODDS 120
+#define OCCUPANCY_OCCUPIED_LOG_ODDS 24
+#define OCCUPANCY_FREE_LOG_ODDS -12
+
+/**
+ * Occupancy grid around the sensor in fixed memory, one byte of log odds per cell. 0 is unknown, positive is occupied, negative is free.
+ *
+ * Each reading is a ray from the origin cell in the direction of its angle. Only the cells along the ray are touched (Bresenham's line),
+ * the cells before the echo become more free and the cell of the echo more occupied. A ray without an echo is free up to the max distance.
+ * A reading without information (see PolarReading) leaves the cells as they are.
+ * The log odds saturate, so a cell that was seen many times can still change after a few readings.
+ *
+ * The angles are counter clockwise from the x axis of the grid. The memory is WIDTH * HEIGHT bytes, for example 24x24 cells take 576 bytes.
+ *
+ * @tparam WIDTH The cells along the x axis
+ * @tparam HEIGHT The cells along the y axis
+ */
+template<uint8_t WIDTH, uint8_t HEIGHT>
+class OccupancyGrid {
+
+    static_assert(WIDTH >= 1 && HEIGHT >= 1, "The grid must have at least one cell");
+
+private:
+
+    int8_t cells[WIDTH * HEIGHT];
+    float cellSizeCM;
+    int16_t originX;
+    int16_t originY;
+
+    static bool isInside(const int16_t& x, const int16_t& y) {
+        return x >= 0 && y >= 0 && x < WIDTH && y < HEIGHT;
+    }
+
+    void addLogOdds(const int16_t& x, const int16_t& y, const int8_t& logOdds) {
+
+        int8_t& cell = this->cells[static_cast<uint16_t>(y) * WIDTH + static_cast<uint16_t>(x)];
+        int16_t updated = static_cast<int16_t>(cell) + logOdds;
+
+        cell = static_cast<int8_t>(constrain(updated, -OCCUPANCY_MAX_LOG_ODDS, OCCUPANCY_MAX_LOG_ODDS));
+    }
+
+public:
+
+    /**
+     * @param cellSizeCM The side of a cell
+     * @param originX The cell of the sensor
+     * @param originY The cell of the sensor
+     */
+    OccupancyGrid(const float& cellSizeCM, const int16_t& originX, const int16_t& originY) {
+        this->cellSizeCM = cellSizeCM;
+        this->originX = originX;
+        this->originY = originY;
+
+        this->clear();
+    }
+
+    void clear() {
+        memset(this->cells, 0, sizeof(this->cells));
+    }
+
+    /**
+     * Will move the sensor, for example when the robot moves. The cells stay.
+     */
+    void setOrigin(const int16_t& originX, const int16_t& originY) {
+        this->originX = originX;
+        this->originY = originY;
+    }
+
+    /**
+     * @param reading The reading of the SweepScanner
+     * @param headingDegrees Where the angle 0 of the servo points in the grid
+     * @param maxDistanceCM How far a ray without an echo is free
+     * @return How many cells were touched
+     */
+    uint16_t addReading(const PolarReading& reading, const float& headingDegrees, const float& maxDistanceCM) {
+
+        if (!reading.hasInformation)
+            return 0;
+
+        float distanceCM = reading.isValid ? min(reading.distanceCM, maxDistanceCM) : maxDistanceCM;
+        float angleRadians = (headingDegrees + reading.angleDegrees) * DEG_TO_RAD;
+        float distanceCells = distanceCM / this->cellSizeCM;
+
+        int16_t endX = this->originX + static_cast<int16_t>(lroundf(cosf(angleRadians) * distanceCells));
+        int16_t endY = this->originY + static_cast<int16_t>(lroundf(sinf(angleRadians) * distanceCells));
+
+        int16_t deltaX = abs(endX - this->originX);
+        int16_t deltaY = -abs(endY - this->originY);
+        int8_t stepX = this->originX < endX ? 1 : -1;
+        int8_t stepY = this->originY < endY ? 1 : -1;
+        int16_t error = deltaX + deltaY;
+
+        int16_t x = this->originX;
+        int16_t y = this->originY;
+        uint16_t touchedCellsCount = 0;
+
+        while (isInside(x, y)) {
+
+            bool isEnd = x == endX && y == endY;
+
+            this->addLogOdds(x, y, isEnd && reading.isValid ? OCCUPANCY_HIT_LOG_ODDS : OCCUPANCY_MISS_LOG_ODDS);
+            touchedCellsCount++;
+
+            if (isEnd)
+                break;
+
+            int16_t doubledError = 2 * error;
+
+            if (doubledError >= deltaY) {
+                error += deltaY;
+                x += stepX;
+            }
+
+            if (doubledError <= deltaX) {
+                error += deltaX;
+                y += stepY;
+            }
+        }
+
+        return touchedCellsCount;
+    }
+
+    int8_t getLogOdds(const int16_t& x, const int16_t& y) const {
+        return isInside(x, y) ? this->cells[static_cast<uint16_t>(y) * WIDTH + static_cast<uint16_t>(x)] : 0;
+    }
+
+    bool isOccupied(const int16_t& x, const int16_t& y) const {
+        return this->getLogOdds(x, y) >= OCCUPANCY_OCCUPIED_LOG_ODDS;
+    }
+
+    bool isFree(const int16_t& x, const int16_t& y) const {
+        return this->getLogOdds(x, y) <= OCCUPANCY_FREE_LOG_ODDS;
+    }
+
+    float getCellSizeCM() const {
+        return this->cellSizeCM;
+    }
+
+    uint8_t getWidth() const {
+        return WIDTH;
+    }
+
+    uint8_t getHeight() const {
+        return HEIGHT;
+    }
+};
+
+
+#endif //HC_SR04_OCCUPANCYGRID_H
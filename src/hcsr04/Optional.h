@@ -28,29 +28,33 @@
  * Here comes the solution with the Optional. Short solution with one call.
  *
  * Optional<int> someMethod() {
- *   return Optional<int>(&variable);
+ *   return Optional<int>(variable, isVariableSet);
  * }
  *
- * int actualResult = someMethod().orElse(5);
+ * int actualResult = someMethod().orElseGet(5);
  *
+ * The value is stored in the Optional itself, so it never points to a variable that doesn't exist anymore.
  */
 template<typename B>
 class Optional {
 
 private:
-    B* base;
+    B base;
+    bool isPresent;
 
 public:
-    Optional(B* base) {
-        this->base = base;
+    Optional() : base(), isPresent(false) {
     }
 
-    bool has() {
-        return this->base;
+    Optional(const B& base, const bool& isPresent) : base(base), isPresent(isPresent) {
     }
 
-    B orElseGet(B value) {
-        return this->has() ? *this->base : value;
+    bool has() const {
+        return this->isPresent;
+    }
+
+    B orElseGet(const B& value) const {
+        return this->isPresent ? this->base : value;
     }
 };
 
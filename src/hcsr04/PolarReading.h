@@ -0,0 +1,21 @@
+#ifndef HC_SR04_POLARREADING_H
+#define HC_SR04_POLARREADING_H
+
+#include <stdint.h>
+
+/**
+ * The distance at one angle of a sweep. An invalid reading has no echo in the max distance, so the ray is free up to it.
+ * A reading without information didn't hear the sensor at all (the response cool-down was active or every response timed out),
+ * so it says nothing about the ray. A timed out response can also be an echo that was reflected away from an obstacle.
+ */
+struct PolarReading {
+
+    float angleDegrees;
+    float distanceCM;
+    uint8_t samples;
+    bool isValid;
+    bool hasInformation;
+};
+
+
+#endif //HC_SR04_POLARREADING_H
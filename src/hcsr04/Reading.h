@@ -0,0 +1,16 @@
+#ifndef HC_SR04_READING_H
+#define HC_SR04_READING_H
+
+#include <stdint.h>
+
+/**
+ * A logged distance with the time when it was measured.
+ */
+struct Reading {
+
+    uint32_t timeMS;
+    float distance;
+};
+
+
+#endif //HC_SR04_READING_H
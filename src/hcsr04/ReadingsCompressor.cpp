@@ -0,0 +1,43 @@
+#include "ReadingsCompressor.h"
+
+/**
+ * @param output Where the compressed readings will be written
+ * @param quantum The resolution of the stored distances, in the unit of the distances
+ */
+ReadingsCompressor::ReadingsCompressor(Print& output, const float& quantum) : output(output), encoder(quantum) {
+}
+
+void ReadingsCompressor::write(const uint32_t& timeMS, const float& distance) {
+
+    uint8_t buffer[READINGS_ENCODER_MAX_OUTPUT_SIZE];
+    uint8_t size = this->encoder.encode(timeMS, distance, buffer);
+
+    if (size > 0)
+        this->output.write(buffer, size);
+}
+
+/**
+ * Will write the distance of the measurement, in its unit.
+ */
+void ReadingsCompressor::write(const uint32_t& timeMS, const Measurement& measurement) {
+    this->write(timeMS, measurement.getDistance());
+}
+
+/**
+ * Will write the pending run of repeated readings. Call it before the output is closed.
+ */
+void ReadingsCompressor::flush() {
+
+    uint8_t buffer[READINGS_VARINT_MAX_SIZE];
+    uint8_t size = this->encoder.flush(buffer);
+
+    if (size > 0)
+        this->output.write(buffer, size);
+}
+
+/**
+ * @return The encoder with the counts of the readings and the bytes
+ */
+const ReadingsEncoder& ReadingsCompressor::getEncoder() const {
+    return this->encoder;
+}
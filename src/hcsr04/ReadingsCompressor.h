@@ -0,0 +1,33 @@
+#ifndef HC_SR04_READINGSCOMPRESSOR_H
+#define HC_SR04_READINGSCOMPRESSOR_H
+
+#include <Arduino.h>
+#include "ReadingsEncoder.h"
+#include "Measurement.h"
+
+/**
+ * Writes the compressed readings to any Print, for example a File of an SD card or the Serial.
+ * Only the bytes of a single reading are buffered, on the stack.
+ */
+class ReadingsCompressor {
+
+private:
+
+    Print& output;
+    ReadingsEncoder encoder;
+
+public:
+
+    ReadingsCompressor(Print& output, const float& quantum);
+
+    void write(const uint32_t& timeMS, const float& distance);
+
+    void write(const uint32_t& timeMS, const Measurement& measurement);
+
+    void flush();
+
+    const ReadingsEncoder& getEncoder() const;
+};
+
+
+#endif //HC_SR04_READINGSCOMPRESSOR_H
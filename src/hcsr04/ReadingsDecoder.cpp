@@ -0,0 +1,203 @@
+#include "ReadingsDecoder.h"
+#include <string.h>
+
+ReadingsDecoder::ReadingsDecoder() {
+    this->reset();
+}
+
+/**
+ * Will start decoding a new stream, which begins with a header.
+ */
+void ReadingsDecoder::reset() {
+    this->state = State::HEADER;
+    this->headerBytesCount = 0;
+    this->quantumBits = 0;
+    this->quantum = 0;
+    this->varintValue = 0;
+    this->varintShift = 0;
+    this->timeMS = 0;
+    this->timeDeltaMS = 0;
+    this->quantizedDistance = 0;
+    this->pendingTimeDeltaOfDeltaMS = 0;
+    this->isReadingReady = false;
+    this->pendingRunLength = 0;
+    this->decodedReadingsCount = 0;
+}
+
+/**
+ * @return If the varint is complete. Its value is in varintValue
+ */
+bool ReadingsDecoder::feedVarint(const uint8_t& byte) {
+
+    if (this->varintShift == 0)
+        this->varintValue = 0;
+
+    this->varintValue |= static_cast<uint32_t>(byte & 0x7F) << this->varintShift;
+
+    if (byte & 0x80) {
+        this->varintShift += 7;
+
+        if (this->varintShift >= 7 * READINGS_VARINT_MAX_SIZE)
+            this->state = State::INVALID;
+
+        return false;
+    }
+
+    this->varintShift = 0;
+    return true;
+}
+
+void ReadingsDecoder::feedHeader(const uint8_t& byte) {
+
+    bool isValid = true;
+
+    if (this->headerBytesCount == 0)
+        isValid = byte == READINGS_MAGIC;
+    else if (this->headerBytesCount == 1)
+        isValid = byte == READINGS_VERSION;
+    else
+        this->quantumBits |= static_cast<uint32_t>(byte) << (8 * (this->headerBytesCount - 2));
+
+    this->headerBytesCount++;
+
+    if (!isValid) {
+        this->state = State::INVALID;
+    } else if (this->headerBytesCount == READINGS_HEADER_SIZE) {
+        memcpy(&this->quantum, &this->quantumBits, sizeof(this->quantum));
+        this->state = State::TOKEN;
+    }
+}
+
+void ReadingsDecoder::feedToken(const uint32_t& token) {
+
+    switch (token & 3) {
+
+        case READINGS_TOKEN_READING:
+            this->pendingTimeDeltaOfDeltaMS = decodeZigZag(token >> 2);
+            this->state = State::READING_DISTANCE;
+            break;
+
+        case READINGS_TOKEN_RUN:
+            this->pendingRunLength = token >> 2;
+            break;
+
+        case READINGS_TOKEN_RESTART:
+            this->state = State::RESTART_TIME;
+            break;
+
+        default:
+            this->state = State::INVALID;
+            break;
+    }
+}
+
+/**
+ * Will decode the next byte. Call next() until it returns false before feeding the next byte.
+ */
+void ReadingsDecoder::feed(const uint8_t& byte) {
+
+    if (this->state == State::HEADER) {
+        this->feedHeader(byte);
+        return;
+    }
+
+    if (this->state == State::INVALID || !this->feedVarint(byte))
+        return;
+
+    switch (this->state) {
+
+        case State::TOKEN:
+            this->feedToken(this->varintValue);
+            break;
+
+        case State::READING_DISTANCE:
+            this->timeDeltaMS = static_cast<int32_t>(static_cast<uint32_t>(this->timeDeltaMS) + static_cast<uint32_t>(this->pendingTimeDeltaOfDeltaMS));
+            this->timeMS += static_cast<uint32_t>(this->timeDeltaMS);
+            this->quantizedDistance = static_cast<int32_t>(static_cast<uint32_t>(this->quantizedDistance) + static_cast<uint32_t>(decodeZigZag(this->varintValue)));
+            this->isReadingReady = true;
+            this->state = State::TOKEN;
+            break;
+
+        case State::RESTART_TIME:
+            this->timeMS = this->varintValue;
+            this->timeDeltaMS = 0;
+            this->state = State::RESTART_DISTANCE;
+            break;
+
+        case State::RESTART_DISTANCE:
+            this->quantizedDistance = decodeZigZag(this->varintValue);
+            this->isReadingReady = true;
+            this->state = State::TOKEN;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * Will decode the given bytes. Fast path for the host, where the compressed readings are in memory.
+ *
+ * @param consumedLength Will be filled with how many of the bytes were decoded
+ * @param readings Will be filled with the decoded readings
+ * @param maxReadings The capacity of the readings. The decoding stops when it is full, then the rest of the bytes have to be fed again
+ * @return How many readings were decoded
+ */
+size_t ReadingsDecoder::feed(const uint8_t* data, const size_t& length, size_t& consumedLength, Reading* readings, const size_t& maxReadings) {
+
+    size_t readingsCount = 0;
+
+    for (consumedLength = 0; consumedLength < length; consumedLength++) {
+
+        while (readingsCount < maxReadings && this->next(readings[readingsCount]))
+            readingsCount++;
+
+        if (readingsCount == maxReadings)
+            return readingsCount;
+
+        this->feed(data[consumedLength]);
+    }
+
+    while (readingsCount < maxReadings && this->next(readings[readingsCount]))
+        readingsCount++;
+
+    return readingsCount;
+}
+
+/**
+ * @param reading Will be filled with the next decoded reading
+ * @return If there was a decoded reading
+ */
+bool ReadingsDecoder::next(Reading& reading) {
+
+    if (this->isReadingReady) {
+        this->isReadingReady = false;
+    } else if (this->pendingRunLength > 0) {
+        this->pendingRunLength--;
+        this->timeMS += static_cast<uint32_t>(this->timeDeltaMS);
+    } else {
+        return false;
+    }
+
+    reading.timeMS = this->timeMS;
+    reading.distance = static_cast<float>(this->quantizedDistance) * this->quantum;
+
+    this->decodedReadingsCount++;
+
+    return true;
+}
+
+/**
+ * @return If the stream doesn't have the header of compressed readings or has a broken token
+ */
+bool ReadingsDecoder::isInvalid() const {
+    return this->state == State::INVALID;
+}
+
+float ReadingsDecoder::getQuantum() const {
+    return this->quantum;
+}
+
+unsigned long ReadingsDecoder::getDecodedReadingsCount() const {
+    return this->decodedReadingsCount;
+}
@@ -0,0 +1,67 @@
+#ifndef HC_SR04_READINGSDECODER_H
+#define HC_SR04_READINGSDECODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Reading.h"
+#include "ReadingsEncoder.h"
+
+/**
+ * Streaming decompressor of the readings of ReadingsEncoder. It is fed byte by byte, so the compressed readings can come
+ * from any source (EEPROM, SD card, serial) in chunks of any size. Its state is a few numbers, like the one of the encoder.
+ *
+ * After each fed byte, next() has to be called until it returns false, because a single run token can hold many readings.
+ */
+class ReadingsDecoder {
+
+private:
+
+    enum class State : uint8_t {
+        HEADER, TOKEN, READING_DISTANCE, RESTART_TIME, RESTART_DISTANCE, INVALID
+    };
+
+    State state;
+    uint8_t headerBytesCount;
+    uint32_t quantumBits;
+    float quantum;
+
+    uint32_t varintValue;
+    uint8_t varintShift;
+
+    uint32_t timeMS;
+    int32_t timeDeltaMS;
+    int32_t quantizedDistance;
+    int32_t pendingTimeDeltaOfDeltaMS;
+
+    bool isReadingReady;
+    uint32_t pendingRunLength;
+
+    unsigned long decodedReadingsCount;
+
+    bool feedVarint(const uint8_t& byte);
+
+    void feedHeader(const uint8_t& byte);
+
+    void feedToken(const uint32_t& token);
+
+public:
+
+    ReadingsDecoder();
+
+    void reset();
+
+    void feed(const uint8_t& byte);
+
+    size_t feed(const uint8_t* data, const size_t& length, size_t& consumedLength, Reading* readings, const size_t& maxReadings);
+
+    bool next(Reading& reading);
+
+    bool isInvalid() const;
+
+    float getQuantum() const;
+
+    unsigned long getDecodedReadingsCount() const;
+};
+
+
+#endif //HC_SR04_READINGSDECODER_H
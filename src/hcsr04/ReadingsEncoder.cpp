@@ -0,0 +1,166 @@
+#include "ReadingsEncoder.h"
+#include <string.h>
+
+/**
+ * Maps the small negative and positive numbers to small unsigned numbers: 0, -1, 1, -2, 2 ... to 0, 1, 2, 3, 4 ...
+ */
+uint32_t encodeZigZag(const int32_t& value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int32_t decodeZigZag(const uint32_t& value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+/**
+ * @return How many bytes were written. At most READINGS_VARINT_MAX_SIZE
+ */
+uint8_t encodeVarint(uint32_t value, uint8_t* output) {
+
+    uint8_t size = 0;
+
+    while (value >= 0x80) {
+        output[size++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+
+    output[size++] = static_cast<uint8_t>(value);
+
+    return size;
+}
+
+/**
+ * @param quantum The resolution of the stored distances, in the unit of the distances. For example 0.1 for millimeters when the distances are in centimeters
+ */
+ReadingsEncoder::ReadingsEncoder(const float& quantum) : quantum(quantum) {
+    this->isHeaderWritten = false;
+    this->hasPreviousReading = false;
+    this->previousTimeMS = 0;
+    this->previousTimeDeltaMS = 0;
+    this->previousQuantizedDistance = 0;
+    this->pendingRunLength = 0;
+    this->encodedReadingsCount = 0;
+    this->encodedBytesCount = 0;
+}
+
+int32_t ReadingsEncoder::quantize(const float& distance) const {
+    float quantizedDistance = distance / this->quantum;
+    return static_cast<int32_t>(quantizedDistance < 0 ? quantizedDistance - 0.5f : quantizedDistance + 0.5f);
+}
+
+uint8_t ReadingsEncoder::encodeHeader(uint8_t* output) {
+
+    uint32_t quantumBits;
+    memcpy(&quantumBits, &this->quantum, sizeof(quantumBits));
+
+    output[0] = READINGS_MAGIC;
+    output[1] = READINGS_VERSION;
+
+    for (uint8_t i = 0; i < 4; i++)
+        output[2 + i] = static_cast<uint8_t>(quantumBits >> (8 * i));
+
+    this->isHeaderWritten = true;
+
+    return READINGS_HEADER_SIZE;
+}
+
+uint8_t ReadingsEncoder::encodeRestart(const uint32_t& timeMS, const int32_t& quantizedDistance, uint8_t* output) {
+
+    uint8_t size = encodeVarint(READINGS_TOKEN_RESTART, output);
+    size += encodeVarint(timeMS, output + size);
+    size += encodeVarint(encodeZigZag(quantizedDistance), output + size);
+
+    this->previousTimeDeltaMS = 0;
+
+    return size;
+}
+
+/**
+ * Will compress the reading. Readings that repeat the previous one are only counted, until a different one comes or flush() is called.
+ *
+ * @param output At least READINGS_ENCODER_MAX_OUTPUT_SIZE bytes
+ * @return How many bytes were written in the output
+ */
+uint8_t ReadingsEncoder::encode(const uint32_t& timeMS, const float& distance, uint8_t* output) {
+
+    uint8_t size = this->isHeaderWritten ? 0 : this->encodeHeader(output);
+    int32_t quantizedDistance = this->quantize(distance);
+
+    int32_t timeDeltaMS = static_cast<int32_t>(timeMS - this->previousTimeMS);
+    int32_t timeDeltaOfDeltaMS = static_cast<int32_t>(static_cast<uint32_t>(timeDeltaMS) - static_cast<uint32_t>(this->previousTimeDeltaMS));
+    int32_t distanceDelta = static_cast<int32_t>(static_cast<uint32_t>(quantizedDistance) - static_cast<uint32_t>(this->previousQuantizedDistance));
+
+    bool isRepeated = this->hasPreviousReading && timeDeltaOfDeltaMS == 0 && distanceDelta == 0;
+
+    if (isRepeated && this->pendingRunLength < READINGS_TOKEN_MAX_VALUE) {
+        this->pendingRunLength++;
+    } else {
+        size += this->encodePendingRun(output + size);
+
+        uint32_t zigZagTimeDeltaOfDeltaMS = encodeZigZag(timeDeltaOfDeltaMS);
+
+        if (!this->hasPreviousReading || zigZagTimeDeltaOfDeltaMS > READINGS_TOKEN_MAX_VALUE) {
+            size += this->encodeRestart(timeMS, quantizedDistance, output + size);
+            timeDeltaMS = 0;
+        } else {
+            size += encodeVarint(zigZagTimeDeltaOfDeltaMS << 2 | READINGS_TOKEN_READING, output + size);
+            size += encodeVarint(encodeZigZag(distanceDelta), output + size);
+        }
+    }
+
+    this->hasPreviousReading = true;
+    this->previousTimeMS = timeMS;
+    this->previousTimeDeltaMS = timeDeltaMS;
+    this->previousQuantizedDistance = quantizedDistance;
+
+    this->encodedReadingsCount++;
+    this->encodedBytesCount += size;
+
+    return size;
+}
+
+uint8_t ReadingsEncoder::encodePendingRun(uint8_t* output) {
+
+    if (this->pendingRunLength == 0)
+        return 0;
+
+    uint8_t size = encodeVarint(this->pendingRunLength << 2 | READINGS_TOKEN_RUN, output);
+
+    this->pendingRunLength = 0;
+
+    return size;
+}
+
+/**
+ * Will write the pending run of repeated readings. Call it before the output is closed.
+ *
+ * @param output At least READINGS_VARINT_MAX_SIZE bytes
+ * @return How many bytes were written in the output
+ */
+uint8_t ReadingsEncoder::flush(uint8_t* output) {
+
+    uint8_t size = this->encodePendingRun(output);
+
+    this->encodedBytesCount += size;
+
+    return size;
+}
+
+float ReadingsEncoder::getQuantum() const {
+    return this->quantum;
+}
+
+unsigned long ReadingsEncoder::getEncodedReadingsCount() const {
+    return this->encodedReadingsCount;
+}
+
+unsigned long ReadingsEncoder::getEncodedBytesCount() const {
+    return this->encodedBytesCount;
+}
+
+/**
+ * @return How many times less space the readings take, compared to a 4 byte time and a 4 byte float distance per reading
+ */
+float ReadingsEncoder::getCompressionRatio() const {
+    return this->encodedBytesCount == 0 ? 0 : static_cast<float>(this->encodedReadingsCount) * sizeof(Reading) / static_cast<float>(this->encodedBytesCount);
+}
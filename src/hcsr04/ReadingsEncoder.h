@@ -0,0 +1,90 @@
+#ifndef HC_SR04_READINGSENCODER_H
+#define HC_SR04_READINGSENCODER_H
+
+#include <stdint.h>
+#include "Reading.h"
+
+/*
+ * Format of compressed readings:
+ *
+ * Header: magic (1 byte), version (1 byte), quantum of the distance (4 bytes, little endian float)
+ * Tokens: varint, the low 2 bits are the kind of the token
+ *  - Reading:  zigzag(delta of the time delta) << 2 | 0, followed by the varint zigzag(delta of the quantized distance)
+ *  - Run:      count << 2 | 1. The given count of readings have the same time delta and the same distance as the previous one
+ *  - Restart:  2, followed by the varint time in milliseconds and the varint zigzag(quantized distance). The time delta starts from 0 again.
+ *
+ * The first reading is a restart. A restart is written too when the delta of the time delta doesn't fit in a token (a gap of days).
+ * Varints are little endian groups of 7 bits, where the high bit means that more bytes follow.
+ */
+#define READINGS_MAGIC 0xDC
+#define READINGS_VERSION 1
+#define READINGS_HEADER_SIZE 6
+
+#define READINGS_TOKEN_READING 0
+#define READINGS_TOKEN_RUN 1
+#define READINGS_TOKEN_RESTART 2
+
+#define READINGS_TOKEN_MAX_VALUE 0x3FFFFFFFUL
+#define READINGS_VARINT_MAX_SIZE 5
+
+/**
+ * The most bytes that a single encode() can write: the header, a pending run and a restart.
+ */
+#define READINGS_ENCODER_MAX_OUTPUT_SIZE (READINGS_HEADER_SIZE + 4 * READINGS_VARINT_MAX_SIZE)
+
+uint32_t encodeZigZag(const int32_t& value);
+
+int32_t decodeZigZag(const uint32_t& value);
+
+uint8_t encodeVarint(uint32_t value, uint8_t* output);
+
+/**
+ * Streaming compressor of readings. The state is a few numbers, so it has a small fixed RAM budget on the AVR.
+ *
+ * The distances are quantized (for example to 0.1 cm), the times are stored as delta of the delta (periodic readings have 0)
+ * and the readings that repeat the previous time delta and distance are counted in runs. A sensor that looks at an unchanged
+ * level, measured at a fixed period, costs a few bytes per thousands of readings.
+ */
+class ReadingsEncoder {
+
+private:
+
+    float quantum;
+
+    bool isHeaderWritten;
+    bool hasPreviousReading;
+    uint32_t previousTimeMS;
+    int32_t previousTimeDeltaMS;
+    int32_t previousQuantizedDistance;
+    uint32_t pendingRunLength;
+
+    unsigned long encodedReadingsCount;
+    unsigned long encodedBytesCount;
+
+    int32_t quantize(const float& distance) const;
+
+    uint8_t encodeHeader(uint8_t* output);
+
+    uint8_t encodeRestart(const uint32_t& timeMS, const int32_t& quantizedDistance, uint8_t* output);
+
+    uint8_t encodePendingRun(uint8_t* output);
+
+public:
+
+    ReadingsEncoder(const float& quantum);
+
+    uint8_t encode(const uint32_t& timeMS, const float& distance, uint8_t* output);
+
+    uint8_t flush(uint8_t* output);
+
+    float getQuantum() const;
+
+    unsigned long getEncodedReadingsCount() const;
+
+    unsigned long getEncodedBytesCount() const;
+
+    float getCompressionRatio() const;
+};
+
+
+#endif //HC_SR04_READINGSENCODER_H
@@ -0,0 +1,55 @@
+#ifndef HC_SR04_RESOLVEDMEASUREMENTCONFIGURATION_H
+#define HC_SR04_RESOLVEDMEASUREMENTCONFIGURATION_H
+
+#include <Arduino.h>
+#include "TemperatureUnits.h"
+#include "DistanceUnits.h"
+#include "SoundSpeed.h"
+
+/**
+ * A measurement configuration, where every parameter is present.
+ * It is the result of merging a MeasurementConfiguration with the defaults of the HCSR04 and what the measurement actually uses.
+ */
+struct ResolvedMeasurementConfiguration {
+
+    uint16_t samples;
+    DistanceUnit maxDistanceUnit;
+    TemperatureUnit temperatureUnit;
+    DistanceUnit measurementDistanceUnit;
+    float maxDistanceValue;
+    float temperatureValue;
+    uint32_t responseTimeoutMS;
+    uint32_t responseTimeoutCoolDownTimeMS;
+    uint32_t timeBudgetMS;
+    uint16_t minimumSamples;
+    float calibratedSoundSpeedCentimetersPerMicrosecond;
+
+    /**
+     * A calibrated sound speed replaces the one calculated by the temperature. 0 when the sensor is not calibrated.
+     *
+     * @return The sound speed that the measurement uses in centimeters per microsecond
+     */
+    float getSoundSpeedCentimetersPerMicrosecond() const {
+
+        if (this->calibratedSoundSpeedCentimetersPerMicrosecond > 0)
+            return this->calibratedSoundSpeedCentimetersPerMicrosecond;
+
+        return convertMetersPerSecondToCentimetersPerMicrosecond(calculateSoundSpeedByTemperature(this->temperatureValue, this->temperatureUnit));
+    }
+
+    /**
+     * The samples and the time limits are not compared, only the parameters that change the distance and the validity of the samples.
+     *
+     * @return If a measurement made with this configuration is a valid result for the other one
+     */
+    bool isCompatibleWith(const ResolvedMeasurementConfiguration& other) const {
+        return this->measurementDistanceUnit == other.measurementDistanceUnit
+               && this->maxDistanceUnit == other.maxDistanceUnit && this->maxDistanceValue == other.maxDistanceValue
+               && this->temperatureUnit == other.temperatureUnit && this->temperatureValue == other.temperatureValue
+               && this->calibratedSoundSpeedCentimetersPerMicrosecond == other.calibratedSoundSpeedCentimetersPerMicrosecond
+               && this->responseTimeoutMS == other.responseTimeoutMS;
+    }
+};
+
+
+#endif //HC_SR04_RESOLVEDMEASUREMENTCONFIGURATION_H
@@ -0,0 +1,140 @@
+#ifndef HC_SR04_SAMPLEQUEUE_H
+#define HC_SR04_SAMPLEQUEUE_H
+
+#include <Arduino.h>
+
+/**
+ * Wait-free single producer / single consumer ring buffer.
+ *
+ * Meant to move completed samples from an interrupt (the producer) to the main loop (the consumer) without disabling the interrupts.
+ * Only the producer writes the head and only the consumer writes the tail. The indexes are single bytes, so their loads and stores are atomic on the AVR too.
+ * The record is published with a release store of the head and claimed with an acquire load of it (and the same for the tail in the opposite direction).
+ *
+ * If the queue is full, the new record is dropped and counted.
+ *
+ * @tparam T The record. Should be small and trivially copyable, for example EchoSample
+ * @tparam CAPACITY Power of two between 2 and 128
+ */
+template<typename T, uint8_t CAPACITY>
+class SampleQueue {
+
+    static_assert(CAPACITY >= 2 && CAPACITY <= 128 && (CAPACITY & (CAPACITY - 1)) == 0, "The capacity must be a power of two between 2 and 128");
+
+private:
+
+    T records[CAPACITY];
+
+    uint8_t head;
+    uint8_t tail;
+
+    unsigned long pushedCount;
+    unsigned long droppedCount;
+
+    static uint8_t loadAcquire(const uint8_t& index) {
+        return __atomic_load_n(&index, __ATOMIC_ACQUIRE);
+    }
+
+    static void storeRelease(uint8_t& index, const uint8_t& value) {
+        __atomic_store_n(&index, value, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * The counters are written only by the producer. On the AVR they are wider than a byte, so they are read until two reads match.
+     */
+    static unsigned long loadCounter(const unsigned long& counter) {
+#if defined(__AVR__)
+        const volatile unsigned long& volatileCounter = counter;
+        unsigned long value;
+
+        do {
+            value = volatileCounter;
+        } while (value != volatileCounter);
+
+        return value;
+#else
+        return __atomic_load_n(&counter, __ATOMIC_RELAXED);
+#endif
+    }
+
+    static void incrementCounter(unsigned long& counter) {
+#if defined(__AVR__)
+        volatile unsigned long& volatileCounter = counter;
+        volatileCounter = volatileCounter + 1;
+#else
+        __atomic_store_n(&counter, __atomic_load_n(&counter, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+#endif
+    }
+
+public:
+
+    SampleQueue() : head(0), tail(0), pushedCount(0), droppedCount(0) {
+    }
+
+    /**
+     * Producer only.
+     *
+     * @return If the record was added. False if the queue was full and the record was dropped.
+     */
+    bool push(const T& record) {
+
+        uint8_t currentHead = this->head;
+
+        if (static_cast<uint8_t>(currentHead - loadAcquire(this->tail)) == CAPACITY) {
+            incrementCounter(this->droppedCount);
+            return false;
+        }
+
+        this->records[currentHead & (CAPACITY - 1)] = record;
+        storeRelease(this->head, static_cast<uint8_t>(currentHead + 1));
+        incrementCounter(this->pushedCount);
+
+        return true;
+    }
+
+    /**
+     * Consumer only.
+     *
+     * @return If there was a record. False if the queue was empty.
+     */
+    bool pop(T& record) {
+
+        uint8_t currentTail = this->tail;
+
+        if (currentTail == loadAcquire(this->head))
+            return false;
+
+        record = this->records[currentTail & (CAPACITY - 1)];
+        storeRelease(this->tail, static_cast<uint8_t>(currentTail + 1));
+
+        return true;
+    }
+
+    /**
+     * @return How many records are waiting. Exact only when called from the producer or the consumer.
+     */
+    uint8_t size() const {
+        return static_cast<uint8_t>(loadAcquire(this->head) - loadAcquire(this->tail));
+    }
+
+    bool isEmpty() const {
+        return this->size() == 0;
+    }
+
+    uint8_t capacity() const {
+        return CAPACITY;
+    }
+
+    unsigned long getPushedCount() const {
+        return loadCounter(this->pushedCount);
+    }
+
+    /**
+     * @return How many records were dropped, because the queue was full
+     */
+    unsigned long getDroppedCount() const {
+        return loadCounter(this->droppedCount);
+    }
+};
+
+
+#endif //HC_SR04_SAMPLEQUEUE_H
@@ -0,0 +1,27 @@
+#ifndef HC_SR04_SCANSERVO_H
+#define HC_SR04_SCANSERVO_H
+
+/**
+ * The servo, which turns the sensor for the SweepScanner.
+ *
+ * On a board it wraps the Servo library:
+ *
+ * class ArduinoScanServo : public ScanServo {
+ *     Servo& servo;
+ * public:
+ *     ArduinoScanServo(Servo& servo) : servo(servo) {}
+ *     void setAngleDegrees(const float& angleDegrees) override { this->servo.write(static_cast<int>(angleDegrees + 0.5f)); }
+ * };
+ */
+class ScanServo {
+
+public:
+
+    /**
+     * Will start turning to the angle. The SweepScanner waits for the servo to settle.
+     */
+    virtual void setAngleDegrees(const float& angleDegrees) = 0;
+};
+
+
+#endif //HC_SR04_SCANSERVO_H
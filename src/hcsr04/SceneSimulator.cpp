@@ -0,0 +1,343 @@
+#include "SceneSimulator.h"
+#include "SimulatedSensor.h"
+#include "SoundSpeed.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define SCENARIO_LINE_MAX_LENGTH 64
+#define SCENARIO_LINE_MAX_NUMBERS 5
+
+SceneSimulator::SceneSimulator() {
+    this->timeUS = 0;
+    this->temperatureCelsius = 25.00f;
+    this->temperatureDriftCelsiusPerHour = 0;
+    this->missedEchoProbability = 0;
+    this->ghostEchoProbability = 0;
+    this->crosstalkProbability = 0;
+    this->randomState = 1;
+    this->targetsCount = 0;
+    this->sensorsCount = 0;
+}
+
+/**
+ * Will parse one line of a scenario. Empty lines and lines starting with # are ignored.
+ *
+ * @return If the line was valid
+ */
+bool SceneSimulator::parseScenarioLine(const char* line) {
+
+    char keyword[16];
+    float numbers[SCENARIO_LINE_MAX_NUMBERS];
+    uint8_t numbersCount = 0;
+
+    while (*line == ' ' || *line == '\t')
+        line++;
+
+    if (*line == '\0' || *line == '#' || *line == '\r')
+        return true;
+
+    uint8_t keywordLength = 0;
+
+    while (*line != '\0' && *line != ' ' && *line != '\t' && keywordLength < sizeof(keyword) - 1)
+        keyword[keywordLength++] = *line++;
+
+    keyword[keywordLength] = '\0';
+
+    TargetMotion motion = TargetMotion::STATIC;
+    bool isTarget = strcmp(keyword, "target") == 0;
+
+    if (isTarget) {
+
+        while (*line == ' ' || *line == '\t')
+            line++;
+
+        if (strncmp(line, "static", 6) == 0)
+            motion = TargetMotion::STATIC;
+        else if (strncmp(line, "linear", 6) == 0)
+            motion = TargetMotion::LINEAR;
+        else if (strncmp(line, "oscillating", 11) == 0)
+            motion = TargetMotion::OSCILLATING;
+        else
+            return false;
+
+        while (*line != '\0' && *line != ' ' && *line != '\t')
+            line++;
+    }
+
+    while (numbersCount < SCENARIO_LINE_MAX_NUMBERS) {
+        char* numberEnd;
+        float number = static_cast<float>(strtod(line, &numberEnd));
+
+        if (numberEnd == line)
+            break;
+
+        numbers[numbersCount++] = number;
+        line = numberEnd;
+    }
+
+    if (isTarget) {
+        SceneTarget target = {motion, 0, 0, 0, 0, 0};
+
+        if (motion == TargetMotion::STATIC && numbersCount == 2)
+            target = {motion, numbers[0], 0, 0, 0, numbers[1]};
+        else if (motion == TargetMotion::LINEAR && numbersCount == 3)
+            target = {motion, numbers[0], numbers[1], 0, 0, numbers[2]};
+        else if (motion == TargetMotion::OSCILLATING && numbersCount == 4)
+            target = {motion, numbers[0], 0, numbers[1], static_cast<unsigned long>(numbers[2]), numbers[3]};
+        else
+            return false;
+
+        return this->addTarget(target) != -1;
+    }
+
+    if (strcmp(keyword, "seed") == 0 && numbersCount == 1)
+        this->setSeed(static_cast<uint32_t>(numbers[0]));
+    else if (strcmp(keyword, "temperature") == 0 && (numbersCount == 1 || numbersCount == 2))
+        this->setTemperature(numbers[0], numbersCount == 2 ? numbers[1] : 0);
+    else if (strcmp(keyword, "missed") == 0 && numbersCount == 1)
+        this->setMissedEchoProbability(numbers[0]);
+    else if (strcmp(keyword, "ghost") == 0 && numbersCount == 1)
+        this->setGhostEchoProbability(numbers[0]);
+    else if (strcmp(keyword, "crosstalk") == 0 && numbersCount == 1)
+        this->setCrosstalkProbability(numbers[0]);
+    else
+        return false;
+
+    return true;
+}
+
+/**
+ * Will load the scenario from text. The targets of the scenario are added to the existing ones.
+ * See the description of the class for the format.
+ *
+ * @return If all of the lines were valid. The loading stops at the first invalid line.
+ */
+bool SceneSimulator::loadScenario(const char* scenario) {
+
+    char line[SCENARIO_LINE_MAX_LENGTH];
+
+    while (*scenario != '\0') {
+
+        uint8_t lineLength = 0;
+
+        while (*scenario != '\0' && *scenario != '\n') {
+
+            if (lineLength < SCENARIO_LINE_MAX_LENGTH - 1)
+                line[lineLength++] = *scenario;
+
+            scenario++;
+        }
+
+        if (*scenario == '\n')
+            scenario++;
+
+        line[lineLength] = '\0';
+
+        if (!this->parseScenarioLine(line))
+            return false;
+    }
+
+    return true;
+}
+
+void SceneSimulator::setSeed(const uint32_t& seed) {
+    this->randomState = seed == 0 ? 1 : seed;
+}
+
+/**
+ * @param temperatureCelsius The temperature at the start of the simulation
+ * @param temperatureDriftCelsiusPerHour How the temperature changes with the time
+ */
+void SceneSimulator::setTemperature(const float& temperatureCelsius, const float& temperatureDriftCelsiusPerHour) {
+    this->temperatureCelsius = temperatureCelsius;
+    this->temperatureDriftCelsiusPerHour = temperatureDriftCelsiusPerHour;
+}
+
+/**
+ * The probability that an echo doesn't return at all (the sensor reports its 38 ms no echo signal).
+ */
+void SceneSimulator::setMissedEchoProbability(const float& missedEchoProbability) {
+    this->missedEchoProbability = missedEchoProbability;
+}
+
+/**
+ * The probability that the echo comes after bouncing twice (multipath), which doubles the distance.
+ */
+void SceneSimulator::setGhostEchoProbability(const float& ghostEchoProbability) {
+    this->ghostEchoProbability = ghostEchoProbability;
+}
+
+/**
+ * The probability that a sensor receives the echo of another sensor, which is in flight during its ping.
+ */
+void SceneSimulator::setCrosstalkProbability(const float& crosstalkProbability) {
+    this->crosstalkProbability = crosstalkProbability;
+}
+
+float SceneSimulator::getMissedEchoProbability() const {
+    return this->missedEchoProbability;
+}
+
+float SceneSimulator::getGhostEchoProbability() const {
+    return this->ghostEchoProbability;
+}
+
+float SceneSimulator::getCrosstalkProbability() const {
+    return this->crosstalkProbability;
+}
+
+/**
+ * @return The index of the target. -1 If there is no more space for targets.
+ */
+int SceneSimulator::addTarget(const SceneTarget& target) {
+
+    if (this->targetsCount >= MAX_SCENE_TARGETS)
+        return -1;
+
+    this->targets[this->targetsCount] = target;
+
+    return this->targetsCount++;
+}
+
+void SceneSimulator::clearTargets() {
+    this->targetsCount = 0;
+}
+
+SceneTarget& SceneSimulator::getTarget(const uint8_t& index) {
+    return this->targets[index];
+}
+
+uint8_t SceneSimulator::getTargetsCount() const {
+    return this->targetsCount;
+}
+
+/**
+ * Called by the simulated sensors, so they know about each other's echoes.
+ *
+ * @return The index of the sensor in the scene. -1 If there is no more space for sensors.
+ */
+int SceneSimulator::addSensor(SimulatedSensor& sensor) {
+
+    if (this->sensorsCount >= MAX_SCENE_SENSORS)
+        return -1;
+
+    this->sensors[this->sensorsCount] = &sensor;
+    this->pingTimesUS[this->sensorsCount] = 0;
+    this->pingEchoesUS[this->sensorsCount] = 0;
+
+    return this->sensorsCount++;
+}
+
+/**
+ * @return The distance of the target at the current time of the scene
+ */
+float SceneSimulator::getTargetDistanceCM(const uint8_t& index) const {
+
+    const SceneTarget& target = this->targets[index];
+    float timeMS = static_cast<float>(this->timeUS / 1000);
+
+    switch (target.motion) {
+
+        case TargetMotion::LINEAR: {
+            float distanceCM = target.distanceCM + target.velocityCMPerSecond * timeMS / 1000.00f;
+            return distanceCM < 0 ? 0 : distanceCM;
+        }
+
+        case TargetMotion::OSCILLATING: {
+            if (target.periodMS == 0)
+                return target.distanceCM;
+
+            float phase = static_cast<float>((this->timeUS / 1000) % target.periodMS) / static_cast<float>(target.periodMS);
+            return target.distanceCM + target.amplitudeCM * sinf(6.2831853f * phase);
+        }
+
+        default:
+            return target.distanceCM;
+    }
+}
+
+/**
+ * @return The temperature at the current time of the scene
+ */
+float SceneSimulator::getTemperatureCelsius() const {
+    float hours = static_cast<float>(this->timeUS / 1000) / 3600000.00f;
+    return this->temperatureCelsius + this->temperatureDriftCelsiusPerHour * hours;
+}
+
+/**
+ * @return The real speed of the sound in the scene, which depends on its current temperature
+ */
+float SceneSimulator::getSoundSpeedCentimetersPerMicrosecond() const {
+    return convertMetersPerSecondToCentimetersPerMicrosecond(calculateSoundSpeedByTemperature(this->getTemperatureCelsius(), TemperatureUnit::CELSIUS));
+}
+
+/**
+ * Xorshift random generator, so the simulation is the same on every platform.
+ *
+ * @return Random number between 0 (inclusive) and 1 (exclusive)
+ */
+float SceneSimulator::nextRandom() {
+
+    this->randomState ^= this->randomState << 13;
+    this->randomState ^= this->randomState >> 17;
+    this->randomState ^= this->randomState << 5;
+
+    return static_cast<float>(this->randomState >> 8) / 16777216.00f;
+}
+
+uint64_t SceneSimulator::getTimeUS() const {
+    return this->timeUS;
+}
+
+void SceneSimulator::advanceTimeUS(const uint64_t& durationUS) {
+    this->timeUS += durationUS;
+}
+
+/**
+ * Will remember the last ping of the sensor, so the other sensors can receive its sound as crosstalk.
+ *
+ * @param echoUS The length of its echo. 0 If the ping had no echo, so there is no sound in flight
+ */
+void SceneSimulator::setPing(const uint8_t& sensorIndex, const uint64_t& pingTimeUS, const unsigned long& echoUS) {
+    this->pingTimesUS[sensorIndex] = pingTimeUS;
+    this->pingEchoesUS[sensorIndex] = echoUS;
+}
+
+/**
+ * Will find the earliest sound of another sensor's ping, which arrives during the given echo window, starting now.
+ * The sound arrives after each multiple of the echo of that ping, until SCENE_REVERBERATIONS.
+ *
+ * @param sensorIndex The sensor that is pinging
+ * @param maxEchoUS The echo window of the sensor
+ * @param crosstalkEchoUS Will be filled with the time after which the other echo arrives
+ * @return If there was such echo
+ */
+bool SceneSimulator::findCrosstalkEchoUS(const uint8_t& sensorIndex, const unsigned long& maxEchoUS, unsigned long& crosstalkEchoUS) {
+
+    bool isFound = false;
+
+    for (uint8_t i = 0; i < this->sensorsCount; i++) {
+
+        if (i == sensorIndex || this->pingEchoesUS[i] == 0)
+            continue;
+
+        for (uint8_t reverberation = 1; reverberation <= SCENE_REVERBERATIONS; reverberation++) {
+            uint64_t arrivalTimeUS = this->pingTimesUS[i] + static_cast<uint64_t>(this->pingEchoesUS[i]) * reverberation;
+
+            if (arrivalTimeUS <= this->timeUS)
+                continue;
+
+            uint64_t echoUS = arrivalTimeUS - this->timeUS;
+
+            if (echoUS < maxEchoUS && (!isFound || echoUS < crosstalkEchoUS)) {
+                crosstalkEchoUS = static_cast<unsigned long>(echoUS);
+                isFound = true;
+            }
+
+            break;
+        }
+    }
+
+    return isFound;
+}
@@ -0,0 +1,130 @@
+#ifndef HC_SR04_SCENESIMULATOR_H
+#define HC_SR04_SCENESIMULATOR_H
+
+#include <Arduino.h>
+
+#define MAX_SCENE_TARGETS 4
+#define MAX_SCENE_SENSORS 4
+#define SCENE_REVERBERATIONS 3
+
+class SimulatedSensor;
+
+enum class TargetMotion : uint8_t {
+    STATIC, LINEAR, OSCILLATING
+};
+
+/**
+ * A reflecting object in the scene.
+ *
+ * STATIC: stays at the distance
+ * LINEAR: moves with the velocity (cm/s) from the distance
+ * OSCILLATING: moves around the distance with the amplitude (cm) and the period (ms)
+ */
+struct SceneTarget {
+
+    TargetMotion motion;
+    float distanceCM;
+    float velocityCMPerSecond;
+    float amplitudeCM;
+    unsigned long periodMS;
+    float bearingDegrees;
+};
+
+/**
+ * Acoustic scene with a virtual clock, which drives simulated sensors (SimulatedSensor) that are used as HCSR04 backends.
+ * Nothing is actually waited, so the unmodified HCSR04 code runs far faster than in real time.
+ *
+ * It models moving targets, the beam angle of the sensors, missed echoes, multipath (ghost) echoes at double the distance,
+ * crosstalk between sensors that ping one after another and the drift of the temperature (the real sound speed).
+ * The sound of a ping keeps bouncing between the sensors and the targets after its echo was received, so it arrives again
+ * after each multiple of its echo, up to SCENE_REVERBERATIONS times. A sensor, which pings while the sound of another one is still in flight,
+ * can receive it as its own echo (crosstalk).
+ * The randomness comes from a seeded generator, so the same scenario always gives the same echoes.
+ *
+ * A scenario can be loaded from text, one parameter per line:
+ *
+ * seed 42
+ * temperature 20 0.5          (celsius, drift in celsius per hour)
+ * missed 0.02                 (probabilities of the echo effects)
+ * ghost 0.05
+ * crosstalk 0.3
+ * target static 300 -20       (distance cm, bearing degrees)
+ * target linear 150 -10 0     (distance cm, velocity cm/s, bearing degrees)
+ * target oscillating 100 20 2000 10   (distance cm, amplitude cm, period ms, bearing degrees)
+ */
+class SceneSimulator {
+
+private:
+
+    uint64_t timeUS;
+
+    float temperatureCelsius;
+    float temperatureDriftCelsiusPerHour;
+
+    float missedEchoProbability;
+    float ghostEchoProbability;
+    float crosstalkProbability;
+
+    uint32_t randomState;
+
+    SceneTarget targets[MAX_SCENE_TARGETS];
+    uint8_t targetsCount;
+
+    SimulatedSensor* sensors[MAX_SCENE_SENSORS];
+    uint64_t pingTimesUS[MAX_SCENE_SENSORS];
+    unsigned long pingEchoesUS[MAX_SCENE_SENSORS];
+    uint8_t sensorsCount;
+
+    bool parseScenarioLine(const char* line);
+
+public:
+
+    SceneSimulator();
+
+    bool loadScenario(const char* scenario);
+
+    void setSeed(const uint32_t& seed);
+
+    void setTemperature(const float& temperatureCelsius, const float& temperatureDriftCelsiusPerHour);
+
+    void setMissedEchoProbability(const float& missedEchoProbability);
+
+    void setGhostEchoProbability(const float& ghostEchoProbability);
+
+    void setCrosstalkProbability(const float& crosstalkProbability);
+
+    float getMissedEchoProbability() const;
+
+    float getGhostEchoProbability() const;
+
+    float getCrosstalkProbability() const;
+
+    int addTarget(const SceneTarget& target);
+
+    void clearTargets();
+
+    SceneTarget& getTarget(const uint8_t& index);
+
+    uint8_t getTargetsCount() const;
+
+    int addSensor(SimulatedSensor& sensor);
+
+    float getTargetDistanceCM(const uint8_t& index) const;
+
+    float getTemperatureCelsius() const;
+
+    float getSoundSpeedCentimetersPerMicrosecond() const;
+
+    float nextRandom();
+
+    uint64_t getTimeUS() const;
+
+    void advanceTimeUS(const uint64_t& durationUS);
+
+    void setPing(const uint8_t& sensorIndex, const uint64_t& pingTimeUS, const unsigned long& echoUS);
+
+    bool findCrosstalkEchoUS(const uint8_t& sensorIndex, const unsigned long& maxEchoUS, unsigned long& crosstalkEchoUS);
+};
+
+
+#endif //HC_SR04_SCENESIMULATOR_H
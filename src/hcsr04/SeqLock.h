@@ -0,0 +1,152 @@
+#ifndef HC_SR04_SEQLOCK_H
+#define HC_SR04_SEQLOCK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * The widest word, which the alignment of the value allows. The value is copied word by word.
+ */
+template<size_t ALIGNMENT>
+struct SeqLockWord {
+    typedef uint8_t Type;
+};
+
+template<>
+struct SeqLockWord<2> {
+    typedef uint16_t Type;
+};
+
+template<>
+struct SeqLockWord<4> {
+    typedef uint32_t Type;
+};
+
+template<>
+struct SeqLockWord<8> {
+    typedef uint64_t Type;
+};
+
+/**
+ * Single writer / many readers publication of a value, without locks.
+ *
+ * The writer makes the sequence odd, writes the value and makes the sequence even again. A reader copies the value between two loads
+ * of the sequence and keeps the copy only if both loads are the same even number, otherwise the writer was in the middle of a write.
+ * The writer never waits for the readers, and the readers never write, so the SeqLock can be placed in memory that is shared read only.
+ *
+ * The value is copied word by word (as wide as its alignment allows) with atomic release stores and acquire loads, so a read that races
+ * with a write is not a data race and needs no fences (which TSAN doesn't understand). A reader that sees any word of a newer write
+ * also sees the odd sequence, which is stored before it. On x86 these are plain moves.
+ * On the AVR the sequence and the words are single bytes, so their loads and stores are atomic. There the writer is usually an interrupt, which can't be interrupted by the reader.
+ *
+ * @tparam T The value. Must be trivially copyable, for example Measurement
+ */
+template<typename T>
+class SeqLock {
+
+    static_assert(__is_trivially_copyable(T), "The value of a SeqLock must be trivially copyable");
+
+public:
+
+#if defined(__AVR__)
+    //A byte, so its loads and stores stay atomic. It wraps around after 128 writes
+    typedef uint8_t Sequence;
+#else
+    typedef uint32_t Sequence;
+#endif
+
+private:
+
+    typedef typename SeqLockWord<__alignof__(T)>::Type Word;
+
+    static const size_t WORDS_COUNT = sizeof(T) / sizeof(Word);
+
+    Sequence sequence;
+    Word value[WORDS_COUNT];
+
+public:
+
+    SeqLock() : sequence(0), value() {
+    }
+
+    /**
+     * Writer only. There must be a single writer at a time.
+     */
+    void write(const T& newValue) {
+
+        Sequence currentSequence = __atomic_load_n(&this->sequence, __ATOMIC_RELAXED);
+        const unsigned char* source = reinterpret_cast<const unsigned char*>(&newValue);
+
+        __atomic_store_n(&this->sequence, static_cast<Sequence>(currentSequence + 1), __ATOMIC_RELAXED);
+
+        for (size_t i = 0; i < WORDS_COUNT; i++) {
+            Word word;
+            memcpy(&word, source + i * sizeof(Word), sizeof(Word));
+            __atomic_store_n(&this->value[i], word, __ATOMIC_RELEASE);
+        }
+
+        __atomic_store_n(&this->sequence, static_cast<Sequence>(currentSequence + 2), __ATOMIC_RELEASE);
+    }
+
+    /**
+     * A single attempt to read the value.
+     *
+     * @param readValue Will be filled with the value. It is consistent only when true is returned
+     * @return If the value wasn't written during the read
+     */
+    bool tryRead(T& readValue) const {
+
+        Sequence startSequence = __atomic_load_n(&this->sequence, __ATOMIC_ACQUIRE);
+
+        if (startSequence & 1)
+            return false;
+
+        unsigned char* destination = reinterpret_cast<unsigned char*>(&readValue);
+
+        for (size_t i = 0; i < WORDS_COUNT; i++) {
+            Word word = __atomic_load_n(&this->value[i], __ATOMIC_ACQUIRE);
+            memcpy(destination + i * sizeof(Word), &word, sizeof(Word));
+        }
+
+        return __atomic_load_n(&this->sequence, __ATOMIC_RELAXED) == startSequence;
+    }
+
+    /**
+     * Will read until the value is consistent.
+     *
+     * @return How many attempts were needed
+     */
+    unsigned int read(T& readValue) const {
+
+        unsigned int attemptsCount = 1;
+
+        while (!this->tryRead(readValue))
+            attemptsCount++;
+
+        return attemptsCount;
+    }
+
+    /**
+     * @return The sequence grows by two with every write, so readers can know if there is a new value without copying it.
+     * It wraps around, so it is zero again after enough writes. Compare it only with != or isSequenceAfter()
+     */
+    Sequence getSequence() const {
+        return __atomic_load_n(&this->sequence, __ATOMIC_ACQUIRE);
+    }
+
+    /**
+     * Wrap-safe comparison of two sequences. Correct while they are less than half of the range of the Sequence apart.
+     *
+     * @return If the sequence was published after the other one
+     */
+    static bool isSequenceAfter(const Sequence& sequence, const Sequence& otherSequence) {
+
+        Sequence difference = static_cast<Sequence>(sequence - otherSequence);
+
+        return difference != 0 && difference <= static_cast<Sequence>(static_cast<Sequence>(~static_cast<Sequence>(0)) >> 1);
+    }
+};
+
+
+#endif //HC_SR04_SEQLOCK_H
@@ -0,0 +1,153 @@
+#include "SimulatedSensor.h"
+#include <math.h>
+
+SimulatedSensor::SimulatedSensor(SceneSimulator& scene, const float& headingDegrees) : SimulatedSensor(scene, headingDegrees, DEFAULT_SIMULATED_BEAM_HALF_ANGLE_DEGREES) {
+}
+
+/**
+ * @param scene The scene, which the sensor measures
+ * @param headingDegrees Where the sensor points. The targets have a bearing in the same degrees
+ * @param beamHalfAngleDegrees How far from the heading the sensor sees the targets
+ */
+SimulatedSensor::SimulatedSensor(SceneSimulator& scene, const float& headingDegrees, const float& beamHalfAngleDegrees) : scene(&scene), headingDegrees(headingDegrees), beamHalfAngleDegrees(beamHalfAngleDegrees) {
+    this->sceneIndex = scene.addSensor(*this);
+    this->pingsCount = 0;
+    this->missedEchoesCount = 0;
+    this->ghostEchoesCount = 0;
+    this->crosstalkEchoesCount = 0;
+}
+
+/**
+ * @param distanceCM Will be filled with the distance of the nearest target in the beam
+ * @return If there was a target in the beam
+ */
+bool SimulatedSensor::findNearestTargetDistanceCM(float& distanceCM) {
+
+    bool isFound = false;
+
+    for (uint8_t i = 0; i < this->scene->getTargetsCount(); i++) {
+
+        if (fabsf(this->scene->getTarget(i).bearingDegrees - this->headingDegrees) > this->beamHalfAngleDegrees)
+            continue;
+
+        float targetDistanceCM = this->scene->getTargetDistanceCM(i);
+
+        if (!isFound || targetDistanceCM < distanceCM) {
+            distanceCM = targetDistanceCM;
+            isFound = true;
+        }
+    }
+
+    return isFound;
+}
+
+/**
+ * The sound of the ping is given to the scene, even if this sensor misses its echo, so the other sensors can receive it as crosstalk.
+ *
+ * @return The length of the echo signal, after the missed/ghost/crosstalk effects of the scene
+ */
+unsigned long SimulatedSensor::calculateEchoUS() {
+
+    float distanceCM = 0;
+    bool isTargetFound = this->findNearestTargetDistanceCM(distanceCM);
+
+    bool isMissed = this->scene->nextRandom() < this->scene->getMissedEchoProbability();
+    bool isGhost = this->scene->nextRandom() < this->scene->getGhostEchoProbability();
+    bool isCrosstalk = this->scene->nextRandom() < this->scene->getCrosstalkProbability();
+
+    unsigned long echoUS = SIMULATED_NO_ECHO_SIGNAL_LENGTH_US;
+    unsigned long soundEchoUS = 0;
+
+    if (isTargetFound)
+        soundEchoUS = min(static_cast<unsigned long>(distanceCM * 2 / this->scene->getSoundSpeedCentimetersPerMicrosecond()), static_cast<unsigned long>(SIMULATED_NO_ECHO_SIGNAL_LENGTH_US));
+
+    if (!isTargetFound || isMissed) {
+        this->missedEchoesCount++;
+    } else {
+
+        if (isGhost) {
+            distanceCM *= 2;
+            this->ghostEchoesCount++;
+        }
+
+        echoUS = static_cast<unsigned long>(distanceCM * 2 / this->scene->getSoundSpeedCentimetersPerMicrosecond());
+        echoUS = min(echoUS, static_cast<unsigned long>(SIMULATED_NO_ECHO_SIGNAL_LENGTH_US));
+    }
+
+    unsigned long crosstalkEchoUS = 0;
+
+    if (this->sceneIndex != -1 && isCrosstalk && this->scene->findCrosstalkEchoUS(this->sceneIndex, echoUS, crosstalkEchoUS)) {
+        echoUS = crosstalkEchoUS;
+        this->crosstalkEchoesCount++;
+    }
+
+    if (this->sceneIndex != -1)
+        this->scene->setPing(this->sceneIndex, this->scene->getTimeUS(), soundEchoUS);
+
+    return echoUS;
+}
+
+/**
+ * Will simulate the ping. The virtual time moves forward with the length of the echo or the response timeout.
+ */
+HCSR04Response SimulatedSensor::ping(const unsigned long& responseTimeoutMS) {
+
+    this->pingsCount++;
+
+    unsigned long echoUS = this->calculateEchoUS();
+    unsigned long responseTimeoutUS = responseTimeoutMS * 1000;
+
+    if (echoUS > responseTimeoutUS) {
+        this->scene->advanceTimeUS(responseTimeoutUS);
+        return {0, true};
+    }
+
+    this->scene->advanceTimeUS(echoUS);
+    return {echoUS, false};
+}
+
+unsigned long SimulatedSensor::getTimeMS() {
+    return static_cast<unsigned long>(this->scene->getTimeUS() / 1000);
+}
+
+unsigned long SimulatedSensor::getTimeUS() {
+    return static_cast<unsigned long>(this->scene->getTimeUS());
+}
+
+void SimulatedSensor::delayMS(const unsigned long& delayMS) {
+    this->scene->advanceTimeUS(static_cast<uint64_t>(delayMS) * 1000);
+}
+
+/**
+ * Will turn the sensor, for example when it is mounted on a servo.
+ */
+void SimulatedSensor::setHeadingDegrees(const float& headingDegrees) {
+    this->headingDegrees = headingDegrees;
+}
+
+float SimulatedSensor::getHeadingDegrees() const {
+    return this->headingDegrees;
+}
+
+float SimulatedSensor::getBeamHalfAngleDegrees() const {
+    return this->beamHalfAngleDegrees;
+}
+
+unsigned long SimulatedSensor::getPingsCount() const {
+    return this->pingsCount;
+}
+
+/**
+ * @return How many pings didn't get an echo, because the echo was missed or there was no target in the beam
+ */
+unsigned long SimulatedSensor::getMissedEchoesCount() const {
+    return this->missedEchoesCount;
+}
+
+unsigned long SimulatedSensor::getGhostEchoesCount() const {
+    return this->ghostEchoesCount;
+}
+
+unsigned long SimulatedSensor::getCrosstalkEchoesCount() const {
+    return this->crosstalkEchoesCount;
+}
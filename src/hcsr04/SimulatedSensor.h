@@ -0,0 +1,69 @@
+#ifndef HC_SR04_SIMULATEDSENSOR_H
+#define HC_SR04_SIMULATEDSENSOR_H
+
+#include <Arduino.h>
+#include "HCSR04Backend.h"
+#include "SceneSimulator.h"
+
+#define DEFAULT_SIMULATED_BEAM_HALF_ANGLE_DEGREES 15.00f
+#define SIMULATED_NO_ECHO_SIGNAL_LENGTH_US 38000
+
+/**
+ * A HC-SR04 in a simulated scene. Used as the backend of a HCSR04, so the unmodified library code measures the scene.
+ *
+ * SceneSimulator scene;
+ * scene.loadScenario(scenario);
+ *
+ * SimulatedSensor simulatedSensor(scene, 0);
+ * HCSR04 hcsr04(simulatedSensor);
+ */
+class SimulatedSensor : public HCSR04Backend {
+
+private:
+
+    SceneSimulator* scene;
+    int sceneIndex;
+
+    float headingDegrees;
+    float beamHalfAngleDegrees;
+
+    unsigned long pingsCount;
+    unsigned long missedEchoesCount;
+    unsigned long ghostEchoesCount;
+    unsigned long crosstalkEchoesCount;
+
+    bool findNearestTargetDistanceCM(float& distanceCM);
+
+    unsigned long calculateEchoUS();
+
+public:
+
+    SimulatedSensor(SceneSimulator& scene, const float& headingDegrees);
+
+    SimulatedSensor(SceneSimulator& scene, const float& headingDegrees, const float& beamHalfAngleDegrees);
+
+    HCSR04Response ping(const unsigned long& responseTimeoutMS) override;
+
+    unsigned long getTimeMS() override;
+
+    unsigned long getTimeUS() override;
+
+    void delayMS(const unsigned long& delayMS) override;
+
+    void setHeadingDegrees(const float& headingDegrees);
+
+    float getHeadingDegrees() const;
+
+    float getBeamHalfAngleDegrees() const;
+
+    unsigned long getPingsCount() const;
+
+    unsigned long getMissedEchoesCount() const;
+
+    unsigned long getGhostEchoesCount() const;
+
+    unsigned long getCrosstalkEchoesCount() const;
+};
+
+
+#endif //HC_SR04_SIMULATEDSENSOR_H
@@ -0,0 +1,28 @@
+#ifndef HC_SR04_SNAPSHOTSTORAGE_H
+#define HC_SR04_SNAPSHOTSTORAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Where the HCSR04SnapshotKeeper keeps the snapshots. For example the EEPROM (EEPROMSnapshotStorage) or a file on the host.
+ */
+class SnapshotStorage {
+
+public:
+
+    /**
+     * @return How many bytes the storage has
+     */
+    virtual size_t getLength() = 0;
+
+    virtual void read(const size_t& address, uint8_t* data, const size_t& length) = 0;
+
+    /**
+     * Should write only the bytes that are different, so the same data doesn't wear the storage.
+     */
+    virtual void write(const size_t& address, const uint8_t* data, const size_t& length) = 0;
+};
+
+
+#endif //HC_SR04_SNAPSHOTSTORAGE_H
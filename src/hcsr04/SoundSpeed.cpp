@@ -0,0 +1,26 @@
+#include "SoundSpeed.h"
+
+/**
+ * The speed of sound in air is dependent on the temperature & other factors such as air pressure and humidity.
+ * The temperature plays more important role that the other two.
+ *
+ * https://www.engineeringtoolbox.com/air-speed-sound-d_603.html
+ *
+ * @param temperature The ambient temperature
+ * @param temperatureUnit The unit of the temperature
+ * @return The speed of sound in m/s
+ */
+float calculateSoundSpeedByTemperature(const float& temperature, const TemperatureUnit& temperatureUnit) {
+    float temperatureInCelsius = convertTemperatureUnit(temperature, temperatureUnit, TemperatureUnit::CELSIUS);
+    return 331.0f + (0.6f * temperatureInCelsius);
+}
+
+/**
+ * Will convert meters per second to centimeters per microsecond/
+ *
+ * @param metersPerSecond The meters per second that will be converted
+ * @return The converted meters per second into centimeters per microsecond
+ */
+float convertMetersPerSecondToCentimetersPerMicrosecond(const float& metersPerSecond) {
+    return metersPerSecond * 0.0001f;
+}
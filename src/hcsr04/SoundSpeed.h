@@ -0,0 +1,10 @@
+#ifndef HC_SR04_SOUNDSPEED_H
+#define HC_SR04_SOUNDSPEED_H
+
+#include "TemperatureUnits.h"
+
+float calculateSoundSpeedByTemperature(const float& temperature, const TemperatureUnit& temperatureUnit);
+
+float convertMetersPerSecondToCentimetersPerMicrosecond(const float& metersPerSecond);
+
+#endif //HC_SR04_SOUNDSPEED_H
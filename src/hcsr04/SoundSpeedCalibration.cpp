@@ -0,0 +1,67 @@
+#include "SoundSpeedCalibration.h"
+#include <EEPROM.h>
+
+/**
+ * @return The bytes of the sound speed summed together with the magic
+ */
+static uint8_t calculateSoundSpeedCalibrationChecksum(const SoundSpeedCalibrationRecord& record) {
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record.soundSpeedCentimetersPerMicrosecond);
+    uint8_t checksum = record.magic;
+
+    for (size_t i = 0; i < sizeof(record.soundSpeedCentimetersPerMicrosecond); i++)
+        checksum = static_cast<uint8_t>(checksum + bytes[i]);
+
+    return static_cast<uint8_t>(~checksum);
+}
+
+/**
+ * The sound speed changes with ~0.2% per degree and the sensors have a small constant delay of the echo,
+ * so a calibration outside the speeds between ~-40°C and ~+60°C means that the known distance or the target was wrong.
+ *
+ * @return If the sound speed can be a result of a correct calibration
+ */
+bool isCalibratedSoundSpeedPlausible(const float& soundSpeedCentimetersPerMicrosecond) {
+    return soundSpeedCentimetersPerMicrosecond >= MIN_CALIBRATED_SOUND_SPEED_CM_PER_US
+           && soundSpeedCentimetersPerMicrosecond <= MAX_CALIBRATED_SOUND_SPEED_CM_PER_US;
+}
+
+/**
+ * Will keep the sound speed in the EEPROM. Only the changed bytes are written, so saving the same calibration again doesn't wear it.
+ *
+ * @param address Where the record starts. It takes sizeof(SoundSpeedCalibrationRecord) bytes
+ * @return If the sound speed was plausible and written
+ */
+bool writeSoundSpeedCalibration(const int& address, const float& soundSpeedCentimetersPerMicrosecond) {
+
+    if (!isCalibratedSoundSpeedPlausible(soundSpeedCentimetersPerMicrosecond))
+        return false;
+
+    SoundSpeedCalibrationRecord record = {SOUND_SPEED_CALIBRATION_MAGIC, soundSpeedCentimetersPerMicrosecond, 0};
+    record.checksum = calculateSoundSpeedCalibrationChecksum(record);
+
+    EEPROM.put(address, record);
+
+    return true;
+}
+
+/**
+ * @param address Where the record starts
+ * @param soundSpeedCentimetersPerMicrosecond Will be set to the calibrated sound speed. Not changed if there is no valid calibration
+ * @return If there was a valid calibration at the address
+ */
+bool readSoundSpeedCalibration(const int& address, float& soundSpeedCentimetersPerMicrosecond) {
+
+    SoundSpeedCalibrationRecord record;
+    EEPROM.get(address, record);
+
+    if (record.magic != SOUND_SPEED_CALIBRATION_MAGIC || record.checksum != calculateSoundSpeedCalibrationChecksum(record))
+        return false;
+
+    if (!isCalibratedSoundSpeedPlausible(record.soundSpeedCentimetersPerMicrosecond))
+        return false;
+
+    soundSpeedCentimetersPerMicrosecond = record.soundSpeedCentimetersPerMicrosecond;
+
+    return true;
+}
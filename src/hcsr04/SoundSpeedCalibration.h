@@ -0,0 +1,25 @@
+#ifndef HC_SR04_SOUNDSPEEDCALIBRATION_H
+#define HC_SR04_SOUNDSPEEDCALIBRATION_H
+
+#include <Arduino.h>
+
+#define SOUND_SPEED_CALIBRATION_MAGIC 0xC5
+#define MIN_CALIBRATED_SOUND_SPEED_CM_PER_US 0.0300f
+#define MAX_CALIBRATED_SOUND_SPEED_CM_PER_US 0.0380f
+
+/**
+ * How a calibrated sound speed is kept in the EEPROM. The magic and the checksum tell if the bytes are a calibration at all.
+ */
+struct SoundSpeedCalibrationRecord {
+    uint8_t magic;
+    float soundSpeedCentimetersPerMicrosecond;
+    uint8_t checksum;
+};
+
+bool isCalibratedSoundSpeedPlausible(const float& soundSpeedCentimetersPerMicrosecond);
+
+bool writeSoundSpeedCalibration(const int& address, const float& soundSpeedCentimetersPerMicrosecond);
+
+bool readSoundSpeedCalibration(const int& address, float& soundSpeedCentimetersPerMicrosecond);
+
+#endif //HC_SR04_SOUNDSPEEDCALIBRATION_H
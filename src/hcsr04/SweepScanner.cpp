@@ -0,0 +1,179 @@
+#include "SweepScanner.h"
+
+/**
+ * @param startAngleDegrees The first angle of the servo
+ * @param endAngleDegrees The last angle of the servo. Can be smaller than the start
+ * @param stepAngleDegrees The angle between two readings. Usually about the half of the beam angle of the sensor
+ */
+SweepScanner::SweepScanner(HCSR04& hcsr04, ScanServo& servo, const float& startAngleDegrees, const float& endAngleDegrees, const float& stepAngleDegrees) : hcsr04(hcsr04), servo(servo) {
+    this->startAngleDegrees = startAngleDegrees;
+    this->stepAngleDegrees = endAngleDegrees >= startAngleDegrees ? fabsf(stepAngleDegrees) : -fabsf(stepAngleDegrees);
+    this->anglesCount = this->stepAngleDegrees == 0 ? 1 : static_cast<uint16_t>((endAngleDegrees - startAngleDegrees) / this->stepAngleDegrees + 0.5f) + 1;
+    this->settleTimeMS = DEFAULT_SWEEP_SETTLE_TIME_MS;
+    this->settleTimeMSPerDegree = DEFAULT_SWEEP_SETTLE_TIME_MS_PER_DEGREE;
+    this->minSamples = DEFAULT_SWEEP_MIN_SAMPLES;
+    this->maxSamples = DEFAULT_SWEEP_MAX_SAMPLES;
+    this->agreementCM = DEFAULT_SWEEP_AGREEMENT_CENTIMETERS;
+    this->sweepPosition = 0;
+    this->isSweepReversed = false;
+    this->servoAngleDegrees = 0;
+    this->isServoPositioned = false;
+    this->sweepStartTimeMS = 0;
+    this->lastSweepDurationMS = 0;
+    this->lastSweepSamplesCount = 0;
+    this->sweepSamplesCount = 0;
+}
+
+/**
+ * The servo needs the base time for any step and the time per degree for the distance it turns.
+ *
+ * @param settleTimeMS For example ~15ms for a hobby servo
+ * @param settleTimeMSPerDegree For example ~2ms per degree for a SG90 (0.1s per 60 degrees) with some margin
+ */
+void SweepScanner::setSettleTime(const unsigned long& settleTimeMS, const float& settleTimeMSPerDegree) {
+    this->settleTimeMS = settleTimeMS;
+    this->settleTimeMSPerDegree = settleTimeMSPerDegree;
+}
+
+/**
+ * @param minSamples The samples that each angle takes
+ * @param maxSamples The samples that an angle can take, when its min samples disagree
+ * @param agreementValue How much the valid samples can differ (max - min) before more are taken
+ */
+void SweepScanner::setAdaptiveSamples(const uint8_t& minSamples, const uint8_t& maxSamples, const float& agreementValue, const DistanceUnit& agreementUnit) {
+    this->minSamples = max(minSamples, static_cast<uint8_t>(1));
+    this->maxSamples = max(maxSamples, this->minSamples);
+    this->agreementCM = convertDistanceUnit(agreementValue, agreementUnit, DistanceUnit::CENTIMETERS);
+}
+
+/**
+ * Will turn the servo and wait until it settles. The first move waits as if the servo crosses the whole range, because its position is unknown.
+ */
+void SweepScanner::moveServo(const float& angleDegrees) {
+
+    float turnDegrees = this->isServoPositioned ? fabsf(angleDegrees - this->servoAngleDegrees) : fabsf(this->stepAngleDegrees * static_cast<float>(this->anglesCount - 1));
+
+    if (this->isServoPositioned && turnDegrees == 0)
+        return;
+
+    this->servo.setAngleDegrees(angleDegrees);
+    this->servoAngleDegrees = angleDegrees;
+    this->isServoPositioned = true;
+
+    unsigned long turnSettleTimeMS = this->settleTimeMS + static_cast<unsigned long>(turnDegrees * this->settleTimeMSPerDegree + 0.5f);
+    this->hcsr04.getBackend().delayMS(turnSettleTimeMS);
+}
+
+/**
+ * The second batch is merged with the first by the count of their valid samples.
+ * Without a valid sample the reading has information only if some sample had an echo, even one beyond the max distance.
+ */
+PolarReading SweepScanner::measureAdaptively(const float& angleDegrees) {
+
+    MeasurementConfiguration firstConfiguration = MeasurementConfiguration::builder()
+            .withSamples(this->minSamples)
+            .build();
+
+    Measurement first = this->hcsr04.measure(firstConfiguration);
+
+    unsigned long validSamplesCount = first.getValidMeasurementsCount();
+    bool hasInformation = validSamplesCount > 0 || first.getResponseTimedOutCount() < first.getTakenSamples();
+    PolarReading reading = {angleDegrees, first.getDistance(DistanceUnit::CENTIMETERS), static_cast<uint8_t>(first.getTakenSamples()), validSamplesCount > 0, hasInformation};
+
+    bool isAgreed = validSamplesCount == this->minSamples && first.getSpread(DistanceUnit::CENTIMETERS) <= this->agreementCM;
+
+    if (validSamplesCount == 0 || isAgreed || this->maxSamples == this->minSamples)
+        return reading;
+
+    MeasurementConfiguration secondConfiguration = MeasurementConfiguration::builder()
+            .withSamples(this->maxSamples - this->minSamples)
+            .build();
+
+    Measurement second = this->hcsr04.measure(secondConfiguration);
+
+    unsigned long secondValidSamplesCount = second.getValidMeasurementsCount();
+    unsigned long allValidSamplesCount = validSamplesCount + secondValidSamplesCount;
+
+    reading.distanceCM = (first.getDistance(DistanceUnit::CENTIMETERS) * static_cast<float>(validSamplesCount) + second.getDistance(DistanceUnit::CENTIMETERS) * static_cast<float>(secondValidSamplesCount)) / static_cast<float>(allValidSamplesCount);
+    reading.samples += static_cast<uint8_t>(second.getTakenSamples());
+
+    return reading;
+}
+
+/**
+ * Will scan the next angle of the sweep. Call it from the loop, so other work can be done between the angles.
+ *
+ * @param reading Will be set to the reading of the angle
+ * @param angleIndex Will be set to the index of the angle, from the start angle. The reversed sweeps go from the last index
+ * @return If the reading completed a sweep
+ */
+bool SweepScanner::scanNext(PolarReading& reading, uint16_t& angleIndex) {
+
+    if (this->sweepPosition == 0) {
+        this->sweepStartTimeMS = this->hcsr04.getBackend().getTimeMS();
+        this->sweepSamplesCount = 0;
+    }
+
+    angleIndex = this->isSweepReversed ? this->anglesCount - 1 - this->sweepPosition : this->sweepPosition;
+    float angleDegrees = this->getAngleDegrees(angleIndex);
+
+    this->moveServo(angleDegrees);
+    reading = this->measureAdaptively(angleDegrees);
+
+    this->sweepSamplesCount += reading.samples;
+
+    if (++this->sweepPosition < this->anglesCount)
+        return false;
+
+    this->sweepPosition = 0;
+    this->isSweepReversed = !this->isSweepReversed;
+    this->lastSweepDurationMS = this->hcsr04.getBackend().getTimeMS() - this->sweepStartTimeMS;
+    this->lastSweepSamplesCount = this->sweepSamplesCount;
+
+    return true;
+}
+
+/**
+ * Will scan until the current sweep completes. The readings are ordered by the angle index, whatever the direction of the sweep.
+ *
+ * @param readings Must have space for the angles count
+ * @return How many readings were taken. 0 if they don't fit in the capacity
+ */
+uint16_t SweepScanner::scan(PolarReading* readings, const uint16_t& readingsCapacity) {
+
+    if (readingsCapacity < this->anglesCount)
+        return 0;
+
+    PolarReading reading;
+    uint16_t angleIndex;
+    uint16_t readingsCount = 0;
+    bool isSweepCompleted = false;
+
+    while (!isSweepCompleted) {
+        isSweepCompleted = this->scanNext(reading, angleIndex);
+
+        readings[angleIndex] = reading;
+        readingsCount++;
+    }
+
+    return readingsCount;
+}
+
+uint16_t SweepScanner::getAnglesCount() const {
+    return this->anglesCount;
+}
+
+float SweepScanner::getAngleDegrees(const uint16_t& angleIndex) const {
+    return this->startAngleDegrees + this->stepAngleDegrees * static_cast<float>(angleIndex);
+}
+
+/**
+ * @return How long the last complete sweep took, with the settling of the servo
+ */
+unsigned long SweepScanner::getLastSweepDurationMS() const {
+    return this->lastSweepDurationMS;
+}
+
+unsigned long SweepScanner::getLastSweepSamplesCount() const {
+    return this->lastSweepSamplesCount;
+}
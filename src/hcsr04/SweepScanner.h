@@ -0,0 +1,79 @@
+#ifndef HC_SR04_SWEEPSCANNER_H
+#define HC_SR04_SWEEPSCANNER_H
+
+#include <Arduino.h>
+#include "HCSR04.h"
+#include "ScanServo.h"
+#include "PolarReading.h"
+
+#define DEFAULT_SWEEP_SETTLE_TIME_MS 15
+#define DEFAULT_SWEEP_SETTLE_TIME_MS_PER_DEGREE 2.00f
+#define DEFAULT_SWEEP_MIN_SAMPLES 2
+#define DEFAULT_SWEEP_MAX_SAMPLES 5
+#define DEFAULT_SWEEP_AGREEMENT_CENTIMETERS 2.00f
+
+/**
+ * Scans the angles of a servo-mounted sensor.
+ *
+ * The sweeps go back and forth, so the servo never returns over the whole range.
+ * After each step the servo is given time to settle, which grows with the size of the step.
+ * At each angle the min samples are taken and only when they disagree by more than the agreement, the remaining up to the max samples.
+ * An angle without an echo is not sampled again, there is nothing to agree on.
+ *
+ * The other parameters of the measurements (max distance, temperature, calibration) are the defaults of the HCSR04.
+ */
+class SweepScanner {
+
+private:
+
+    HCSR04& hcsr04;
+    ScanServo& servo;
+
+    float startAngleDegrees;
+    float stepAngleDegrees;
+    uint16_t anglesCount;
+
+    unsigned long settleTimeMS;
+    float settleTimeMSPerDegree;
+
+    uint8_t minSamples;
+    uint8_t maxSamples;
+    float agreementCM;
+
+    uint16_t sweepPosition;
+    bool isSweepReversed;
+    float servoAngleDegrees;
+    bool isServoPositioned;
+
+    unsigned long sweepStartTimeMS;
+    unsigned long lastSweepDurationMS;
+    unsigned long lastSweepSamplesCount;
+    unsigned long sweepSamplesCount;
+
+    void moveServo(const float& angleDegrees);
+
+    PolarReading measureAdaptively(const float& angleDegrees);
+
+public:
+
+    SweepScanner(HCSR04& hcsr04, ScanServo& servo, const float& startAngleDegrees, const float& endAngleDegrees, const float& stepAngleDegrees);
+
+    void setSettleTime(const unsigned long& settleTimeMS, const float& settleTimeMSPerDegree);
+
+    void setAdaptiveSamples(const uint8_t& minSamples, const uint8_t& maxSamples, const float& agreementValue, const DistanceUnit& agreementUnit);
+
+    bool scanNext(PolarReading& reading, uint16_t& angleIndex);
+
+    uint16_t scan(PolarReading* readings, const uint16_t& readingsCapacity);
+
+    uint16_t getAnglesCount() const;
+
+    float getAngleDegrees(const uint16_t& angleIndex) const;
+
+    unsigned long getLastSweepDurationMS() const;
+
+    unsigned long getLastSweepSamplesCount() const;
+};
+
+
+#endif //HC_SR04_SWEEPSCANNER_H
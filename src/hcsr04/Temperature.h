@@ -0,0 +1,76 @@
+#ifndef HC_SR04_TEMPERATURE_H
+#define HC_SR04_TEMPERATURE_H
+
+#include "TemperatureUnits.h"
+
+/*
+ * The temperature units as types. Each of them knows its TemperatureUnit and how it is made from celsius (celsius * scale + offset),
+ * so the conversions between units known at compile time are calculated by the compiler.
+ */
+
+struct Celsius {
+    static constexpr TemperatureUnit unit() { return TemperatureUnit::CELSIUS; }
+    static constexpr float scale() { return 1.00f; }
+    static constexpr float offset() { return 0.00f; }
+};
+
+struct Fahrenheit {
+    static constexpr TemperatureUnit unit() { return TemperatureUnit::FAHRENHEIT; }
+    static constexpr float scale() { return 1.8f; }
+    static constexpr float offset() { return 32.00f; }
+};
+
+/**
+ * The scale and the offset between two different temperature units, constants.
+ */
+template<typename FromUnit, typename ToUnit>
+struct TemperatureConversion {
+    static constexpr float convert(const float value) {
+        return value * (ToUnit::scale() / FromUnit::scale()) + (ToUnit::offset() - FromUnit::offset() * ToUnit::scale() / FromUnit::scale());
+    }
+};
+
+/**
+ * A conversion to the same unit is nothing.
+ */
+template<typename Unit>
+struct TemperatureConversion<Unit, Unit> {
+    static constexpr float convert(const float value) { return value; }
+};
+
+/**
+ * A temperature, which unit is part of its type. For example Temperature<Celsius>{25}
+ * It can be converted to any other unit with to<Unit>() or implicitly when a Temperature of another unit is expected.
+ */
+template<typename Unit>
+class Temperature {
+
+private:
+
+    float value;
+
+public:
+
+    constexpr explicit Temperature(const float value) : value(value) {
+    }
+
+    template<typename FromUnit>
+    constexpr Temperature(const Temperature<FromUnit>& other) : value(TemperatureConversion<FromUnit, Unit>::convert(other.getValue())) {
+    }
+
+    constexpr float getValue() const {
+        return this->value;
+    }
+
+    static constexpr TemperatureUnit getUnit() {
+        return Unit::unit();
+    }
+
+    template<typename ToUnit>
+    constexpr Temperature<ToUnit> to() const {
+        return Temperature<ToUnit>(TemperatureConversion<Unit, ToUnit>::convert(this->value));
+    }
+};
+
+
+#endif //HC_SR04_TEMPERATURE_H
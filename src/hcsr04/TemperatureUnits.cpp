@@ -1,26 +1,49 @@
 #include "TemperatureUnits.h"
+#include <Arduino.h>
+
+#define TEMPERATURE_UNITS_COUNT 2
+
+/**
+ * The temperature units are not proportional, so each conversion is a scale and an offset: to = from * scale + offset
+ */
+struct TemperatureUnitConversion {
+
+    float scale;
+    float offset;
+};
+
+/**
+ * The conversions from the unit of the row to the unit of the column, in the order of the TemperatureUnit.
+ * Kept in the flash, so it doesn't take RAM on the AVR.
+ */
+static const TemperatureUnitConversion TEMPERATURE_UNIT_CONVERSIONS[TEMPERATURE_UNITS_COUNT][TEMPERATURE_UNITS_COUNT] PROGMEM = {
+        /*               CELSIUS                   FAHRENHEIT */
+        /* CELSIUS    */ {{1.00f, 0.00f},          {1.8f, 32.00f}},
+        /* FAHRENHEIT */ {{0.5555556f, -17.777778f}, {1.00f, 0.00f}}
+};
 
 /**
- * Will converted the given temperature in the given fromUnit to the given toUnit
+ * Will converted the given temperature in the given fromUnit to the given toUnit with a single table lookup.
  *
  * @param temperature The temperature that will be converted
- * @param fromUnit The unit that the temperature will be converted to
- * @param toUnit The unit that the temperature is now
- * @return The converted temperature in the given fromUnit to the given toUnit. -1 If the given fromUnit is not yet implemented.
+ * @param fromUnit The unit that the temperature is now
+ * @param toUnit The unit that the temperature will be converted to
+ * @return The converted temperature in the given fromUnit to the given toUnit. -1 If one of the units is not yet implemented.
  */
 float convertTemperatureUnit(const float& temperature, const TemperatureUnit& fromUnit, const TemperatureUnit& toUnit) {
 
-    switch (fromUnit) {
+    if (fromUnit == toUnit)
+        return temperature;
 
-        case TemperatureUnit::CELSIUS:
-            return convertCelsiusTo(temperature, toUnit);;
+    uint8_t fromIndex = static_cast<uint8_t>(fromUnit);
+    uint8_t toIndex = static_cast<uint8_t>(toUnit);
 
-        case TemperatureUnit::FAHRENHEIT:
-            return convertFahrenheitTo(temperature, toUnit);
+    if (fromIndex >= TEMPERATURE_UNITS_COUNT || toIndex >= TEMPERATURE_UNITS_COUNT)
+        return -1;
 
-        default:
-            return -1;
-    }
+    const TemperatureUnitConversion* conversion = &TEMPERATURE_UNIT_CONVERSIONS[fromIndex][toIndex];
+
+    return temperature * pgm_read_float(&conversion->scale) + pgm_read_float(&conversion->offset);
 }
 
 /**
@@ -31,18 +54,7 @@ float convertTemperatureUnit(const float& temperature, const TemperatureUnit& fr
  * @return The converted celsius to the given temperature unit. -1 If the given toUnit is not yet implemented.
  */
 float convertCelsiusTo(const float& celsius, const TemperatureUnit& toUnit) {
-
-    switch (toUnit) {
-
-        case TemperatureUnit::CELSIUS:
-            return celsius;
-
-        case TemperatureUnit::FAHRENHEIT:
-            return celsius * 1.8f + 32;
-
-        default:
-            return -1;
-    }
+    return convertTemperatureUnit(celsius, TemperatureUnit::CELSIUS, toUnit);
 }
 
 /**
@@ -53,15 +65,5 @@ float convertCelsiusTo(const float& celsius, const TemperatureUnit& toUnit) {
  * @return The converted fahrenheit to the given temperature unit. -1 If the given toUnit is not yet implemented.
  */
 float convertFahrenheitTo(const float& fahrenheit, const TemperatureUnit& toUnit) {
-    switch (toUnit) {
-
-        case TemperatureUnit::CELSIUS:
-            return (fahrenheit - 32) * 0.5556f;
-
-        case TemperatureUnit::FAHRENHEIT:
-            return fahrenheit;
-
-        default:
-            return -1;
-    }
+    return convertTemperatureUnit(fahrenheit, TemperatureUnit::FAHRENHEIT, toUnit);
 }
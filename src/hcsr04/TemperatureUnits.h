@@ -1,7 +1,9 @@
 #ifndef HC_SR04_TEMPERATUREUNITS_H
 #define HC_SR04_TEMPERATUREUNITS_H
 
-enum class TemperatureUnit {
+#include <stdint.h>
+
+enum class TemperatureUnit : uint8_t {
     CELSIUS, FAHRENHEIT
 };
 
@@ -0,0 +1,176 @@
+#include "TraceSummary.h"
+#include "HCSR04.h"
+
+TraceSummary::TraceSummary() : TraceSummary(0, DistanceUnit::CENTIMETERS) {
+}
+
+/**
+ * @param sensorId Identifies the sensor, which recordings are summarized
+ * @param distanceUnit In what distance unit the distances are summarized
+ */
+TraceSummary::TraceSummary(const unsigned long& sensorId, const DistanceUnit& distanceUnit) : sensorId(sensorId), distanceUnit(distanceUnit) {
+    this->measurementsCount = 0;
+    this->validDistancesCount = 0;
+    this->takenSamples = 0;
+    this->validSamples = 0;
+    this->signalTimedOutCount = 0;
+    this->responseTimedOutCount = 0;
+    this->maxDistanceExceededCount = 0;
+    this->meanDistance = 0;
+    this->squaredDeviationsSum = 0;
+    this->minDistance = 0;
+    this->maxDistance = 0;
+}
+
+/**
+ * Will add the measurement to the summary. Its distance is included only if it had at least one valid sample.
+ */
+void TraceSummary::add(const Measurement& measurement) {
+
+    this->measurementsCount++;
+    this->takenSamples += measurement.getTakenSamples();
+    this->validSamples += measurement.getValidMeasurementsCount();
+    this->signalTimedOutCount += measurement.getSignalTimedOutCount();
+    this->responseTimedOutCount += measurement.getResponseTimedOutCount();
+    this->maxDistanceExceededCount += measurement.getMaxDistanceExceededCount();
+
+    if (measurement.getValidMeasurementsCount() == 0)
+        return;
+
+    float distance = measurement.getDistance(this->distanceUnit);
+
+    this->validDistancesCount++;
+
+    //Welford's online algorithm
+    float delta = distance - this->meanDistance;
+    this->meanDistance += delta / static_cast<float>(this->validDistancesCount);
+    this->squaredDeviationsSum += delta * (distance - this->meanDistance);
+
+    this->minDistance = this->validDistancesCount == 1 ? distance : min(this->minDistance, distance);
+    this->maxDistance = this->validDistancesCount == 1 ? distance : max(this->maxDistance, distance);
+}
+
+/**
+ * Will replay the whole recording with a new HCSR04 and add all of the measurements to the summary.
+ * The measurements that didn't ping (the response cool-down is active) are not added, the replay is moved to the next record instead.
+ *
+ * @param echoReplay The recording of the sensor
+ * @param measurementConfiguration How the measurements will be done
+ */
+void TraceSummary::addReplay(EchoReplay& echoReplay, const MeasurementConfiguration& measurementConfiguration) {
+
+    HCSR04 hcsr04(echoReplay);
+
+    while (!echoReplay.isFinished()) {
+        unsigned long replayedCount = echoReplay.getReplayedCount();
+        Measurement measurement = hcsr04.measure(measurementConfiguration);
+
+        if (echoReplay.getReplayedCount() == replayedCount) {
+            echoReplay.advanceToNextRecord();
+            continue;
+        }
+
+        this->add(measurement);
+    }
+}
+
+/**
+ * Will merge the given summary of the same sensor into this one.
+ * The mean and the variance are combined with the parallel variant of Welford's algorithm (Chan et al.).
+ */
+void TraceSummary::merge(const TraceSummary& traceSummary) {
+
+    this->measurementsCount += traceSummary.measurementsCount;
+    this->takenSamples += traceSummary.takenSamples;
+    this->validSamples += traceSummary.validSamples;
+    this->signalTimedOutCount += traceSummary.signalTimedOutCount;
+    this->responseTimedOutCount += traceSummary.responseTimedOutCount;
+    this->maxDistanceExceededCount += traceSummary.maxDistanceExceededCount;
+
+    if (traceSummary.validDistancesCount == 0)
+        return;
+
+    float factor = getDistanceUnitConversionFactor(traceSummary.distanceUnit, this->distanceUnit);
+    float otherMean = traceSummary.meanDistance * factor;
+    float otherSquaredDeviationsSum = traceSummary.squaredDeviationsSum * factor * factor;
+    float otherMin = traceSummary.minDistance * factor;
+    float otherMax = traceSummary.maxDistance * factor;
+
+    if (this->validDistancesCount == 0) {
+        this->validDistancesCount = traceSummary.validDistancesCount;
+        this->meanDistance = otherMean;
+        this->squaredDeviationsSum = otherSquaredDeviationsSum;
+        this->minDistance = otherMin;
+        this->maxDistance = otherMax;
+        return;
+    }
+
+    float count = static_cast<float>(this->validDistancesCount);
+    float otherCount = static_cast<float>(traceSummary.validDistancesCount);
+    float totalCount = count + otherCount;
+    float delta = otherMean - this->meanDistance;
+
+    this->meanDistance += delta * otherCount / totalCount;
+    this->squaredDeviationsSum += otherSquaredDeviationsSum + delta * delta * count * otherCount / totalCount;
+    this->validDistancesCount += traceSummary.validDistancesCount;
+    this->minDistance = min(this->minDistance, otherMin);
+    this->maxDistance = max(this->maxDistance, otherMax);
+}
+
+unsigned long TraceSummary::getSensorId() const {
+    return this->sensorId;
+}
+
+unsigned long TraceSummary::getMeasurementsCount() const {
+    return this->measurementsCount;
+}
+
+/**
+ * @return How many of the measurements had at least one valid sample and are included in the distance statistics
+ */
+unsigned long TraceSummary::getValidDistancesCount() const {
+    return this->validDistancesCount;
+}
+
+unsigned long TraceSummary::getTakenSamples() const {
+    return this->takenSamples;
+}
+
+unsigned long TraceSummary::getValidSamples() const {
+    return this->validSamples;
+}
+
+unsigned long TraceSummary::getSignalTimedOutCount() const {
+    return this->signalTimedOutCount;
+}
+
+unsigned long TraceSummary::getResponseTimedOutCount() const {
+    return this->responseTimedOutCount;
+}
+
+unsigned long TraceSummary::getMaxDistanceExceededCount() const {
+    return this->maxDistanceExceededCount;
+}
+
+DistanceUnit TraceSummary::getDistanceUnit() const {
+    return this->distanceUnit;
+}
+
+float TraceSummary::getMeanDistance() const {
+    return this->meanDistance;
+}
+
+/**
+ * @return The sample variance of the distances. 0 If there are less than two valid distances.
+ */
+float TraceSummary::getDistanceVariance() const {
+    return this->validDistancesCount < 2 ? 0 : this->squaredDeviationsSum / static_cast<float>(this->validDistancesCount - 1);
+}
+
+float TraceSummary::getMinDistance() const {
+    return this->minDistance;
+}
+
+float TraceSummary::getMaxDistance() const {
+    return this->maxDistance;
+}
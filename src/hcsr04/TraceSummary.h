@@ -0,0 +1,76 @@
+#ifndef HC_SR04_TRACESUMMARY_H
+#define HC_SR04_TRACESUMMARY_H
+
+#include <Arduino.h>
+#include "Measurement.h"
+#include "MeasurementConfiguration.h"
+#include "EchoReplay.h"
+
+/**
+ * Summary of the measurements of one sensor: how many there were, their samples & errors and the mean/variance/min/max of their distances.
+ *
+ * Summaries of different parts of the same sensor's recordings can be merged. That way the recordings can be split in shards,
+ * each shard replayed by its own HCSR04 and EchoReplay (nothing is shared between them, so on the host each shard can run on its own thread)
+ * and the results merged into one summary per sensor. Merging the shards in the same order always gives the same result.
+ */
+class TraceSummary {
+
+private:
+
+    unsigned long sensorId;
+
+    unsigned long measurementsCount;
+    unsigned long validDistancesCount;
+    unsigned long takenSamples;
+    unsigned long validSamples;
+    unsigned long signalTimedOutCount;
+    unsigned long responseTimedOutCount;
+    unsigned long maxDistanceExceededCount;
+
+    DistanceUnit distanceUnit;
+    float meanDistance;
+    float squaredDeviationsSum;
+    float minDistance;
+    float maxDistance;
+
+public:
+
+    TraceSummary();
+
+    TraceSummary(const unsigned long& sensorId, const DistanceUnit& distanceUnit);
+
+    void add(const Measurement& measurement);
+
+    void addReplay(EchoReplay& echoReplay, const MeasurementConfiguration& measurementConfiguration);
+
+    void merge(const TraceSummary& traceSummary);
+
+    unsigned long getSensorId() const;
+
+    unsigned long getMeasurementsCount() const;
+
+    unsigned long getValidDistancesCount() const;
+
+    unsigned long getTakenSamples() const;
+
+    unsigned long getValidSamples() const;
+
+    unsigned long getSignalTimedOutCount() const;
+
+    unsigned long getResponseTimedOutCount() const;
+
+    unsigned long getMaxDistanceExceededCount() const;
+
+    DistanceUnit getDistanceUnit() const;
+
+    float getMeanDistance() const;
+
+    float getDistanceVariance() const;
+
+    float getMinDistance() const;
+
+    float getMaxDistance() const;
+};
+
+
+#endif //HC_SR04_TRACESUMMARY_H
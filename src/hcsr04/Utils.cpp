@@ -74,7 +74,8 @@ unsigned long measureSignalLength(const uint8_t& pin, const int& mode) {
  * Will measure the length of a given signal, but with a timeout.
  * If the current signal is not the given one, then it will block until it is.
  * If the current signal is the given one, then it will measure it directly.
- * If the waiting of the signal or its measurement take longer than the given timeout, a timeout will occur.
+ * If the waiting of the signal and its measurement take longer than the given timeout together, a timeout will occur.
+ * The interrupts stay enabled, so the serial and timer interrupts are not stalled for the whole echo and millis() keeps counting for the timeout.
  *
  * @param pin The digital pin, which will be used to determinate the signal
  * @param mode HIGH or LOW
@@ -82,27 +83,23 @@ unsigned long measureSignalLength(const uint8_t& pin, const int& mode) {
  */
 SignalLengthMeasurementUS measureSignalLength(const uint8_t& pin, const char& mode, const unsigned long& timeoutMS) {
 
-    noInterrupts();
     pinMode(pin, INPUT);
 
+    unsigned long startMS = millis();
     bool isWaitingTimedOut = waitStateNot(pin, mode, timeoutMS);
 
-    if (isWaitingTimedOut) {
-        interrupts();
+    if (isWaitingTimedOut)
         return SignalLengthMeasurementUS{0, true};
-    }
 
 
+    unsigned long waitedMS = millis() - startMS;
     unsigned long signalLengthStart = micros();
-    bool isMeasuringTimedOut = waitStateIs(pin, mode, timeoutMS);
+    bool isMeasuringTimedOut = waitStateIs(pin, mode, waitedMS >= timeoutMS ? 0 : timeoutMS - waitedMS);
 
-    if (isMeasuringTimedOut) {
-        interrupts();
+    if (isMeasuringTimedOut)
         return SignalLengthMeasurementUS{0, true};
-    }
 
     unsigned long signalLength = micros() - signalLengthStart;
-    interrupts();
 
     return {signalLength, false};
 }
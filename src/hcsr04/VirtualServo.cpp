@@ -0,0 +1,27 @@
+#include "VirtualServo.h"
+
+VirtualServo::VirtualServo(SimulatedSensor& sensor, const float& headingOffsetDegrees) : sensor(sensor) {
+    this->headingOffsetDegrees = headingOffsetDegrees;
+    this->angleDegrees = 0;
+    this->movesCount = 0;
+
+    this->sensor.setHeadingDegrees(headingOffsetDegrees);
+}
+
+/**
+ * The simulated sensor turns at once. The settle time is waited by the SweepScanner on the virtual clock of the scene.
+ */
+void VirtualServo::setAngleDegrees(const float& angleDegrees) {
+    this->angleDegrees = angleDegrees;
+    this->movesCount++;
+
+    this->sensor.setHeadingDegrees(this->headingOffsetDegrees + angleDegrees);
+}
+
+float VirtualServo::getAngleDegrees() const {
+    return this->angleDegrees;
+}
+
+unsigned long VirtualServo::getMovesCount() const {
+    return this->movesCount;
+}
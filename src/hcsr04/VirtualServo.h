@@ -0,0 +1,33 @@
+#ifndef HC_SR04_VIRTUALSERVO_H
+#define HC_SR04_VIRTUALSERVO_H
+
+#include "ScanServo.h"
+#include "SimulatedSensor.h"
+
+/**
+ * Turns a simulated sensor, so a SweepScanner can scan a simulated scene on the host.
+ *
+ * @param headingOffsetDegrees The heading of the sensor in the scene, when the servo is at 0 degrees
+ */
+class VirtualServo : public ScanServo {
+
+private:
+
+    SimulatedSensor& sensor;
+    float headingOffsetDegrees;
+    float angleDegrees;
+    unsigned long movesCount;
+
+public:
+
+    VirtualServo(SimulatedSensor& sensor, const float& headingOffsetDegrees = 0);
+
+    void setAngleDegrees(const float& angleDegrees) override;
+
+    float getAngleDegrees() const;
+
+    unsigned long getMovesCount() const;
+};
+
+
+#endif //HC_SR04_VIRTUALSERVO_H
@@ -1,5 +1,5 @@
 #include <Arduino.h>
-#include <SerialPrintF.h>
+#include <SerialFormat.h>
 #include "hcsr04/HCSR04.h"
 
 #define SERIAL_BAUD_RATE 9600
@@ -15,8 +15,8 @@ void loop() {
 
     Measurement measurement = hcsr04.measure();
 
-    serial_printf(Serial,
-                  "Distance: %2f %s, Valid Samples: %l/%i [Signal Timed Out Count: %i, Response Timed Out Count: %i, Max Distance Exceeded Count: %i, Response Cool Down: %o]\n",
+    SERIAL_PRINTF(Serial,
+                  "Distance: %2f %s, Valid Samples: %i/%i [Signal Timed Out Count: %i, Response Timed Out Count: %i, Max Distance Exceeded Count: %i, Response Cool Down: %o]\n",
                   measurement.getDistance(), getDistanceUnitAbbreviation(measurement.getDistanceUnit()),
                   measurement.getValidMeasurementsCount(),
                   measurement.getTakenSamples(),
@@ -0,0 +1,34 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <time.h>
+
+EEPROMClass EEPROM;
+
+static uint64_t getMonotonicTimeUS() {
+
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<uint64_t>(time.tv_sec) * 1000000 + static_cast<uint64_t>(time.tv_nsec) / 1000;
+}
+
+static const uint64_t START_TIME_US = getMonotonicTimeUS();
+
+unsigned long millis() {
+    return static_cast<unsigned long>((getMonotonicTimeUS() - START_TIME_US) / 1000);
+}
+
+unsigned long micros() {
+    return static_cast<unsigned long>(getMonotonicTimeUS() - START_TIME_US);
+}
+
+void delay(unsigned long ms) {
+    struct timespec duration = {static_cast<time_t>(ms / 1000), static_cast<long>(ms % 1000) * 1000000};
+    nanosleep(&duration, nullptr);
+}
+
+void delayMicroseconds(unsigned int us) {
+
+    struct timespec duration = {0, static_cast<long>(us) * 1000};
+    nanosleep(&duration, nullptr);
+}
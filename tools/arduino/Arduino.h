@@ -0,0 +1,205 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/*
+ * The parts of the Arduino core that the library uses, for building the tools on a host (Linux).
+ * The time comes from the monotonic clock of the host and the pins do nothing, so the tools use other backends, for example a SimulatedSensor.
+ * Print formats the numbers with the same algorithms as the Print of the AVR core, so the benchmarks compare the real work.
+ * min/max/constrain are templates, like in the newer Arduino cores, so the headers of the C++ library still compile.
+ */
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+
+#define PROGMEM
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t*>(address))
+#define pgm_read_float(address) (*reinterpret_cast<const float*>(address))
+
+typedef uint8_t byte;
+
+template<typename T, typename L>
+auto min(const T& a, const L& b) -> decltype(b < a ? b : a) {
+    return b < a ? b : a;
+}
+
+template<typename T, typename L>
+auto max(const T& a, const L& b) -> decltype(b < a ? b : a) {
+    return a < b ? b : a;
+}
+
+template<typename T, typename L, typename H>
+auto constrain(const T& amount, const L& low, const H& high) -> decltype(amount < low ? low : (amount > high ? high : amount)) {
+    return amount < low ? low : (amount > high ? high : amount);
+}
+
+unsigned long millis();
+
+unsigned long micros();
+
+void delay(unsigned long ms);
+
+void delayMicroseconds(unsigned int us);
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+}
+
+inline int digitalRead(uint8_t pin) {
+    return LOW;
+}
+
+inline void noInterrupts() {
+}
+
+inline void interrupts() {
+}
+
+class Print {
+
+private:
+
+    size_t printNumber(unsigned long n, uint8_t base) {
+        char buf[8 * sizeof(long) + 1];
+        char* str = &buf[sizeof(buf) - 1];
+
+        *str = '\0';
+
+        if (base < 2)
+            base = 10;
+
+        do {
+            char c = static_cast<char>(n % base);
+            n /= base;
+
+            *--str = static_cast<char>(c < 10 ? c + '0' : c + 'A' - 10);
+        } while (n);
+
+        return write(str);
+    }
+
+    size_t printFloat(double number, uint8_t digits) {
+        size_t n = 0;
+
+        if (isnan(number)) return print("nan");
+        if (isinf(number)) return print("inf");
+        if (number > 4294967040.0) return print("ovf");
+        if (number < -4294967040.0) return print("ovf");
+
+        if (number < 0.0) {
+            n += print('-');
+            number = -number;
+        }
+
+        double rounding = 0.5;
+        for (uint8_t i = 0; i < digits; ++i)
+            rounding /= 10.0;
+
+        number += rounding;
+
+        unsigned long int_part = static_cast<unsigned long>(number);
+        double remainder = number - static_cast<double>(int_part);
+        n += print(int_part);
+
+        if (digits > 0)
+            n += print('.');
+
+        while (digits-- > 0) {
+            remainder *= 10.0;
+            unsigned int toPrint = static_cast<unsigned int>(remainder);
+            n += print(toPrint);
+            remainder -= toPrint;
+        }
+
+        return n;
+    }
+
+public:
+
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+
+        while (size--)
+            n += write(*buffer++);
+
+        return n;
+    }
+
+    size_t write(const char* str) {
+        return write(reinterpret_cast<const uint8_t*>(str), strlen(str));
+    }
+
+    size_t print(const char* str) { return write(str); }
+
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+
+    size_t print(unsigned int n, int base = DEC) { return print(static_cast<unsigned long>(n), base); }
+
+    size_t print(int n, int base = DEC) { return print(static_cast<long>(n), base); }
+
+    size_t print(unsigned long n, int base = DEC) { return printNumber(n, static_cast<uint8_t>(base)); }
+
+    size_t print(long n, int base = DEC) {
+        if (base == 10 && n < 0)
+            return print('-') + printNumber(static_cast<unsigned long>(-n), 10);
+
+        return printNumber(static_cast<unsigned long>(n), static_cast<uint8_t>(base));
+    }
+
+    size_t print(double n, int digits = 2) { return printFloat(n, static_cast<uint8_t>(digits)); }
+};
+
+class Stream : public Print {
+
+public:
+
+    virtual int available() = 0;
+
+    virtual int read() = 0;
+
+    virtual int peek() = 0;
+
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t count = 0;
+
+        while (count < length) {
+            int c = read();
+
+            if (c < 0)
+                break;
+
+            buffer[count++] = static_cast<uint8_t>(c);
+        }
+
+        return count;
+    }
+
+    size_t readBytes(char* buffer, size_t length) {
+        return readBytes(reinterpret_cast<uint8_t*>(buffer), length);
+    }
+};
+
+class HardwareSerial : public Print {
+};
+
+#endif //HOST_ARDUINO_H
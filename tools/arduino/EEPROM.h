@@ -0,0 +1,73 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define HOST_EEPROM_LENGTH 1024
+
+/**
+ * The EEPROM of an ATmega328P (Uno) in memory. Erased bytes are 0xFF, like on the chip.
+ */
+class EEPROMClass {
+
+private:
+
+    uint8_t data[HOST_EEPROM_LENGTH];
+    unsigned long writesCount;
+
+public:
+
+    EEPROMClass() : writesCount(0) {
+        memset(this->data, 0xFF, sizeof(this->data));
+    }
+
+    uint8_t read(int address) const {
+        return this->data[address];
+    }
+
+    void write(int address, uint8_t value) {
+        this->data[address] = value;
+        this->writesCount++;
+    }
+
+    void update(int address, uint8_t value) {
+
+        if (this->data[address] != value)
+            this->write(address, value);
+    }
+
+    uint16_t length() const {
+        return HOST_EEPROM_LENGTH;
+    }
+
+    template<typename T>
+    T& get(int address, T& value) const {
+        memcpy(&value, this->data + address, sizeof(T));
+        return value;
+    }
+
+    /**
+     * Only the changed bytes are written, like on the AVR.
+     */
+    template<typename T>
+    const T& put(int address, const T& value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+
+        for (size_t i = 0; i < sizeof(T); i++)
+            this->update(address + static_cast<int>(i), bytes[i]);
+
+        return value;
+    }
+
+    /**
+     * @return How many bytes were written, to see the wear
+     */
+    unsigned long getWritesCount() const {
+        return this->writesCount;
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif //HOST_EEPROM_H
@@ -0,0 +1,21 @@
+#ifndef HOST_TOOLCHECKS_H
+#define HOST_TOOLCHECKS_H
+
+#include <stdio.h>
+
+#define TOOL_CHECK_NAME_WIDTH 72
+
+/**
+ * Prints the result of a check of a host tool in a column. The tools exit with 2 when a check fails.
+ *
+ * bool isPassed = check(distance == 100, "the distance is measured");
+ *
+ * @return If the check passed
+ */
+inline bool check(const bool& isPassed, const char* name) {
+    printf("%-*s %s\n", TOOL_CHECK_NAME_WIDTH, name, isPassed ? "ok" : "FAILED");
+    return isPassed;
+}
+
+
+#endif //HOST_TOOLCHECKS_H
@@ -0,0 +1,87 @@
+/*
+ * A sensor on the ceiling, which measures the floor, and a person who passes below it now and then.
+ * The BackgroundModel learns the floor, reports only when the person appears, moves or leaves and lets the sensor be measured
+ * less often while there is only the floor. The counts of the measurements and the reports are compared with a fixed period.
+ *
+ * Build: g++ -std=c++11 -O2 -I ../arduino -I ../../src -I ../../src/hcsr04 BackgroundModelDemo.cpp ../arduino/Arduino.cpp ../../src/hcsr04/BackgroundModel.cpp ../../src/hcsr04/HCSR04.cpp ../../src/hcsr04/ExtendedClock.cpp ../../src/hcsr04/HCSR04PinBackend.cpp ../../src/hcsr04/HCSR04Response.cpp ../../src/hcsr04/Measurement.cpp ../../src/hcsr04/AdaptivePingRate.cpp ../../src/hcsr04/SoundSpeed.cpp ../../src/hcsr04/SoundSpeedCalibration.cpp ../../src/hcsr04/DistanceUnits.cpp ../../src/hcsr04/TemperatureUnits.cpp ../../src/hcsr04/Utils.cpp ../../src/hcsr04/SceneSimulator.cpp ../../src/hcsr04/SimulatedSensor.cpp -o hcsr04-background-model-demo
+ * Usage: hcsr04-background-model-demo [minutes]
+ */
+#include <BackgroundModel.h>
+#include <HCSR04.h>
+#include <SceneSimulator.h>
+#include <SimulatedSensor.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEMO_DEFAULT_MINUTES 10
+#define DEMO_PRINTED_CHANGES 12
+
+/*
+ * The floor is at 250 cm. The person oscillates between 180 and 620 cm, so they are in front of the floor a quarter of each minute
+ */
+#define DEMO_SCENARIO "seed 5\nmissed 0.02\ntarget static 250 0\ntarget oscillating 400 220 60000 0\n"
+
+static const char* getBackgroundStateName(const BackgroundState& state) {
+
+    switch (state) {
+        case BackgroundState::BACKGROUND:
+            return "background";
+        case BackgroundState::FOREGROUND:
+            return "foreground";
+        default:
+            return "learning";
+    }
+}
+
+int main(int argc, char** argv) {
+
+    int minutes = argc > 1 ? atoi(argv[1]) : DEMO_DEFAULT_MINUTES;
+
+    if (minutes <= 0) {
+        fprintf(stderr, "Usage: %s [minutes]\n", argv[0]);
+        return 1;
+    }
+
+    SceneSimulator scene;
+
+    if (!scene.loadScenario(DEMO_SCENARIO))
+        return 1;
+
+    SimulatedSensor simulatedSensor(scene, 0);
+    HCSR04 hcsr04(simulatedSensor);
+    BackgroundModel backgroundModel;
+
+    unsigned long durationMS = static_cast<unsigned long>(minutes) * 60000UL;
+    unsigned long foregroundMeasurementsCount = 0;
+
+    while (simulatedSensor.getTimeMS() < durationMS) {
+
+        unsigned long startTimeMS = simulatedSensor.getTimeMS();
+        Measurement measurement = hcsr04.measure();
+
+        BackgroundChange change;
+
+        if (backgroundModel.add(measurement, change) && backgroundModel.getReportedChangesCount() <= DEMO_PRINTED_CHANGES)
+            printf("%7.1f s %-10s %s %7.2f cm, %+7.2f cm from the background\n",
+                   static_cast<float>(startTimeMS) / 1000.0f, getBackgroundStateName(change.state), change.isValid ? "at" : "no echo", change.distanceCM, change.deviationCM);
+
+        foregroundMeasurementsCount += backgroundModel.getState() == BackgroundState::FOREGROUND ? 1 : 0;
+
+        unsigned long elapsedMS = simulatedSensor.getTimeMS() - startTimeMS;
+        unsigned long periodMS = backgroundModel.getSuggestedPeriodMS();
+
+        if (elapsedMS < periodMS)
+            simulatedSensor.delayMS(periodMS - elapsedMS);
+    }
+
+    float backgroundDistanceCM = 0;
+    backgroundModel.getBackgroundDistanceCM(backgroundDistanceCM);
+
+    unsigned long fixedMeasurementsCount = durationMS / DEFAULT_BACKGROUND_FOREGROUND_PERIOD_MS;
+
+    printf("background %.2f cm, measurements %lu (%lu foreground) instead of %lu at a fixed period, reported %lu (%.1f%% of the fixed period)\n",
+           backgroundDistanceCM, backgroundModel.getMeasurementsCount(), foregroundMeasurementsCount, fixedMeasurementsCount,
+           backgroundModel.getReportedChangesCount(), 100.0f * static_cast<float>(backgroundModel.getReportedChangesCount()) / static_cast<float>(fixedMeasurementsCount));
+
+    return 0;
+}
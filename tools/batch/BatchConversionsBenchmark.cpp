@@ -0,0 +1,170 @@
+/*
+ * Benchmarks the vectorized kernels of BatchConversions against converting the elements one by one, like the rest of the library does
+ * (convertDistanceUnit for each distance, the factor of the temperature for each echo length and a comparison for each echo),
+ * and checks that the results are exactly the same, also for the counts, which leave a tail for the scalar loop.
+ * The kernel is chosen at compile time: SSE2 is the default of x86-64, add -mavx2 to the build for the AVX2 one.
+ * The exit code is not 0 if a result differs.
+ *
+ * Build: g++ -std=c++11 -O2 -I ../arduino -I ../../src -I ../../src/hcsr04 BatchConversionsBenchmark.cpp ../arduino/Arduino.cpp ../../src/hcsr04/BatchConversions.cpp ../../src/hcsr04/DistanceUnits.cpp ../../src/hcsr04/TemperatureUnits.cpp ../../src/hcsr04/SoundSpeed.cpp -o hcsr04-batch-benchmark
+ * Usage: hcsr04-batch-benchmark [elements] [repetitions]
+ */
+#include <BatchConversions.h>
+#include <HCSR04.h>
+#include <SoundSpeed.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define BENCHMARK_DEFAULT_ELEMENTS 1000000
+#define BENCHMARK_DEFAULT_REPETITIONS 50
+#define BENCHMARK_TEMPERATURE_CELSIUS 21.5f
+#define BENCHMARK_MAX_DISTANCE_CENTIMETERS 250.0f
+#define BENCHMARK_CHECKED_TAILS 33
+
+#if defined(__AVX2__)
+#define BENCHMARK_KERNEL "AVX2"
+#elif defined(__SSE2__)
+#define BENCHMARK_KERNEL "SSE2"
+#else
+#define BENCHMARK_KERNEL "scalar"
+#endif
+
+/*
+ * The element by element references
+ */
+
+static void convertDistanceUnitsOneByOne(const float* distances, float* convertedDistances, const size_t& count, const DistanceUnit& fromUnit, const DistanceUnit& toUnit) {
+
+    for (size_t i = 0; i < count; i++)
+        convertedDistances[i] = convertDistanceUnit(distances[i], fromUnit, toUnit);
+}
+
+static float calculateDistancePerSignalLengthUS(const float& temperature, const TemperatureUnit& temperatureUnit, const DistanceUnit& distanceUnit) {
+    float soundSpeedInCentimetersPerMicrosecond = convertMetersPerSecondToCentimetersPerMicrosecond(calculateSoundSpeedByTemperature(temperature, temperatureUnit));
+    return soundSpeedInCentimetersPerMicrosecond / 2 * getDistanceUnitConversionFactor(DistanceUnit::CENTIMETERS, distanceUnit);
+}
+
+static void convertSignalLengthsOneByOne(const uint16_t* signalLengthsUS, float* distances, const size_t& count, const float& temperature, const TemperatureUnit& temperatureUnit, const DistanceUnit& distanceUnit) {
+
+    for (size_t i = 0; i < count; i++)
+        distances[i] = static_cast<float>(signalLengthsUS[i]) * calculateDistancePerSignalLengthUS(temperature, temperatureUnit, distanceUnit);
+}
+
+static size_t classifySignalLengthsOneByOne(const uint16_t* signalLengthsUS, uint8_t* isValid, const size_t& count, const float& maxDistance, const DistanceUnit& maxDistanceUnit, const float& temperature, const TemperatureUnit& temperatureUnit) {
+
+    size_t validCount = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        float maxSignalLengthUS = maxDistance / calculateDistancePerSignalLengthUS(temperature, temperatureUnit, maxDistanceUnit);
+
+        isValid[i] = signalLengthsUS[i] != 0 && signalLengthsUS[i] < TIMEOUT_SIGNAL_LENGTH_US && signalLengthsUS[i] <= maxSignalLengthUS ? 1 : 0;
+        validCount += isValid[i];
+    }
+
+    return validCount;
+}
+
+/**
+ * @return The nanoseconds per element of the best repetition, so a preemption doesn't count
+ */
+template<typename Function>
+static double measureNanosecondsPerElement(const size_t& count, const int& repetitions, Function function) {
+
+    double bestSeconds = 0;
+
+    for (int i = 0; i < repetitions; i++) {
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+        if (i == 0 || seconds < bestSeconds)
+            bestSeconds = seconds;
+    }
+
+    return bestSeconds * 1e9 / static_cast<double>(count);
+}
+
+static void printResult(const char* name, const double& oneByOneNS, const double& batchNS, const bool& isSame) {
+    printf("%-34s one by one %6.3f ns, %-6s %6.3f ns, speedup %5.1fx, %s\n", name, oneByOneNS, BENCHMARK_KERNEL, batchNS, oneByOneNS / batchNS, isSame ? "same results" : "DIFFERENT RESULTS");
+}
+
+int main(int argc, char** argv) {
+
+    long elementsCount = argc > 1 ? atol(argv[1]) : BENCHMARK_DEFAULT_ELEMENTS;
+    int repetitions = argc > 2 ? atoi(argv[2]) : BENCHMARK_DEFAULT_REPETITIONS;
+
+    if (elementsCount <= 0 || repetitions <= 0) {
+        fprintf(stderr, "Usage: %s [elements] [repetitions]\n", argv[0]);
+        return 1;
+    }
+
+    size_t count = static_cast<size_t>(elementsCount);
+    std::vector<uint16_t> signalLengthsUS(count);
+    std::vector<float> distances(count);
+    std::vector<float> expectedDistances(count);
+    std::vector<float> batchDistances(count);
+    std::vector<uint8_t> expectedIsValid(count);
+    std::vector<uint8_t> batchIsValid(count);
+    uint32_t randomState = 1;
+
+    //Echoes up to above the signal time out, with some that didn't arrive
+    for (size_t i = 0; i < count; i++) {
+        randomState = randomState * 1103515245 + 12345;
+        signalLengthsUS[i] = (randomState >> 8) % 64 == 0 ? 0 : static_cast<uint16_t>((randomState >> 8) % 40000);
+        distances[i] = static_cast<float>(signalLengthsUS[i]) / 58.3f;
+    }
+
+    printf("%zu elements, kernel %s\n", count, BENCHMARK_KERNEL);
+
+    bool isPassed = true;
+    bool isSame = true;
+
+    //The counts up to BENCHMARK_CHECKED_TAILS cover every tail of the vector loops, the full count their steady state
+    for (size_t checkedCount = 0; checkedCount <= BENCHMARK_CHECKED_TAILS; checkedCount++) {
+        size_t n = checkedCount == BENCHMARK_CHECKED_TAILS ? count : min(checkedCount, count);
+
+        convertDistanceUnitsOneByOne(distances.data(), expectedDistances.data(), n, DistanceUnit::CENTIMETERS, DistanceUnit::INCH);
+        convertDistanceUnits(distances.data(), batchDistances.data(), n, DistanceUnit::CENTIMETERS, DistanceUnit::INCH);
+        isSame &= memcmp(expectedDistances.data(), batchDistances.data(), n * sizeof(float)) == 0;
+    }
+
+    double oneByOneNS = measureNanosecondsPerElement(count, repetitions, [&]() { convertDistanceUnitsOneByOne(distances.data(), expectedDistances.data(), count, DistanceUnit::CENTIMETERS, DistanceUnit::INCH); });
+    double batchNS = measureNanosecondsPerElement(count, repetitions, [&]() { convertDistanceUnits(distances.data(), batchDistances.data(), count, DistanceUnit::CENTIMETERS, DistanceUnit::INCH); });
+
+    printResult("convertDistanceUnits", oneByOneNS, batchNS, isSame);
+    isPassed &= isSame;
+    isSame = true;
+
+    for (size_t checkedCount = 0; checkedCount <= BENCHMARK_CHECKED_TAILS; checkedCount++) {
+        size_t n = checkedCount == BENCHMARK_CHECKED_TAILS ? count : min(checkedCount, count);
+
+        convertSignalLengthsOneByOne(signalLengthsUS.data(), expectedDistances.data(), n, BENCHMARK_TEMPERATURE_CELSIUS, TemperatureUnit::CELSIUS, DistanceUnit::CENTIMETERS);
+        convertSignalLengthsToDistances(signalLengthsUS.data(), batchDistances.data(), n, BENCHMARK_TEMPERATURE_CELSIUS, TemperatureUnit::CELSIUS, DistanceUnit::CENTIMETERS);
+        isSame &= memcmp(expectedDistances.data(), batchDistances.data(), n * sizeof(float)) == 0;
+    }
+
+    oneByOneNS = measureNanosecondsPerElement(count, repetitions, [&]() { convertSignalLengthsOneByOne(signalLengthsUS.data(), expectedDistances.data(), count, BENCHMARK_TEMPERATURE_CELSIUS, TemperatureUnit::CELSIUS, DistanceUnit::CENTIMETERS); });
+    batchNS = measureNanosecondsPerElement(count, repetitions, [&]() { convertSignalLengthsToDistances(signalLengthsUS.data(), batchDistances.data(), count, BENCHMARK_TEMPERATURE_CELSIUS, TemperatureUnit::CELSIUS, DistanceUnit::CENTIMETERS); });
+
+    printResult("convertSignalLengthsToDistances", oneByOneNS, batchNS, isSame);
+    isPassed &= isSame;
+    isSame = true;
+
+    for (size_t checkedCount = 0; checkedCount <= BENCHMARK_CHECKED_TAILS; checkedCount++) {
+        size_t n = checkedCount == BENCHMARK_CHECKED_TAILS ? count : min(checkedCount, count);
+
+        size_t expectedValidCount = classifySignalLengthsOneByOne(signalLengthsUS.data(), expectedIsValid.data(), n, BENCHMARK_MAX_DISTANCE_CENTIMETERS, DistanceUnit::CENTIMETERS, BENCHMARK_TEMPERATURE_CELSIUS, TemperatureUnit::CELSIUS);
+        size_t batchValidCount = classifySignalLengths(signalLengthsUS.data(), batchIsValid.data(), n, BENCHMARK_MAX_DISTANCE_CENTIMETERS, DistanceUnit::CENTIMETERS, BENCHMARK_TEMPERATURE_CELSIUS, TemperatureUnit::CELSIUS);
+        isSame &= expectedValidCount == batchValidCount && memcmp(expectedIsValid.data(), batchIsValid.data(), n) == 0;
+    }
+
+    oneByOneNS = measureNanosecondsPerElement(count, repetitions, [&]() { classifySignalLengthsOneByOne(signalLengthsUS.data(), expectedIsValid.data(), count, BENCHMARK_MAX_DISTANCE_CENTIMETERS, DistanceUnit::CENTIMETERS, BENCHMARK_TEMPERATURE_CELSIUS, TemperatureUnit::CELSIUS); });
+    batchNS = measureNanosecondsPerElement(count, repetitions, [&]() { classifySignalLengths(signalLengthsUS.data(), batchIsValid.data(), count, BENCHMARK_MAX_DISTANCE_CENTIMETERS, DistanceUnit::CENTIMETERS, BENCHMARK_TEMPERATURE_CELSIUS, TemperatureUnit::CELSIUS); });
+
+    printResult("classifySignalLengths", oneByOneNS, batchNS, isSame);
+    isPassed &= isSame;
+
+    return isPassed ? 0 : 2;
+}
@@ -0,0 +1,103 @@
+/*
+ * Calibration of the sound speed in a cold scene (0 °C), where the default temperature of 25 °C measures too far, and its record in the EEPROM.
+ * The checks:
+ *  - The calibration against the known distance removes the error of the temperature and finds the real sound speed
+ *  - It is saved and loaded by a new HCSR04 (a restart), and saving it again doesn't write the EEPROM
+ *  - A corrupt record (a changed byte of the speed, of the magic or of the checksum), an erased EEPROM and an implausible speed are rejected
+ *  - A calibration against a wrong known distance or without a target is rejected and the previous one stays
+ * The exit code is not 0 if a check fails.
+ *
+ * Build: g++ -std=c++11 -O2 -I ../arduino -I ../../src -I ../../src/hcsr04 SoundSpeedCalibrationDemo.cpp ../arduino/Arduino.cpp ../../src/hcsr04/HCSR04.cpp ../../src/hcsr04/ExtendedClock.cpp ../../src/hcsr04/HCSR04PinBackend.cpp ../../src/hcsr04/HCSR04Response.cpp ../../src/hcsr04/Measurement.cpp ../../src/hcsr04/AdaptivePingRate.cpp ../../src/hcsr04/SoundSpeed.cpp ../../src/hcsr04/SoundSpeedCalibration.cpp ../../src/hcsr04/DistanceUnits.cpp ../../src/hcsr04/TemperatureUnits.cpp ../../src/hcsr04/Utils.cpp ../../src/hcsr04/SceneSimulator.cpp ../../src/hcsr04/SimulatedSensor.cpp -o hcsr04-calibration-demo
+ * Usage: hcsr04-calibration-demo
+ */
+#include <HCSR04.h>
+#include <SceneSimulator.h>
+#include <SimulatedSensor.h>
+#include <ToolChecks.h>
+#include <EEPROM.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define DEMO_TARGET_DISTANCE_CM 100.0f
+#define DEMO_SCENARIO "seed 5\ntemperature 0\ntarget static 100 0\n"
+#define DEMO_CALIBRATION_ADDRESS 16
+#define DEMO_ERASED_ADDRESS 512
+#define DEMO_TOLERANCE_CM 0.5f
+
+static float measure(HCSR04& hcsr04) {
+    return hcsr04.measure(MeasurementConfiguration::builder().withSamples(5).withMeasurementDistanceUnit(DistanceUnit::CENTIMETERS).build()).getDistance();
+}
+
+/**
+ * Will change one byte of the saved record, check that it is rejected and restore it.
+ */
+static bool checkCorruptByteRejected(const size_t& offset, const char* name) {
+
+    int address = DEMO_CALIBRATION_ADDRESS + static_cast<int>(offset);
+    uint8_t original = EEPROM.read(address);
+
+    EEPROM.write(address, static_cast<uint8_t>(original ^ 0x10));
+
+    float soundSpeedCentimetersPerMicrosecond = 0;
+    bool isRejected = !readSoundSpeedCalibration(DEMO_CALIBRATION_ADDRESS, soundSpeedCentimetersPerMicrosecond) && soundSpeedCentimetersPerMicrosecond == 0;
+
+    EEPROM.write(address, original);
+
+    return check(isRejected, name);
+}
+
+int main() {
+
+    SceneSimulator scene;
+
+    if (!scene.loadScenario(DEMO_SCENARIO))
+        return 1;
+
+    SimulatedSensor simulatedSensor(scene, 0);
+    HCSR04 hcsr04(simulatedSensor);
+
+    float uncalibratedDistance = measure(hcsr04);
+    bool isCalibrated = hcsr04.calibrate(DEMO_TARGET_DISTANCE_CM, DistanceUnit::CENTIMETERS);
+    float calibratedDistance = measure(hcsr04);
+
+    printf("real sound speed %.5f cm/us, calibrated %.5f cm/us\n", scene.getSoundSpeedCentimetersPerMicrosecond(), hcsr04.getCalibratedSoundSpeed());
+    printf("target at %.1f cm: uncalibrated %.2f cm, calibrated %.2f cm\n", DEMO_TARGET_DISTANCE_CM, uncalibratedDistance, calibratedDistance);
+
+    bool isPassed = check(isCalibrated && fabsf(calibratedDistance - DEMO_TARGET_DISTANCE_CM) <= DEMO_TOLERANCE_CM, "the calibration removes the error of the temperature");
+    isPassed &= check(fabsf(uncalibratedDistance - DEMO_TARGET_DISTANCE_CM) > DEMO_TOLERANCE_CM, "  (without it the measurement is off)");
+
+    isPassed &= check(hcsr04.saveCalibration(DEMO_CALIBRATION_ADDRESS), "the calibration is saved");
+
+    unsigned long writesCount = EEPROM.getWritesCount();
+    hcsr04.saveCalibration(DEMO_CALIBRATION_ADDRESS);
+
+    isPassed &= check(EEPROM.getWritesCount() == writesCount, "saving the same calibration again doesn't write the EEPROM");
+
+    SimulatedSensor restartedSimulatedSensor(scene, 0);
+    HCSR04 restartedHCSR04(restartedSimulatedSensor);
+
+    isPassed &= check(restartedHCSR04.loadCalibration(DEMO_CALIBRATION_ADDRESS) && restartedHCSR04.getCalibratedSoundSpeed() == hcsr04.getCalibratedSoundSpeed(), "a restarted sensor loads the same sound speed");
+    isPassed &= check(fabsf(measure(restartedHCSR04) - DEMO_TARGET_DISTANCE_CM) <= DEMO_TOLERANCE_CM, "  and measures as accurately from its first measurement");
+
+    isPassed &= checkCorruptByteRejected(offsetof(SoundSpeedCalibrationRecord, magic), "a changed magic is rejected");
+    isPassed &= checkCorruptByteRejected(offsetof(SoundSpeedCalibrationRecord, soundSpeedCentimetersPerMicrosecond) + 1, "a changed byte of the sound speed is rejected");
+    isPassed &= checkCorruptByteRejected(offsetof(SoundSpeedCalibrationRecord, checksum), "a changed checksum is rejected");
+
+    HCSR04 erasedHCSR04(restartedSimulatedSensor);
+
+    isPassed &= check(!erasedHCSR04.loadCalibration(DEMO_ERASED_ADDRESS) && !erasedHCSR04.isCalibrated(), "an erased EEPROM is not a calibration");
+    isPassed &= check(!writeSoundSpeedCalibration(DEMO_ERASED_ADDRESS, 0.0200f) && !erasedHCSR04.loadCalibration(DEMO_ERASED_ADDRESS), "an implausible sound speed is not written");
+
+    float calibratedSoundSpeed = hcsr04.getCalibratedSoundSpeed();
+
+    isPassed &= check(!hcsr04.calibrate(DEMO_TARGET_DISTANCE_CM / 2, DistanceUnit::CENTIMETERS) && hcsr04.getCalibratedSoundSpeed() == calibratedSoundSpeed,
+                      "a calibration against a wrong distance is rejected, the previous stays");
+
+    scene.getTarget(0).bearingDegrees = 90;
+
+    isPassed &= check(!hcsr04.calibrate(DEMO_TARGET_DISTANCE_CM, DistanceUnit::CENTIMETERS) && hcsr04.getCalibratedSoundSpeed() == calibratedSoundSpeed,
+                      "a calibration without a target is rejected, the previous stays");
+
+    return isPassed ? 0 : 2;
+}
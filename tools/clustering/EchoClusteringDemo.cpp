@@ -0,0 +1,78 @@
+/*
+ * Clustering of the samples in a scene with two reflectors: a target and its multipath (ghost) echoes at double the distance.
+ * The average of the samples lands between both, the nearest cluster stays on the target. Both are compared over many measurements
+ * with the same samples, so the clustering needs no extra sampling rounds.
+ *
+ * Build: g++ -std=c++11 -O2 -I ../arduino -I ../../src -I ../../src/hcsr04 EchoClusteringDemo.cpp ../arduino/Arduino.cpp ../../src/hcsr04/EchoClusterer.cpp ../../src/hcsr04/HCSR04.cpp ../../src/hcsr04/ExtendedClock.cpp ../../src/hcsr04/HCSR04PinBackend.cpp ../../src/hcsr04/HCSR04Response.cpp ../../src/hcsr04/Measurement.cpp ../../src/hcsr04/AdaptivePingRate.cpp ../../src/hcsr04/SoundSpeed.cpp ../../src/hcsr04/SoundSpeedCalibration.cpp ../../src/hcsr04/DistanceUnits.cpp ../../src/hcsr04/TemperatureUnits.cpp ../../src/hcsr04/Utils.cpp ../../src/hcsr04/SceneSimulator.cpp ../../src/hcsr04/SimulatedSensor.cpp -o hcsr04-echo-clustering-demo
+ * Usage: hcsr04-echo-clustering-demo [measurements] [samples]
+ */
+#include <EchoClusterer.h>
+#include <SceneSimulator.h>
+#include <SimulatedSensor.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEMO_DEFAULT_MEASUREMENTS 1000
+#define DEMO_DEFAULT_SAMPLES 8
+#define DEMO_TARGET_DISTANCE_CM 120.0f
+#define DEMO_TOLERANCE_CM 2.0f
+#define DEMO_SCENARIO "seed 11\nmissed 0.05\nghost 0.3\ntarget static 120 0\n"
+
+int main(int argc, char** argv) {
+
+    unsigned long measurementsCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : DEMO_DEFAULT_MEASUREMENTS;
+    unsigned int samples = argc > 2 ? static_cast<unsigned int>(atoi(argv[2])) : DEMO_DEFAULT_SAMPLES;
+
+    if (measurementsCount == 0 || samples == 0) {
+        fprintf(stderr, "Usage: %s [measurements] [samples]\n", argv[0]);
+        return 1;
+    }
+
+    SceneSimulator scene;
+
+    if (!scene.loadScenario(DEMO_SCENARIO))
+        return 1;
+
+    SimulatedSensor simulatedSensor(scene, 0);
+    HCSR04 hcsr04(simulatedSensor);
+    EchoClusterer echoClusterer(hcsr04);
+
+    MeasurementConfiguration configuration = MeasurementConfiguration::builder()
+            .withSamples(samples)
+            .withTemperature(25, TemperatureUnit::CELSIUS)
+            .build();
+
+    ResolvedMeasurementConfiguration measurementConfiguration = hcsr04.resolveConfiguration(configuration);
+    HCSR04Response hcsr04Responses[samples];
+
+    unsigned long averageHitsCount = 0;
+    unsigned long nearestHitsCount = 0;
+    unsigned long multipleClustersCount = 0;
+
+    for (unsigned long i = 0; i < measurementsCount; i++) {
+
+        Measurement measurement = hcsr04.measure(configuration, hcsr04Responses);
+
+        EchoCluster clusters[2];
+        uint8_t clustersCount = echoClusterer.cluster(hcsr04Responses, measurement.getTakenSamples(), measurementConfiguration, clusters, 2);
+
+        averageHitsCount += fabsf(measurement.getDistance() - DEMO_TARGET_DISTANCE_CM) <= DEMO_TOLERANCE_CM ? 1 : 0;
+        nearestHitsCount += clustersCount > 0 && fabsf(clusters[0].distance - DEMO_TARGET_DISTANCE_CM) <= DEMO_TOLERANCE_CM ? 1 : 0;
+        multipleClustersCount += clustersCount > 1 ? 1 : 0;
+
+        if (i == 0) {
+            printf("average %.2f cm, clusters:", measurement.getDistance());
+
+            for (uint8_t c = 0; c < clustersCount; c++)
+                printf(" %.2f cm (%u samples, spread %.2f cm)", clusters[c].distance, clusters[c].supportCount, clusters[c].spread);
+
+            printf("\n");
+        }
+    }
+
+    printf("within %.0f cm of the target: average %lu/%lu, nearest cluster %lu/%lu, measurements with two clusters %lu\n",
+           DEMO_TOLERANCE_CM, averageHitsCount, measurementsCount, nearestHitsCount, measurementsCount, multipleClustersCount);
+
+    return nearestHitsCount >= averageHitsCount ? 0 : 2;
+}
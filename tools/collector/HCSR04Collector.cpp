@@ -0,0 +1,360 @@
+/*
+ * Host daemon, which collects the measurement lines of many devices (serial ports or pseudo terminals) in a single epoll loop
+ * and keeps statistics per device. The statistics are written to every client that connects to the given unix socket.
+ * The clients are written without blocking: what a client doesn't take at once is written when it is writable again,
+ * so a slow client never stalls the devices. Above COLLECTOR_MAX_STATISTICS_CLIENTS pending clients the new ones are dropped.
+ * With -m the latest measurement of each device is published to the given shared memory too (see SharedMeasurements.h).
+ *
+ * Build: g++ -std=c++11 -O2 -I ../../lib/measurementLineParser -I ../../src/hcsr04 HCSR04Collector.cpp SharedMeasurements.cpp ../../lib/measurementLineParser/MeasurementLineParser.cpp ../../lib/measurementLineParser/MeasurementLineStatistics.cpp -o hcsr04-collector
+ * Usage: hcsr04-collector [-m <shared memory name>] <statistics socket> <device>...
+ * Statistics: socat - UNIX-CONNECT:<statistics socket>
+ */
+#include <MeasurementLineParser.h>
+#include <MeasurementLineStatistics.h>
+#include "SharedMeasurements.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <time.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#define COLLECTOR_READ_BUFFER_SIZE 4096
+#define COLLECTOR_MAX_EVENTS 64
+#define COLLECTOR_STATISTICS_LINE_MAX_LENGTH 512
+#define COLLECTOR_MAX_STATISTICS_CLIENTS 16
+
+/*
+ * The epoll data of the two special descriptors. The devices are identified by their index
+ * and the statistics clients, which wait to be written, by their slot after STATISTICS_CLIENT_EVENT_ID.
+ */
+#define STATISTICS_SOCKET_EVENT_ID UINT64_MAX
+#define SIGNALS_EVENT_ID (UINT64_MAX - 1)
+#define STATISTICS_CLIENT_EVENT_ID (UINT64_MAX / 2)
+
+struct Endpoint {
+
+    const char* path;
+    int descriptor;
+    MeasurementLineParser parser;
+    MeasurementLineStatistics statistics;
+};
+
+/**
+ * A client of the statistics socket, which didn't take all of its statistics at once.
+ */
+struct StatisticsClient {
+
+    int descriptor;
+    std::string statistics;
+    size_t writtenCount;
+};
+
+/**
+ * Serial ports are switched to raw mode with the baud rate of the example sketch. Pseudo terminals are raw too.
+ */
+static void configureTerminal(const int& descriptor) {
+
+    struct termios terminal;
+
+    if (tcgetattr(descriptor, &terminal) != 0)
+        return;
+
+    cfmakeraw(&terminal);
+    cfsetispeed(&terminal, B9600);
+    cfsetospeed(&terminal, B9600);
+    tcsetattr(descriptor, TCSANOW, &terminal);
+}
+
+static bool addToEpoll(const int& epollDescriptor, const int& descriptor, const uint64_t& eventId, const uint32_t& events = EPOLLIN) {
+
+    struct epoll_event event;
+    event.events = events;
+    event.data.u64 = eventId;
+
+    return epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, descriptor, &event) == 0;
+}
+
+static int openStatisticsSocket(const char* path) {
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (strlen(path) >= sizeof(address.sun_path))
+        return -1;
+
+    strcpy(address.sun_path, path);
+    unlink(path);
+
+    int descriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (descriptor < 0)
+        return -1;
+
+    if (bind(descriptor, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0 || listen(descriptor, 16) != 0) {
+        close(descriptor);
+        return -1;
+    }
+
+    return descriptor;
+}
+
+static uint64_t getMonotonicTimeNS() {
+
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000ULL + static_cast<uint64_t>(time.tv_nsec);
+}
+
+static void publishEndpoint(SharedMeasurementsPublisher& publisher, const uint32_t& slotIndex, const Endpoint& endpoint, const MeasurementLine& measurementLine) {
+
+    SharedMeasurement sharedMeasurement;
+    memset(&sharedMeasurement, 0, sizeof(sharedMeasurement));
+
+    strncpy(sharedMeasurement.devicePath, endpoint.path, sizeof(sharedMeasurement.devicePath) - 1);
+    sharedMeasurement.measurementLine = measurementLine;
+    sharedMeasurement.publishedTimeNS = getMonotonicTimeNS();
+    sharedMeasurement.linesCount = endpoint.parser.getParsedLinesCount();
+    sharedMeasurement.distanceMean = endpoint.statistics.getDistanceMean();
+    sharedMeasurement.distanceVariance = endpoint.statistics.getDistanceVariance();
+
+    publisher.publish(slotIndex, sharedMeasurement);
+}
+
+/**
+ * Will feed everything that is available from the device to its parser.
+ *
+ * @return If the device is still open
+ */
+static bool readEndpoint(Endpoint& endpoint, SharedMeasurementsPublisher& publisher, const uint32_t& slotIndex) {
+
+    char buffer[COLLECTOR_READ_BUFFER_SIZE];
+    MeasurementLine measurementLine;
+
+    while (true) {
+        ssize_t readCount = read(endpoint.descriptor, buffer, sizeof(buffer));
+
+        if (readCount < 0 && errno == EINTR)
+            continue;
+
+        if (readCount < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+
+        if (readCount <= 0)
+            return false;
+
+        for (ssize_t i = 0; i < readCount; i++) {
+            if (endpoint.parser.feed(buffer[i], measurementLine)) {
+                endpoint.statistics.add(measurementLine);
+                publishEndpoint(publisher, slotIndex, endpoint, measurementLine);
+            }
+        }
+    }
+}
+
+/**
+ * @return The statistics of all devices, a line per device
+ */
+static std::string formatStatistics(const std::vector<Endpoint>& endpoints) {
+
+    std::string statistics;
+    char line[COLLECTOR_STATISTICS_LINE_MAX_LENGTH];
+
+    for (const Endpoint& endpoint : endpoints) {
+        const MeasurementLineStatistics& endpointStatistics = endpoint.statistics;
+
+        int lineLength = snprintf(line, sizeof(line),
+                                  "%s connected=%d lines=%lu invalid_lines=%lu unit=%s distances=%lu mean=%.2f variance=%.2f min=%.2f max=%.2f last=%.2f "
+                                  "valid_samples=%lu taken_samples=%lu signal_timed_out=%lu response_timed_out=%lu max_distance_exceeded=%lu cool_down=%lu\n",
+                                  endpoint.path, endpoint.descriptor >= 0, endpoint.parser.getParsedLinesCount(), endpoint.parser.getInvalidLinesCount(),
+                                  endpointStatistics.getDistanceUnit(), endpointStatistics.getDistancesCount(), endpointStatistics.getDistanceMean(), endpointStatistics.getDistanceVariance(),
+                                  endpointStatistics.getMinDistance(), endpointStatistics.getMaxDistance(), endpointStatistics.getLastDistance(),
+                                  endpointStatistics.getValidSamplesCount(), endpointStatistics.getTakenSamplesCount(), endpointStatistics.getSignalTimedOutCount(),
+                                  endpointStatistics.getResponseTimedOutCount(), endpointStatistics.getMaxDistanceExceededCount(), endpointStatistics.getResponseCoolDownCount());
+
+        if (lineLength > 0)
+            statistics.append(line, static_cast<size_t>(lineLength) < sizeof(line) ? static_cast<size_t>(lineLength) : sizeof(line) - 1);
+    }
+
+    return statistics;
+}
+
+/**
+ * Will write as much of the statistics as the client takes without blocking.
+ *
+ * @return If the client is still usable. False if it has closed or failed
+ */
+static bool writeStatisticsClient(StatisticsClient& client) {
+
+    while (client.writtenCount < client.statistics.size()) {
+        ssize_t writtenCount = write(client.descriptor, client.statistics.data() + client.writtenCount, client.statistics.size() - client.writtenCount);
+
+        if (writtenCount < 0 && errno == EINTR)
+            continue;
+
+        if (writtenCount < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+
+        if (writtenCount <= 0)
+            return false;
+
+        client.writtenCount += static_cast<size_t>(writtenCount);
+    }
+
+    return true;
+}
+
+/**
+ * Closing the descriptor removes it from the epoll too.
+ */
+static void closeStatisticsClient(StatisticsClient& client) {
+    close(client.descriptor);
+    client.descriptor = -1;
+    client.statistics.clear();
+    client.writtenCount = 0;
+}
+
+/**
+ * Will write the statistics to the new clients. A client, which doesn't take them at once, waits in a free slot for EPOLLOUT.
+ * If there is no free slot, the client is dropped.
+ */
+static void acceptStatisticsClients(const int& epollDescriptor, const int& statisticsDescriptor, const std::vector<Endpoint>& endpoints, std::vector<StatisticsClient>& clients) {
+
+    int clientDescriptor;
+
+    while ((clientDescriptor = accept4(statisticsDescriptor, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        StatisticsClient client = {clientDescriptor, formatStatistics(endpoints), 0};
+
+        if (!writeStatisticsClient(client) || client.writtenCount == client.statistics.size()) {
+            closeStatisticsClient(client);
+            continue;
+        }
+
+        size_t slotIndex = 0;
+
+        while (slotIndex < clients.size() && clients[slotIndex].descriptor >= 0)
+            slotIndex++;
+
+        if (slotIndex == clients.size() || !addToEpoll(epollDescriptor, client.descriptor, STATISTICS_CLIENT_EVENT_ID + slotIndex, EPOLLOUT)) {
+            fprintf(stderr, "hcsr04-collector: too many slow statistics clients, dropped one\n");
+            closeStatisticsClient(client);
+            continue;
+        }
+
+        clients[slotIndex] = client;
+    }
+}
+
+int main(int argumentsCount, char** arguments) {
+
+    const char* program = arguments[0];
+    const char* sharedMemoryName = nullptr;
+
+    if (argumentsCount >= 3 && strcmp(arguments[1], "-m") == 0) {
+        sharedMemoryName = arguments[2];
+        arguments += 2;
+        argumentsCount -= 2;
+    }
+
+    if (argumentsCount < 3) {
+        fprintf(stderr, "Usage: %s [-m <shared memory name>] <statistics socket> <device>...\n", program);
+        return 2;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &signals, nullptr);
+
+    int epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    int signalsDescriptor = signalfd(-1, &signals, SFD_CLOEXEC);
+    int statisticsDescriptor = openStatisticsSocket(arguments[1]);
+
+    if (epollDescriptor < 0 || signalsDescriptor < 0 || statisticsDescriptor < 0) {
+        perror("hcsr04-collector");
+        return 1;
+    }
+
+    SharedMeasurementsPublisher publisher;
+
+    if (sharedMemoryName != nullptr && !publisher.open(sharedMemoryName, static_cast<uint32_t>(argumentsCount - 2))) {
+        perror("hcsr04-collector: shared memory");
+        return 1;
+    }
+
+    addToEpoll(epollDescriptor, signalsDescriptor, SIGNALS_EVENT_ID);
+    addToEpoll(epollDescriptor, statisticsDescriptor, STATISTICS_SOCKET_EVENT_ID);
+
+    std::vector<Endpoint> endpoints(static_cast<size_t>(argumentsCount - 2));
+
+    for (size_t i = 0; i < endpoints.size(); i++) {
+        Endpoint& endpoint = endpoints[i];
+        endpoint.path = arguments[i + 2];
+        endpoint.descriptor = open(endpoint.path, O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+
+        if (endpoint.descriptor < 0) {
+            fprintf(stderr, "hcsr04-collector: %s: %s\n", endpoint.path, strerror(errno));
+            continue;
+        }
+
+        configureTerminal(endpoint.descriptor);
+        addToEpoll(epollDescriptor, endpoint.descriptor, i);
+    }
+
+    std::vector<StatisticsClient> statisticsClients(COLLECTOR_MAX_STATISTICS_CLIENTS, StatisticsClient{-1, std::string(), 0});
+    struct epoll_event events[COLLECTOR_MAX_EVENTS];
+    bool isRunning = true;
+
+    while (isRunning) {
+        int eventsCount = epoll_wait(epollDescriptor, events, COLLECTOR_MAX_EVENTS, -1);
+
+        if (eventsCount < 0 && errno == EINTR)
+            continue;
+
+        if (eventsCount < 0) {
+            perror("hcsr04-collector");
+            break;
+        }
+
+        for (int i = 0; i < eventsCount; i++) {
+            uint64_t eventId = events[i].data.u64;
+
+            if (eventId == SIGNALS_EVENT_ID) {
+                isRunning = false;
+            } else if (eventId == STATISTICS_SOCKET_EVENT_ID) {
+                acceptStatisticsClients(epollDescriptor, statisticsDescriptor, endpoints, statisticsClients);
+            } else if (eventId >= STATISTICS_CLIENT_EVENT_ID) {
+                StatisticsClient& client = statisticsClients[eventId - STATISTICS_CLIENT_EVENT_ID];
+
+                if (client.descriptor >= 0 && (!writeStatisticsClient(client) || client.writtenCount == client.statistics.size()))
+                    closeStatisticsClient(client);
+            } else {
+                Endpoint& endpoint = endpoints[eventId];
+
+                if (endpoint.descriptor >= 0 && !readEndpoint(endpoint, publisher, static_cast<uint32_t>(eventId))) {
+                    fprintf(stderr, "hcsr04-collector: %s: disconnected\n", endpoint.path);
+                    close(endpoint.descriptor);
+                    endpoint.descriptor = -1;
+                    endpoint.parser.reset();
+                }
+            }
+        }
+    }
+
+    unlink(arguments[1]);
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Load generator for the collector. Opens the given count of pseudo terminals and writes measurement lines to each of them,
+ * in the format of the example sketch, at the given rate per device. The paths of the pseudo terminals are printed, one per line.
+ *
+ * Build: g++ -std=c++11 -O2 HCSR04DeviceSimulator.cpp -o hcsr04-device-simulator
+ * Usage: hcsr04-device-simulator <devices> <lines per second> <seconds>
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#define SIMULATOR_LINE_MAX_LENGTH 192
+
+static int openPseudoTerminal() {
+
+    int descriptor = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (descriptor < 0 || grantpt(descriptor) != 0 || unlockpt(descriptor) != 0)
+        return -1;
+
+    struct termios terminal;
+
+    if (tcgetattr(descriptor, &terminal) == 0) {
+        cfmakeraw(&terminal);
+        tcsetattr(descriptor, TCSANOW, &terminal);
+    }
+
+    return descriptor;
+}
+
+int main(int argumentsCount, char** arguments) {
+
+    if (argumentsCount < 4) {
+        fprintf(stderr, "Usage: %s <devices> <lines per second> <seconds>\n", arguments[0]);
+        return 2;
+    }
+
+    int devicesCount = atoi(arguments[1]);
+    long linesPerSecond = atol(arguments[2]);
+    long seconds = atol(arguments[3]);
+
+    std::vector<int> descriptors;
+
+    for (int i = 0; i < devicesCount; i++) {
+        int descriptor = openPseudoTerminal();
+
+        if (descriptor < 0) {
+            perror("hcsr04-device-simulator");
+            return 1;
+        }
+
+        descriptors.push_back(descriptor);
+        printf("%s\n", ptsname(descriptor));
+    }
+
+    fflush(stdout);
+
+    /*
+     * Give the collector time to open the pseudo terminals, the lines written before that are lost.
+     */
+    sleep(1);
+
+    long periodNS = linesPerSecond > 0 ? 1000000000L / linesPerSecond : 1000000000L;
+    struct timespec period = {periodNS / 1000000000L, periodNS % 1000000000L};
+    char line[SIMULATOR_LINE_MAX_LENGTH];
+    unsigned long writtenLinesCount = 0;
+
+    for (long tick = 0; tick < seconds * linesPerSecond; tick++) {
+
+        for (size_t i = 0; i < descriptors.size(); i++) {
+            float distance = 20.00f + static_cast<float>(i) + static_cast<float>(tick % 10) / 10.00f;
+            unsigned int timedOutCount = tick % 50 == 0 ? 1 : 0;
+
+            int lineLength = snprintf(line, sizeof(line),
+                                      "Distance: %.2f cm, Valid Samples: %u/3 [Signal Timed Out Count: %u, Response Timed Out Count: 0, Max Distance Exceeded Count: 0, Response Cool Down: off]\n",
+                                      distance, 3 - timedOutCount, timedOutCount);
+
+            if (write(descriptors[i], line, static_cast<size_t>(lineLength)) == lineLength)
+                writtenLinesCount++;
+        }
+
+        struct timespec remaining = period;
+
+        while (nanosleep(&remaining, &remaining) != 0) {
+
+            if (errno != EINTR) {
+                perror("hcsr04-device-simulator");
+                return 1;
+            }
+        }
+    }
+
+    fprintf(stderr, "hcsr04-device-simulator: written %lu lines\n", writtenLinesCount);
+
+    sleep(1);
+
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include "SharedMeasurements.h"
+#include <fcntl.h>
+#include <new>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * The slots start after the header, aligned for the SeqLock.
+ */
+static size_t calculateSlotsOffset() {
+    size_t alignment = __alignof__(SharedMeasurementSlot);
+    return (sizeof(SharedMeasurementsHeader) + alignment - 1) / alignment * alignment;
+}
+
+static size_t calculateMappedSize(const uint32_t& slotsCount) {
+    return calculateSlotsOffset() + slotsCount * sizeof(SharedMeasurementSlot);
+}
+
+SharedMeasurementsPublisher::SharedMeasurementsPublisher() : header(nullptr), slots(nullptr), mappedSize(0) {
+    this->name[0] = '\0';
+}
+
+SharedMeasurementsPublisher::~SharedMeasurementsPublisher() {
+    this->close();
+}
+
+/**
+ * Will create (or replace) the shared memory with the given count of empty slots.
+ *
+ * @param name The name of the shared memory, for example /hcsr04
+ * @return If the memory was created and mapped
+ */
+bool SharedMeasurementsPublisher::open(const char* name, const uint32_t& slotsCount) {
+
+    this->close();
+
+    if (strlen(name) >= sizeof(this->name))
+        return false;
+
+    shm_unlink(name);
+
+    int descriptor = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+
+    if (descriptor < 0)
+        return false;
+
+    size_t mappedSize = calculateMappedSize(slotsCount);
+    void* memory = ftruncate(descriptor, static_cast<off_t>(mappedSize)) == 0 ? mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0) : MAP_FAILED;
+
+    ::close(descriptor);
+
+    if (memory == MAP_FAILED) {
+        shm_unlink(name);
+        return false;
+    }
+
+    this->slots = reinterpret_cast<SharedMeasurementSlot*>(static_cast<unsigned char*>(memory) + calculateSlotsOffset());
+
+    for (uint32_t i = 0; i < slotsCount; i++)
+        new(&this->slots[i]) SharedMeasurementSlot();
+
+    this->header = static_cast<SharedMeasurementsHeader*>(memory);
+    this->header->version = SHARED_MEASUREMENTS_VERSION;
+    this->header->slotsCount = slotsCount;
+    this->header->slotSize = sizeof(SharedMeasurementSlot);
+    this->header->publishedCount = 0;
+    __atomic_store_n(&this->header->magic, SHARED_MEASUREMENTS_MAGIC, __ATOMIC_RELEASE);
+
+    this->mappedSize = mappedSize;
+    strcpy(this->name, name);
+
+    return true;
+}
+
+/**
+ * Will unmap and remove the shared memory. The readers that have it mapped keep the last values.
+ */
+void SharedMeasurementsPublisher::close() {
+
+    if (this->header == nullptr)
+        return;
+
+    munmap(this->header, this->mappedSize);
+    shm_unlink(this->name);
+
+    this->header = nullptr;
+    this->slots = nullptr;
+    this->mappedSize = 0;
+}
+
+void SharedMeasurementsPublisher::publish(const uint32_t& slotIndex, const SharedMeasurement& sharedMeasurement) {
+
+    if (this->header == nullptr || slotIndex >= this->header->slotsCount)
+        return;
+
+    this->slots[slotIndex].write(sharedMeasurement);
+    __atomic_fetch_add(&this->header->publishedCount, 1, __ATOMIC_RELEASE);
+}
+
+uint32_t SharedMeasurementsPublisher::getSlotsCount() const {
+    return this->header == nullptr ? 0 : this->header->slotsCount;
+}
+
+SharedMeasurementsReader::SharedMeasurementsReader() : header(nullptr), slots(nullptr), mappedSize(0) {
+}
+
+SharedMeasurementsReader::~SharedMeasurementsReader() {
+    this->close();
+}
+
+/**
+ * @param name The name of the shared memory of the publisher
+ * @return If the memory was mapped and has the layout of this build
+ */
+bool SharedMeasurementsReader::open(const char* name) {
+
+    this->close();
+
+    int descriptor = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+
+    if (descriptor < 0)
+        return false;
+
+    struct stat status;
+    void* memory = MAP_FAILED;
+
+    if (fstat(descriptor, &status) == 0 && static_cast<size_t>(status.st_size) >= sizeof(SharedMeasurementsHeader))
+        memory = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+
+    ::close(descriptor);
+
+    if (memory == MAP_FAILED)
+        return false;
+
+    const SharedMeasurementsHeader* header = static_cast<const SharedMeasurementsHeader*>(memory);
+
+    bool isLayoutValid = __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) == SHARED_MEASUREMENTS_MAGIC
+                         && header->version == SHARED_MEASUREMENTS_VERSION
+                         && header->slotSize == sizeof(SharedMeasurementSlot)
+                         && calculateMappedSize(header->slotsCount) <= static_cast<size_t>(status.st_size);
+
+    if (!isLayoutValid) {
+        munmap(memory, static_cast<size_t>(status.st_size));
+        return false;
+    }
+
+    this->header = header;
+    this->slots = reinterpret_cast<const SharedMeasurementSlot*>(static_cast<const unsigned char*>(memory) + calculateSlotsOffset());
+    this->mappedSize = static_cast<size_t>(status.st_size);
+
+    return true;
+}
+
+void SharedMeasurementsReader::close() {
+
+    if (this->header == nullptr)
+        return;
+
+    munmap(const_cast<SharedMeasurementsHeader*>(this->header), this->mappedSize);
+
+    this->header = nullptr;
+    this->slots = nullptr;
+    this->mappedSize = 0;
+}
+
+uint32_t SharedMeasurementsReader::getSlotsCount() const {
+    return this->header == nullptr ? 0 : this->header->slotsCount;
+}
+
+/**
+ * @return How many measurements were published in all of the slots
+ */
+uint64_t SharedMeasurementsReader::getPublishedCount() const {
+    return this->header == nullptr ? 0 : __atomic_load_n(&this->header->publishedCount, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @return Changes with every publication in the slot, so the reader can skip the copy if it already has the latest value. 0 If there is no such slot
+ */
+SharedMeasurementSlot::Sequence SharedMeasurementsReader::getSequence(const uint32_t& slotIndex) const {
+    return slotIndex < this->getSlotsCount() ? this->slots[slotIndex].getSequence() : 0;
+}
+
+/**
+ * A single attempt to read the slot. False if the publisher was writing the slot at the same time.
+ */
+bool SharedMeasurementsReader::tryRead(const uint32_t& slotIndex, SharedMeasurement& sharedMeasurement) const {
+    return slotIndex < this->getSlotsCount() && this->slots[slotIndex].tryRead(sharedMeasurement);
+}
+
+/**
+ * Will read the slot until the copy is consistent.
+ *
+ * @return How many attempts were needed. 0 If there is no such slot
+ */
+unsigned int SharedMeasurementsReader::read(const uint32_t& slotIndex, SharedMeasurement& sharedMeasurement) const {
+    return slotIndex < this->getSlotsCount() ? this->slots[slotIndex].read(sharedMeasurement) : 0;
+}
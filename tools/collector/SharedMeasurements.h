@@ -0,0 +1,103 @@
+#ifndef HC_SR04_SHAREDMEASUREMENTS_H
+#define HC_SR04_SHAREDMEASUREMENTS_H
+
+#include <MeasurementLineParser.h>
+#include <SeqLock.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define SHARED_MEASUREMENTS_MAGIC 0x48435352
+#define SHARED_MEASUREMENTS_VERSION 1
+#define SHARED_MEASUREMENTS_DEVICE_PATH_MAX_LENGTH 64
+
+/**
+ * The latest measurement of one device, as the readers see it.
+ */
+struct SharedMeasurement {
+
+    char devicePath[SHARED_MEASUREMENTS_DEVICE_PATH_MAX_LENGTH];
+    MeasurementLine measurementLine;
+    uint64_t publishedTimeNS;
+    uint64_t linesCount;
+    float distanceMean;
+    float distanceVariance;
+};
+
+/**
+ * The beginning of the shared memory. It is written once, before the slots. The readers check the magic, the version and the sizes,
+ * so a reader built with another layout refuses the memory instead of reading garbage.
+ */
+struct SharedMeasurementsHeader {
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotsCount;
+    uint32_t slotSize;
+    uint64_t publishedCount;
+};
+
+typedef SeqLock<SharedMeasurement> SharedMeasurementSlot;
+
+/**
+ * Publishes the latest measurement of each device into a named POSIX shared memory (/dev/shm on Linux).
+ * The memory is a header and a SeqLock slot per device, so any number of local processes can map it and take consistent snapshots
+ * without system calls and without the publisher knowing about them.
+ */
+class SharedMeasurementsPublisher {
+
+private:
+
+    SharedMeasurementsHeader* header;
+    SharedMeasurementSlot* slots;
+    size_t mappedSize;
+    char name[SHARED_MEASUREMENTS_DEVICE_PATH_MAX_LENGTH];
+
+public:
+
+    SharedMeasurementsPublisher();
+
+    ~SharedMeasurementsPublisher();
+
+    bool open(const char* name, const uint32_t& slotsCount);
+
+    void close();
+
+    void publish(const uint32_t& slotIndex, const SharedMeasurement& sharedMeasurement);
+
+    uint32_t getSlotsCount() const;
+};
+
+/**
+ * Maps the shared memory of a publisher read only.
+ */
+class SharedMeasurementsReader {
+
+private:
+
+    const SharedMeasurementsHeader* header;
+    const SharedMeasurementSlot* slots;
+    size_t mappedSize;
+
+public:
+
+    SharedMeasurementsReader();
+
+    ~SharedMeasurementsReader();
+
+    bool open(const char* name);
+
+    void close();
+
+    uint32_t getSlotsCount() const;
+
+    uint64_t getPublishedCount() const;
+
+    SharedMeasurementSlot::Sequence getSequence(const uint32_t& slotIndex) const;
+
+    bool tryRead(const uint32_t& slotIndex, SharedMeasurement& sharedMeasurement) const;
+
+    unsigned int read(const uint32_t& slotIndex, SharedMeasurement& sharedMeasurement) const;
+};
+
+
+#endif //HC_SR04_SHAREDMEASUREMENTS_H
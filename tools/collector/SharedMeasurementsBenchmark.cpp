@@ -0,0 +1,191 @@
+/*
+ * Benchmark of the shared measurements under contention. One publisher thread writes the slots round robin as fast as it can,
+ * while the given count of reader threads map the memory on their own and read random slots. Reports the throughput of both sides,
+ * the latency of the publications and of the consistent reads, and how often a read had to be retried.
+ *
+ * Build: g++ -std=c++11 -O2 -pthread -I ../../lib/measurementLineParser -I ../../src/hcsr04 SharedMeasurementsBenchmark.cpp SharedMeasurements.cpp -o hcsr04-shared-measurements-benchmark
+ * Usage: hcsr04-shared-measurements-benchmark <readers> <slots> <seconds>
+ */
+#include "SharedMeasurements.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * The latencies are counted in buckets of powers of two nanoseconds, so the measuring doesn't allocate or sort.
+ */
+#define LATENCY_BUCKETS_COUNT 40
+
+struct LatencyHistogram {
+
+    uint64_t buckets[LATENCY_BUCKETS_COUNT];
+    uint64_t count;
+    uint64_t sumNS;
+
+    void add(const uint64_t& latencyNS) {
+        unsigned int bucket = latencyNS == 0 ? 0 : 64 - __builtin_clzll(latencyNS);
+        this->buckets[bucket < LATENCY_BUCKETS_COUNT ? bucket : LATENCY_BUCKETS_COUNT - 1]++;
+        this->count++;
+        this->sumNS += latencyNS;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (unsigned int i = 0; i < LATENCY_BUCKETS_COUNT; i++)
+            this->buckets[i] += other.buckets[i];
+
+        this->count += other.count;
+        this->sumNS += other.sumNS;
+    }
+
+    /**
+     * @return The upper bound of the bucket, which contains the given percentile
+     */
+    uint64_t getPercentileNS(const double& percentile) const {
+        uint64_t target = static_cast<uint64_t>(percentile * static_cast<double>(this->count));
+        uint64_t seen = 0;
+
+        for (unsigned int i = 0; i < LATENCY_BUCKETS_COUNT; i++) {
+            seen += this->buckets[i];
+
+            if (seen > target)
+                return 1ULL << i;
+        }
+
+        return 1ULL << (LATENCY_BUCKETS_COUNT - 1);
+    }
+
+    double getAverageNS() const {
+        return this->count == 0 ? 0 : static_cast<double>(this->sumNS) / static_cast<double>(this->count);
+    }
+};
+
+struct ReaderResult {
+
+    LatencyHistogram latencies;
+    uint64_t attemptsCount;
+    uint64_t inconsistentCount;
+};
+
+static uint64_t getMonotonicTimeNS() {
+
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000ULL + static_cast<uint64_t>(time.tv_nsec);
+}
+
+/**
+ * The publisher writes the same value in every float of the line, so a torn read is detected by the reader.
+ */
+static void fillMeasurement(SharedMeasurement& sharedMeasurement, const uint64_t& sequence) {
+    sharedMeasurement.linesCount = sequence;
+    sharedMeasurement.measurementLine.distance = static_cast<float>(sequence % 1000);
+    sharedMeasurement.distanceMean = static_cast<float>(sequence % 1000);
+    sharedMeasurement.distanceVariance = static_cast<float>(sequence % 1000);
+    sharedMeasurement.measurementLine.takenSamples = sequence;
+}
+
+static bool isConsistent(const SharedMeasurement& sharedMeasurement) {
+    return sharedMeasurement.measurementLine.distance == sharedMeasurement.distanceMean
+           && sharedMeasurement.distanceMean == sharedMeasurement.distanceVariance
+           && sharedMeasurement.measurementLine.takenSamples == sharedMeasurement.linesCount;
+}
+
+static void runReader(const char* name, const uint64_t endTimeNS, const unsigned int seed, ReaderResult* result) {
+
+    SharedMeasurementsReader reader;
+
+    if (!reader.open(name))
+        return;
+
+    SharedMeasurement sharedMeasurement;
+    unsigned int randomState = seed;
+
+    while (getMonotonicTimeNS() < endTimeNS) {
+        uint32_t slotIndex = static_cast<uint32_t>(rand_r(&randomState)) % reader.getSlotsCount();
+
+        uint64_t startTimeNS = getMonotonicTimeNS();
+        unsigned int attemptsCount = reader.read(slotIndex, sharedMeasurement);
+        result->latencies.add(getMonotonicTimeNS() - startTimeNS);
+
+        result->attemptsCount += attemptsCount;
+        result->inconsistentCount += isConsistent(sharedMeasurement) ? 0 : 1;
+    }
+}
+
+int main(int argumentsCount, char** arguments) {
+
+    if (argumentsCount < 4) {
+        fprintf(stderr, "Usage: %s <readers> <slots> <seconds>\n", arguments[0]);
+        return 2;
+    }
+
+    unsigned int readersCount = static_cast<unsigned int>(atoi(arguments[1]));
+    uint32_t slotsCount = static_cast<uint32_t>(atoi(arguments[2]));
+    uint64_t durationNS = static_cast<uint64_t>(atof(arguments[3]) * 1e9);
+
+    char name[SHARED_MEASUREMENTS_DEVICE_PATH_MAX_LENGTH];
+    snprintf(name, sizeof(name), "/hcsr04-benchmark-%d", static_cast<int>(getpid()));
+
+    SharedMeasurementsPublisher publisher;
+
+    if (slotsCount == 0 || !publisher.open(name, slotsCount)) {
+        perror("hcsr04-shared-measurements-benchmark");
+        return 1;
+    }
+
+    SharedMeasurement sharedMeasurement;
+    memset(&sharedMeasurement, 0, sizeof(sharedMeasurement));
+
+    for (uint32_t i = 0; i < slotsCount; i++)
+        publisher.publish(i, sharedMeasurement);
+
+    uint64_t endTimeNS = getMonotonicTimeNS() + durationNS;
+
+    std::vector<ReaderResult> readerResults(readersCount);
+    std::vector<std::thread> readers;
+
+    for (unsigned int i = 0; i < readersCount; i++) {
+        memset(&readerResults[i], 0, sizeof(ReaderResult));
+        readers.emplace_back(runReader, name, endTimeNS, i + 1, &readerResults[i]);
+    }
+
+    LatencyHistogram publishLatencies;
+    memset(&publishLatencies, 0, sizeof(publishLatencies));
+
+    for (uint64_t sequence = 1; getMonotonicTimeNS() < endTimeNS; sequence++) {
+        fillMeasurement(sharedMeasurement, sequence);
+
+        uint64_t startTimeNS = getMonotonicTimeNS();
+        publisher.publish(static_cast<uint32_t>(sequence % slotsCount), sharedMeasurement);
+        publishLatencies.add(getMonotonicTimeNS() - startTimeNS);
+    }
+
+    ReaderResult total;
+    memset(&total, 0, sizeof(total));
+
+    for (unsigned int i = 0; i < readersCount; i++) {
+        readers[i].join();
+        total.latencies.merge(readerResults[i].latencies);
+        total.attemptsCount += readerResults[i].attemptsCount;
+        total.inconsistentCount += readerResults[i].inconsistentCount;
+    }
+
+    double seconds = static_cast<double>(durationNS) / 1e9;
+
+    printf("slot size: %zu bytes, slots: %u, readers: %u\n", sizeof(SharedMeasurementSlot), slotsCount, readersCount);
+    printf("publisher: %.0f writes/s, latency avg %.0f ns, p50 <= %llu ns, p99 <= %llu ns\n",
+           static_cast<double>(publishLatencies.count) / seconds, publishLatencies.getAverageNS(),
+           static_cast<unsigned long long>(publishLatencies.getPercentileNS(0.50)), static_cast<unsigned long long>(publishLatencies.getPercentileNS(0.99)));
+    printf("readers: %.0f reads/s, latency avg %.0f ns, p50 <= %llu ns, p99 <= %llu ns, retries %.4f%%, inconsistent %llu\n",
+           static_cast<double>(total.latencies.count) / seconds, total.latencies.getAverageNS(),
+           static_cast<unsigned long long>(total.latencies.getPercentileNS(0.50)), static_cast<unsigned long long>(total.latencies.getPercentileNS(0.99)),
+           total.latencies.count == 0 ? 0 : 100.0 * static_cast<double>(total.attemptsCount - total.latencies.count) / static_cast<double>(total.latencies.count),
+           static_cast<unsigned long long>(total.inconsistentCount));
+
+    return total.inconsistentCount == 0 ? 0 : 1;
+}
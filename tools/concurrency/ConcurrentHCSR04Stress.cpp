@@ -0,0 +1,156 @@
+/*
+ * Stress of ConcurrentHCSR04 with std::thread. One thread samples a simulated scene as fast as it can,
+ * the readers read the latest measurement without pause and the configurators change the samples and the max distance all the time.
+ * Every read measurement is checked for consistency: its counts must add up to the taken samples, which must be one of the configured,
+ * its distance must be within its min and max and its sequence must never go back.
+ * Run it also built with -fsanitize=thread, which must report nothing.
+ *
+ * Build: g++ -std=c++11 -O2 -pthread -I ../arduino -I ../../src -I ../../src/hcsr04 ConcurrentHCSR04Stress.cpp ../arduino/Arduino.cpp ../../src/hcsr04/ConcurrentHCSR04.cpp ../../src/hcsr04/HCSR04.cpp ../../src/hcsr04/ExtendedClock.cpp ../../src/hcsr04/HCSR04PinBackend.cpp ../../src/hcsr04/HCSR04Response.cpp ../../src/hcsr04/Measurement.cpp ../../src/hcsr04/AdaptivePingRate.cpp ../../src/hcsr04/SoundSpeed.cpp ../../src/hcsr04/SoundSpeedCalibration.cpp ../../src/hcsr04/DistanceUnits.cpp ../../src/hcsr04/TemperatureUnits.cpp ../../src/hcsr04/Utils.cpp ../../src/hcsr04/SceneSimulator.cpp ../../src/hcsr04/SimulatedSensor.cpp -o hcsr04-concurrent-stress
+ * Usage: hcsr04-concurrent-stress [seconds] [readers] [configurators]
+ */
+#include <ConcurrentHCSR04.h>
+#include <SceneSimulator.h>
+#include <SimulatedSensor.h>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+#define STRESS_DEFAULT_SECONDS 5
+#define STRESS_DEFAULT_READERS 4
+#define STRESS_DEFAULT_CONFIGURATORS 2
+#define STRESS_MAX_SAMPLES 5
+
+/*
+ * The target moves, so the distances of two measurements differ and a torn read has inconsistent statistics
+ */
+#define STRESS_SCENARIO "seed 7\nmissed 0.05\nghost 0.05\ntarget oscillating 150 100 3000 0\n"
+
+struct ReaderResult {
+    unsigned long readsCount;
+    unsigned long newMeasurementsCount;
+    unsigned long inconsistenciesCount;
+};
+
+/**
+ * The ghost echoes and the max distances make invalid samples, but the counts of a measurement always add up.
+ */
+static bool isMeasurementConsistent(const Measurement& measurement) {
+
+    unsigned long takenSamples = measurement.getTakenSamples();
+
+    if (takenSamples < 1 || takenSamples > STRESS_MAX_SAMPLES)
+        return false;
+
+    if (measurement.getValidMeasurementsCount() + measurement.getInvalidMeasurementsCount() != takenSamples)
+        return false;
+
+    if (measurement.getValidMeasurementsCount() == 0)
+        return measurement.getDistance() == 0;
+
+    return measurement.getMinDistance() <= measurement.getDistance() + 0.001f && measurement.getDistance() <= measurement.getMaxDistance() + 0.001f;
+}
+
+static void read(const ConcurrentHCSR04& concurrentHCSR04, const std::atomic<bool>& isStopped, ReaderResult& result) {
+
+    SeqLock<Measurement>::Sequence lastSequence = 0;
+    Measurement measurement;
+
+    while (!isStopped.load(std::memory_order_acquire)) {
+
+        SeqLock<Measurement>::Sequence sequence = concurrentHCSR04.getMeasurementSequence();
+
+        if (!concurrentHCSR04.getLatestMeasurement(measurement))
+            continue;
+
+        result.readsCount++;
+        result.newMeasurementsCount += sequence != lastSequence ? 1 : 0;
+
+        if (SeqLock<Measurement>::isSequenceAfter(lastSequence, sequence) || !isMeasurementConsistent(measurement))
+            result.inconsistenciesCount++;
+
+        lastSequence = sequence;
+    }
+}
+
+static void configure(ConcurrentHCSR04& concurrentHCSR04, const std::atomic<bool>& isStopped, unsigned long& updatesCount, const unsigned int& seed) {
+
+    unsigned int state = seed;
+
+    while (!isStopped.load(std::memory_order_acquire)) {
+        state = state * 1103515245 + 12345;
+
+        unsigned int samples = 1 + (state >> 16) % STRESS_MAX_SAMPLES;
+        float maxDistanceCM = 150.0f + static_cast<float>((state >> 8) % 250);
+
+        concurrentHCSR04.setConfiguration(MeasurementConfiguration::builder()
+                                                  .withSamples(samples)
+                                                  .withMaxDistance(maxDistanceCM, DistanceUnit::CENTIMETERS)
+                                                  .build());
+        updatesCount++;
+
+        std::this_thread::yield();
+    }
+}
+
+int main(int argc, char** argv) {
+
+    int seconds = argc > 1 ? atoi(argv[1]) : STRESS_DEFAULT_SECONDS;
+    int readersCount = argc > 2 ? atoi(argv[2]) : STRESS_DEFAULT_READERS;
+    int configuratorsCount = argc > 3 ? atoi(argv[3]) : STRESS_DEFAULT_CONFIGURATORS;
+
+    if (seconds <= 0 || readersCount <= 0 || configuratorsCount < 0) {
+        fprintf(stderr, "Usage: %s [seconds] [readers] [configurators]\n", argv[0]);
+        return 1;
+    }
+
+    SceneSimulator scene;
+
+    if (!scene.loadScenario(STRESS_SCENARIO))
+        return 1;
+
+    SimulatedSensor simulatedSensor(scene, 0);
+    HCSR04 hcsr04(simulatedSensor);
+    ConcurrentHCSR04 concurrentHCSR04(hcsr04, MeasurementConfiguration::builder().withSamples(3).build());
+
+    std::atomic<bool> isStopped(false);
+    std::vector<ReaderResult> readerResults(readersCount, ReaderResult{0, 0, 0});
+    std::vector<unsigned long> configuratorUpdates(configuratorsCount, 0);
+    std::vector<std::thread> threads;
+
+    threads.emplace_back([&concurrentHCSR04]() { concurrentHCSR04.run(); });
+
+    for (int i = 0; i < readersCount; i++)
+        threads.emplace_back(read, std::cref(concurrentHCSR04), std::cref(isStopped), std::ref(readerResults[i]));
+
+    for (int i = 0; i < configuratorsCount; i++)
+        threads.emplace_back(configure, std::ref(concurrentHCSR04), std::cref(isStopped), std::ref(configuratorUpdates[i]), static_cast<unsigned int>(i + 1));
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+    isStopped.store(true, std::memory_order_release);
+    concurrentHCSR04.stop();
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    ReaderResult total = {0, 0, 0};
+
+    for (const ReaderResult& readerResult : readerResults) {
+        total.readsCount += readerResult.readsCount;
+        total.newMeasurementsCount += readerResult.newMeasurementsCount;
+        total.inconsistenciesCount += readerResult.inconsistenciesCount;
+    }
+
+    unsigned long updatesCount = 0;
+
+    for (unsigned long configuratorUpdatesCount : configuratorUpdates)
+        updatesCount += configuratorUpdatesCount;
+
+    printf("samples %lu, reads %lu (%lu new), configuration updates %lu, inconsistent reads %lu\n",
+           static_cast<unsigned long>(concurrentHCSR04.getSamplesCount()), total.readsCount, total.newMeasurementsCount, updatesCount, total.inconsistenciesCount);
+
+    return total.inconsistenciesCount == 0 ? 0 : 2;
+}
@@ -0,0 +1,133 @@
+/*
+ * Stress of SampleQueue with std::thread. One thread is the producer (the interrupt) and pushes EchoSamples with increasing sequences
+ * as fast as it can, the other is the consumer (the main loop) and pops them. Both pause at random now and then, so the queue is often full and often empty.
+ * The checks, for each capacity:
+ *  - Every popped sample is whole: its signal length and flags are derived from its sequence, so a torn or stale record doesn't match
+ *  - The sequences only grow and the gaps between them are exactly the dropped samples
+ *  - Every pushed sample is popped exactly once and the pushed and dropped samples add up to the attempts
+ * Run it also built with -fsanitize=thread, which must report nothing.
+ *
+ * Build: g++ -std=c++11 -O2 -pthread -I ../arduino -I ../../src -I ../../src/hcsr04 SampleQueueStress.cpp ../arduino/Arduino.cpp ../../src/hcsr04/HCSR04Response.cpp -o hcsr04-sample-queue-stress
+ * Usage: hcsr04-sample-queue-stress [seconds per capacity]
+ */
+#include <EchoSample.h>
+#include <SampleQueue.h>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+#define STRESS_DEFAULT_SECONDS 2
+#define STRESS_PAUSE_ONE_IN 4096
+
+struct QueueStressResult {
+    unsigned long attemptsCount;
+    unsigned long poppedCount;
+    unsigned long gapsCount;
+    unsigned long tornCount;
+    unsigned long reorderedCount;
+    uint32_t lastSequence;
+};
+
+static EchoSample toEchoSample(const uint32_t& sequence) {
+    return EchoSample{sequence, static_cast<uint16_t>((sequence * 2654435761UL) >> 16), static_cast<uint8_t>(sequence % 2 == 0 ? ECHO_SAMPLE_FLAG_RESPONSE_TIMED_OUT : 0)};
+}
+
+static bool isEchoSampleWhole(const EchoSample& echoSample) {
+    EchoSample expected = toEchoSample(echoSample.triggerTimeUS);
+    return echoSample.signalLengthUS == expected.signalLengthUS && echoSample.flags == expected.flags;
+}
+
+/**
+ * Spins for a while, so the other side runs alone and fills or empties the queue.
+ */
+static void pauseSometimes(uint32_t& randomState) {
+
+    randomState = randomState * 1103515245 + 12345;
+
+    if ((randomState >> 8) % STRESS_PAUSE_ONE_IN != 0)
+        return;
+
+    std::this_thread::sleep_for(std::chrono::microseconds((randomState >> 16) % 200));
+}
+
+template<uint8_t CAPACITY>
+static bool stress(const int& seconds) {
+
+    SampleQueue<EchoSample, CAPACITY> sampleQueue;
+    std::atomic<bool> isStopped(false);
+    QueueStressResult result = {0, 0, 0, 0, 0, 0};
+
+    std::thread producer([&sampleQueue, &isStopped, &result]() {
+        uint32_t randomState = 1;
+
+        for (uint32_t sequence = 1; !isStopped.load(std::memory_order_acquire); sequence++) {
+            sampleQueue.push(toEchoSample(sequence));
+            result.attemptsCount++;
+            pauseSometimes(randomState);
+        }
+    });
+
+    std::thread consumer([&sampleQueue, &isStopped, &result]() {
+        uint32_t randomState = 2;
+        EchoSample echoSample;
+
+        while (true) {
+            //Stopped is read before the pop, so the queue is drained after the producer has stopped
+            bool isProducerStopped = isStopped.load(std::memory_order_acquire);
+
+            if (!sampleQueue.pop(echoSample)) {
+
+                if (isProducerStopped)
+                    return;
+
+                continue;
+            }
+
+            result.poppedCount++;
+            result.tornCount += isEchoSampleWhole(echoSample) ? 0 : 1;
+            result.reorderedCount += echoSample.triggerTimeUS > result.lastSequence ? 0 : 1;
+            result.gapsCount += echoSample.triggerTimeUS - result.lastSequence - 1;
+            result.lastSequence = echoSample.triggerTimeUS;
+
+            pauseSometimes(randomState);
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    isStopped.store(true, std::memory_order_release);
+
+    producer.join();
+    consumer.join();
+
+    //The samples dropped after the last popped one are a gap at the end
+    result.gapsCount += result.attemptsCount - result.lastSequence;
+
+    bool isAccounted = result.poppedCount == sampleQueue.getPushedCount() &&
+                       sampleQueue.getPushedCount() + sampleQueue.getDroppedCount() == result.attemptsCount &&
+                       result.gapsCount == sampleQueue.getDroppedCount() &&
+                       sampleQueue.isEmpty();
+
+    printf("capacity %3u: pushed %9lu, dropped %9lu, popped %9lu, torn %lu, reordered %lu, %s\n",
+           CAPACITY, sampleQueue.getPushedCount(), sampleQueue.getDroppedCount(), result.poppedCount, result.tornCount, result.reorderedCount,
+           isAccounted ? "accounted" : "NOT ACCOUNTED");
+
+    return isAccounted && result.tornCount == 0 && result.reorderedCount == 0;
+}
+
+int main(int argc, char** argv) {
+
+    int seconds = argc > 1 ? atoi(argv[1]) : STRESS_DEFAULT_SECONDS;
+
+    if (seconds <= 0) {
+        fprintf(stderr, "Usage: %s [seconds per capacity]\n", argv[0]);
+        return 1;
+    }
+
+    bool isPassed = stress<2>(seconds);
+    isPassed &= stress<16>(seconds);
+    isPassed &= stress<128>(seconds);
+
+    return isPassed ? 0 : 2;
+}
@@ -0,0 +1,138 @@
+/*
+ * Throughput of the FleetReplayEngine against the count of threads. A fleet of sensors with recordings of different lengths is generated in memory,
+ * replayed one sensor at a time on a single thread like before and then by the engine with 1, 2, 4, ... threads up to the given maximum.
+ * Each run is checked against the single threaded replay: the counts, the min and the max of every sensor must be the same
+ * and the mean within SUMMARY_MEAN_TOLERANCE (the merge of the shards rounds the floats in another order).
+ * The exit code is not 0 if a check fails.
+ *
+ * Build: g++ -std=c++11 -O2 -pthread -I ../arduino -I ../../src -I ../../src/hcsr04 FleetReplayBenchmark.cpp FleetReplayEngine.cpp WorkStealingThreadPool.cpp ../arduino/Arduino.cpp ../../src/hcsr04/TraceSummary.cpp ../../src/hcsr04/EchoReplay.cpp ../../src/hcsr04/EchoTrace.cpp ../../src/hcsr04/HCSR04.cpp ../../src/hcsr04/ExtendedClock.cpp ../../src/hcsr04/HCSR04PinBackend.cpp ../../src/hcsr04/HCSR04Response.cpp ../../src/hcsr04/Measurement.cpp ../../src/hcsr04/AdaptivePingRate.cpp ../../src/hcsr04/SoundSpeed.cpp ../../src/hcsr04/SoundSpeedCalibration.cpp ../../src/hcsr04/DistanceUnits.cpp ../../src/hcsr04/TemperatureUnits.cpp ../../src/hcsr04/Utils.cpp -o hcsr04-fleet-replay-benchmark
+ * Usage: hcsr04-fleet-replay-benchmark [sensors] [max records per sensor] [max threads]
+ */
+#include "FleetReplayEngine.h"
+#include <EchoReplay.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCHMARK_DEFAULT_SENSORS 200
+#define BENCHMARK_DEFAULT_MAX_RECORDS 60000
+#define BENCHMARK_PING_PERIOD_MS 60
+#define SUMMARY_MEAN_TOLERANCE 0.001f
+
+/**
+ * A person walking in front of the sensor, with some response time outs. The lengths of the recordings are between a quarter and all of the max records.
+ */
+static std::vector<uint8_t> generateTrace(const unsigned long& sensorId, const size_t& maxRecordsCount) {
+
+    uint32_t randomState = static_cast<uint32_t>(sensorId) * 2654435761UL + 1;
+    std::vector<uint8_t> trace;
+
+    auto nextRandom = [&randomState]() {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 17;
+        randomState ^= randomState << 5;
+        return static_cast<float>(randomState >> 8) / 16777216.00f;
+    };
+
+    size_t recordsCount = maxRecordsCount / 4 + static_cast<size_t>(nextRandom() * maxRecordsCount * 3 / 4);
+    float distanceCM = 50 + nextRandom() * 300;
+
+    trace.push_back(ECHO_TRACE_MAGIC);
+    trace.push_back(ECHO_TRACE_VERSION);
+
+    for (size_t i = 0; i < recordsCount; i++) {
+        distanceCM = constrain(distanceCM + (nextRandom() - 0.5f) * 4, 5.0f, 400.0f);
+
+        bool isResponseTimedOut = nextRandom() < 0.01f;
+        unsigned long signalLengthUS = isResponseTimedOut ? 0 : static_cast<unsigned long>(distanceCM * 58.3f);
+
+        uint8_t buffer[ECHO_TRACE_RECORD_SIZE];
+        encodeEchoTraceRecord(toEchoTraceRecord({signalLengthUS, isResponseTimedOut}, i * BENCHMARK_PING_PERIOD_MS), buffer);
+        trace.insert(trace.end(), buffer, buffer + ECHO_TRACE_RECORD_SIZE);
+    }
+
+    return trace;
+}
+
+static bool isSummaryEqual(const TraceSummary& summary, const TraceSummary& expectedSummary) {
+    return summary.getSensorId() == expectedSummary.getSensorId() &&
+           summary.getMeasurementsCount() == expectedSummary.getMeasurementsCount() &&
+           summary.getValidDistancesCount() == expectedSummary.getValidDistancesCount() &&
+           summary.getTakenSamples() == expectedSummary.getTakenSamples() &&
+           summary.getValidSamples() == expectedSummary.getValidSamples() &&
+           summary.getResponseTimedOutCount() == expectedSummary.getResponseTimedOutCount() &&
+           summary.getMinDistance() == expectedSummary.getMinDistance() &&
+           summary.getMaxDistance() == expectedSummary.getMaxDistance() &&
+           fabsf(summary.getMeanDistance() - expectedSummary.getMeanDistance()) <= fabsf(expectedSummary.getMeanDistance()) * SUMMARY_MEAN_TOLERANCE;
+}
+
+static double getSecondsSince(const std::chrono::steady_clock::time_point& startTime) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+int main(int argc, char** argv) {
+
+    long sensorsCount = argc > 1 ? atol(argv[1]) : BENCHMARK_DEFAULT_SENSORS;
+    long maxRecordsCount = argc > 2 ? atol(argv[2]) : BENCHMARK_DEFAULT_MAX_RECORDS;
+    long maxThreadsCount = argc > 3 ? atol(argv[3]) : static_cast<long>(std::thread::hardware_concurrency());
+
+    if (sensorsCount <= 0 || maxRecordsCount <= 0 || maxThreadsCount <= 0) {
+        fprintf(stderr, "Usage: %s [sensors] [max records per sensor] [max threads]\n", argv[0]);
+        return 1;
+    }
+
+    MeasurementConfiguration measurementConfiguration = MeasurementConfiguration::builder().withSamples(5).build();
+    std::vector<std::vector<uint8_t>> traces;
+    FleetReplayEngine fleetReplayEngine;
+
+    for (long i = 0; i < sensorsCount; i++) {
+        traces.push_back(generateTrace(static_cast<unsigned long>(i), static_cast<size_t>(maxRecordsCount)));
+        fleetReplayEngine.addSensor(static_cast<unsigned long>(i), traces.back().data(), traces.back().size());
+    }
+
+    double recordsCount = static_cast<double>(fleetReplayEngine.getRecordsCount());
+    std::vector<TraceSummary> expectedSummaries;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (long i = 0; i < sensorsCount; i++) {
+        TraceShardStream traceStream(traces[i].data() + ECHO_TRACE_HEADER_SIZE, (traces[i].size() - ECHO_TRACE_HEADER_SIZE) / ECHO_TRACE_RECORD_SIZE);
+        EchoReplay echoReplay(traceStream);
+        TraceSummary summary(static_cast<unsigned long>(i), DistanceUnit::CENTIMETERS);
+
+        summary.addReplay(echoReplay, measurementConfiguration);
+        expectedSummaries.push_back(summary);
+    }
+
+    double sequentialSeconds = getSecondsSince(startTime);
+
+    printf("%ld sensors, %.0f records\n", sensorsCount, recordsCount);
+    printf("one sensor at a time: %8.3f s, %12.0f records/s\n", sequentialSeconds, recordsCount / sequentialSeconds);
+
+    bool isPassed = true;
+    double singleThreadSeconds = 0;
+
+    for (long threadsCount = 1; threadsCount <= maxThreadsCount; threadsCount = threadsCount * 2 > maxThreadsCount && threadsCount < maxThreadsCount ? maxThreadsCount : threadsCount * 2) {
+        WorkStealingThreadPool threadPool(static_cast<size_t>(threadsCount));
+
+        startTime = std::chrono::steady_clock::now();
+        std::vector<TraceSummary> summaries = fleetReplayEngine.replay(threadPool, measurementConfiguration, DistanceUnit::CENTIMETERS);
+        double seconds = getSecondsSince(startTime);
+
+        if (threadsCount == 1)
+            singleThreadSeconds = seconds;
+
+        bool isEqual = summaries.size() == expectedSummaries.size();
+
+        for (size_t i = 0; isEqual && i < summaries.size(); i++)
+            isEqual = isSummaryEqual(summaries[i], expectedSummaries[i]);
+
+        printf("%3ld threads: %8.3f s, %12.0f records/s, speedup %5.2f, efficiency %5.1f%%, stolen shards %5lu, %s\n",
+               threadsCount, seconds, recordsCount / seconds, singleThreadSeconds / seconds, 100.0 * singleThreadSeconds / seconds / threadsCount,
+               threadPool.getStolenCount(), isEqual ? "same summaries" : "DIFFERENT SUMMARIES");
+
+        isPassed &= isEqual;
+    }
+
+    return isPassed ? 0 : 2;
+}
@@ -0,0 +1,140 @@
+#include "FleetReplayEngine.h"
+#include <EchoReplay.h>
+#include <HCSR04.h>
+
+TraceShardStream::TraceShardStream(const uint8_t* records, const size_t& recordsCount) : records(records) {
+    this->length = ECHO_TRACE_HEADER_SIZE + recordsCount * ECHO_TRACE_RECORD_SIZE;
+    this->position = 0;
+}
+
+int TraceShardStream::available() {
+    return static_cast<int>(this->length - this->position);
+}
+
+int TraceShardStream::read() {
+
+    int value = this->peek();
+
+    if (value != -1)
+        this->position++;
+
+    return value;
+}
+
+int TraceShardStream::peek() {
+
+    if (this->position >= this->length)
+        return -1;
+
+    if (this->position == 0)
+        return ECHO_TRACE_MAGIC;
+
+    if (this->position == 1)
+        return ECHO_TRACE_VERSION;
+
+    return this->records[this->position - ECHO_TRACE_HEADER_SIZE];
+}
+
+size_t TraceShardStream::write(uint8_t) {
+    return 0;
+}
+
+FleetReplayEngine::FleetReplayEngine() : FleetReplayEngine(DEFAULT_FLEET_SHARD_RECORDS) {
+}
+
+/**
+ * @param shardRecordsCount How many records a shard has at most. Smaller shards balance better, bigger ones have less overhead
+ */
+FleetReplayEngine::FleetReplayEngine(const size_t& shardRecordsCount) {
+    this->shardRecordsCount = shardRecordsCount == 0 ? 1 : shardRecordsCount;
+}
+
+/**
+ * Will add the recording of a sensor. The trace is not copied and must live until the replay is finished.
+ * An incomplete record at the end is ignored.
+ *
+ * @return If the header of the trace is valid
+ */
+bool FleetReplayEngine::addSensor(const unsigned long& sensorId, const uint8_t* trace, const size_t& length) {
+
+    if (length < ECHO_TRACE_HEADER_SIZE || trace[0] != ECHO_TRACE_MAGIC || trace[1] != ECHO_TRACE_VERSION)
+        return false;
+
+    this->sensorTraces.push_back({sensorId, trace + ECHO_TRACE_HEADER_SIZE, (length - ECHO_TRACE_HEADER_SIZE) / ECHO_TRACE_RECORD_SIZE});
+
+    return true;
+}
+
+/**
+ * Will replay all of the recordings and block until they are finished.
+ *
+ * @return A summary per sensor, in the order in which they were added. Empty if the configuration has no samples
+ */
+std::vector<TraceSummary> FleetReplayEngine::replay(WorkStealingThreadPool& threadPool, const MeasurementConfiguration& measurementConfiguration, const DistanceUnit& distanceUnit) {
+
+    size_t samples = measurementConfiguration.getSamples().orElseGet(DEFAULT_SAMPLES);
+
+    if (samples == 0)
+        return std::vector<TraceSummary>();
+
+    size_t shardRecordsCount = this->shardRecordsCount < samples ? samples : this->shardRecordsCount - this->shardRecordsCount % samples;
+
+    std::vector<size_t> firstShardIndexes;
+    size_t shardsCount = 0;
+
+    for (size_t i = 0; i < this->sensorTraces.size(); i++) {
+        firstShardIndexes.push_back(shardsCount);
+        shardsCount += (this->sensorTraces[i].recordsCount + shardRecordsCount - 1) / shardRecordsCount;
+    }
+
+    std::vector<TraceSummary> shardSummaries(shardsCount);
+
+    for (size_t i = 0; i < this->sensorTraces.size(); i++) {
+        const FleetSensorTrace& sensorTrace = this->sensorTraces[i];
+
+        for (size_t firstRecord = 0, shardIndex = firstShardIndexes[i]; firstRecord < sensorTrace.recordsCount; firstRecord += shardRecordsCount, shardIndex++) {
+            size_t recordsCount = min(shardRecordsCount, sensorTrace.recordsCount - firstRecord);
+            const uint8_t* records = sensorTrace.records + firstRecord * ECHO_TRACE_RECORD_SIZE;
+            TraceSummary* shardSummary = &shardSummaries[shardIndex];
+
+            *shardSummary = TraceSummary(sensorTrace.sensorId, distanceUnit);
+
+            threadPool.submit([records, recordsCount, shardSummary, measurementConfiguration]() {
+                TraceShardStream shardStream(records, recordsCount);
+                EchoReplay echoReplay(shardStream);
+
+                shardSummary->addReplay(echoReplay, measurementConfiguration);
+            });
+        }
+    }
+
+    threadPool.waitIdle();
+
+    std::vector<TraceSummary> summaries;
+
+    for (size_t i = 0; i < this->sensorTraces.size(); i++) {
+        TraceSummary summary(this->sensorTraces[i].sensorId, distanceUnit);
+        size_t lastShardIndex = i + 1 < firstShardIndexes.size() ? firstShardIndexes[i + 1] : shardsCount;
+
+        for (size_t shardIndex = firstShardIndexes[i]; shardIndex < lastShardIndex; shardIndex++)
+            summary.merge(shardSummaries[shardIndex]);
+
+        summaries.push_back(summary);
+    }
+
+    return summaries;
+}
+
+size_t FleetReplayEngine::getSensorsCount() const {
+    return this->sensorTraces.size();
+}
+
+size_t FleetReplayEngine::getRecordsCount() const {
+
+    size_t recordsCount = 0;
+
+    for (size_t i = 0; i < this->sensorTraces.size(); i++)
+        recordsCount += this->sensorTraces[i].recordsCount;
+
+    return recordsCount;
+}
@@ -0,0 +1,75 @@
+#ifndef HC_SR04_FLEETREPLAYENGINE_H
+#define HC_SR04_FLEETREPLAYENGINE_H
+
+#include "WorkStealingThreadPool.h"
+#include <TraceSummary.h>
+#include <vector>
+
+#define DEFAULT_FLEET_SHARD_RECORDS 4096
+
+/**
+ * Serves a part of the records of a recorded echo trace in memory, after the header of the trace, so each part is a valid trace for an EchoReplay.
+ */
+class TraceShardStream : public Stream {
+
+private:
+
+    const uint8_t* records;
+    size_t length;
+    size_t position;
+
+public:
+
+    TraceShardStream(const uint8_t* records, const size_t& recordsCount);
+
+    int available() override;
+
+    int read() override;
+
+    int peek() override;
+
+    size_t write(uint8_t) override;
+};
+
+/**
+ * The recording of one sensor, kept by the caller.
+ */
+struct FleetSensorTrace {
+
+    unsigned long sensorId;
+    const uint8_t* records;
+    size_t recordsCount;
+};
+
+/**
+ * Replays the recordings of a fleet of sensors on a WorkStealingThreadPool. Each recording is split in shards of records,
+ * each shard is replayed by its own HCSR04 and EchoReplay into its own TraceSummary (the workers share nothing mutable)
+ * and the summaries of the shards are merged in order into one per sensor, so the result doesn't depend on the threads.
+ *
+ * The shards are a multiple of the samples of the configuration, so they split the recordings exactly where the single threaded replay
+ * would start a measurement. This holds while each measurement takes all of its samples (no time budget and no response cool-down).
+ */
+class FleetReplayEngine {
+
+private:
+
+    std::vector<FleetSensorTrace> sensorTraces;
+    size_t shardRecordsCount;
+
+public:
+
+    FleetReplayEngine();
+
+    FleetReplayEngine(const size_t& shardRecordsCount);
+
+    bool addSensor(const unsigned long& sensorId, const uint8_t* trace, const size_t& length);
+
+    std::vector<TraceSummary> replay(WorkStealingThreadPool& threadPool, const MeasurementConfiguration& measurementConfiguration, const DistanceUnit& distanceUnit);
+
+    size_t getSensorsCount() const;
+
+    size_t getRecordsCount() const;
+};
+
+
+#endif //HC_SR04_FLEETREPLAYENGINE_H
@@ -0,0 +1,156 @@
+#include "WorkStealingThreadPool.h"
+
+/**
+ * @param threadsCount How many workers are started. At least one
+ */
+WorkStealingThreadPool::WorkStealingThreadPool(const size_t& threadsCount) {
+    this->submittedCount = 0;
+    this->stolenCount = 0;
+    this->pendingCount = 0;
+    this->queuedCount = 0;
+    this->isStopping = false;
+
+    size_t workersCount = threadsCount == 0 ? 1 : threadsCount;
+
+    for (size_t i = 0; i < workersCount; i++)
+        this->queues.push_back(new WorkerQueue());
+
+    for (size_t i = 0; i < workersCount; i++)
+        this->workers.push_back(std::thread(&WorkStealingThreadPool::runWorker, this, i));
+}
+
+/**
+ * Will finish the submitted tasks and stop the workers.
+ */
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+
+    this->waitIdle();
+
+    {
+        std::lock_guard<std::mutex> lock(this->stateMutex);
+        this->isStopping = true;
+    }
+
+    this->taskAvailable.notify_all();
+
+    for (size_t i = 0; i < this->workers.size(); i++)
+        this->workers[i].join();
+
+    for (size_t i = 0; i < this->queues.size(); i++)
+        delete this->queues[i];
+}
+
+/**
+ * The newest task of the worker, which data is most likely still in its cache.
+ */
+bool WorkStealingThreadPool::popOwnTask(const size_t& workerIndex, std::function<void()>& task) {
+
+    WorkerQueue& queue = *this->queues[workerIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.tasks.empty())
+        return false;
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+
+    return true;
+}
+
+/**
+ * The oldest task of the other workers, starting from the next one, so the workers don't all steal from the same queue.
+ */
+bool WorkStealingThreadPool::stealTask(const size_t& workerIndex, std::function<void()>& task) {
+
+    for (size_t i = 1; i < this->queues.size(); i++) {
+        WorkerQueue& queue = *this->queues[(workerIndex + i) % this->queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty())
+            continue;
+
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        this->stolenCount++;
+
+        return true;
+    }
+
+    return false;
+}
+
+void WorkStealingThreadPool::runWorker(const size_t& workerIndex) {
+
+    while (true) {
+        std::function<void()> task;
+        unsigned long seenQueuedCount;
+
+        {
+            std::lock_guard<std::mutex> lock(this->stateMutex);
+            seenQueuedCount = this->queuedCount;
+        }
+
+        if (this->popOwnTask(workerIndex, task) || this->stealTask(workerIndex, task)) {
+            task();
+
+            std::lock_guard<std::mutex> lock(this->stateMutex);
+
+            if (--this->pendingCount == 0)
+                this->idle.notify_all();
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(this->stateMutex);
+
+        //Sleeps until a task is queued after the queues were checked, so a task submitted between the steal and the lock is not missed
+        this->taskAvailable.wait(lock, [this, seenQueuedCount]() { return this->isStopping || this->queuedCount != seenQueuedCount; });
+
+        if (this->isStopping)
+            return;
+    }
+}
+
+/**
+ * Will queue the task to the workers in turn. The task must not throw.
+ */
+void WorkStealingThreadPool::submit(const std::function<void()>& task) {
+
+    {
+        std::lock_guard<std::mutex> lock(this->stateMutex);
+        this->pendingCount++;
+    }
+
+    WorkerQueue& queue = *this->queues[this->submittedCount++ % this->queues.size()];
+
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->stateMutex);
+        this->queuedCount++;
+    }
+
+    this->taskAvailable.notify_one();
+}
+
+/**
+ * Will block until all of the submitted tasks are finished.
+ */
+void WorkStealingThreadPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(this->stateMutex);
+    this->idle.wait(lock, [this]() { return this->pendingCount == 0; });
+}
+
+size_t WorkStealingThreadPool::getThreadsCount() const {
+    return this->workers.size();
+}
+
+/**
+ * @return How many tasks were taken from the queue of another worker
+ */
+unsigned long WorkStealingThreadPool::getStolenCount() const {
+    return this->stolenCount;
+}
@@ -0,0 +1,64 @@
+#ifndef HC_SR04_WORKSTEALINGTHREADPOOL_H
+#define HC_SR04_WORKSTEALINGTHREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Host thread pool, where each worker has its own queue of tasks. A worker takes its newest task first and when its queue is empty
+ * it steals the oldest task of another worker, so the workers stay busy when the tasks have different lengths (the recordings of the sensors do).
+ *
+ * WorkStealingThreadPool threadPool(4);
+ * threadPool.submit([]() { ... });
+ * threadPool.waitIdle();
+ */
+class WorkStealingThreadPool {
+
+private:
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<WorkerQueue*> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex stateMutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable idle;
+
+    std::atomic<unsigned long> submittedCount;
+    std::atomic<unsigned long> stolenCount;
+    unsigned long pendingCount;
+    unsigned long queuedCount;
+    bool isStopping;
+
+    bool popOwnTask(const size_t& workerIndex, std::function<void()>& task);
+
+    bool stealTask(const size_t& workerIndex, std::function<void()>& task);
+
+    void runWorker(const size_t& workerIndex);
+
+public:
+
+    WorkStealingThreadPool(const size_t& threadsCount);
+
+    ~WorkStealingThreadPool();
+
+    void submit(const std::function<void()>& task);
+
+    void waitIdle();
+
+    size_t getThreadsCount() const;
+
+    unsigned long getStolenCount() const;
+};
+
+
+#endif //HC_SR04_WORKSTEALINGTHREADPOOL_H
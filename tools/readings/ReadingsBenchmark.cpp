@@ -0,0 +1,183 @@
+/*
+ * Benchmark of the compression of readings. Encodes the readings of each given echo trace (recorded with EchoRecorder),
+ * decodes them back, checks that every reading is within half a quantum and reports the compression ratio and the throughput.
+ * Without traces a synthetic trace is used: a slowly changing level, measured every second for a week, with the jitter of the sensor
+ * on every reading (normal, BENCHMARK_JITTER_CENTIMETERS standard deviation).
+ *
+ * Build: g++ -std=c++11 -O2 -I ../arduino -I ../../src/hcsr04 ReadingsBenchmark.cpp ../../src/hcsr04/ReadingsEncoder.cpp ../../src/hcsr04/ReadingsDecoder.cpp ../../src/hcsr04/EchoTrace.cpp ../../src/hcsr04/HCSR04Response.cpp -o hcsr04-readings-benchmark
+ * Usage: hcsr04-readings-benchmark <quantum> [echo trace]...
+ */
+#include <EchoTrace.h>
+#include <Reading.h>
+#include <ReadingsDecoder.h>
+#include <ReadingsEncoder.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+/*
+ * The echo length of the HC-SR04 when nothing was in range, see TIMEOUT_SIGNAL_LENGTH_US
+ */
+#define BENCHMARK_TIMED_OUT_SIGNAL_LENGTH_US 38000
+
+/*
+ * Half of the speed of the sound at 25 degrees celsius, in centimeters per microsecond
+ */
+#define CENTIMETERS_PER_ECHO_MICROSECOND 0.0173225f
+
+#define BENCHMARK_DECODED_READINGS_CAPACITY 4096
+#define BENCHMARK_JITTER_CENTIMETERS 0.15f
+
+static double getMonotonicTimeS() {
+
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) / 1e9;
+}
+
+/**
+ * The echoes that timed out are logged as 0, like the distance of a measurement without valid samples.
+ */
+static bool loadEchoTrace(const char* path, std::vector<Reading>& readings) {
+
+    FILE* file = fopen(path, "rb");
+
+    if (file == nullptr)
+        return false;
+
+    uint8_t header[ECHO_TRACE_HEADER_SIZE];
+    uint8_t record[ECHO_TRACE_RECORD_SIZE];
+
+    bool isValid = fread(header, 1, sizeof(header), file) == sizeof(header) && header[0] == ECHO_TRACE_MAGIC && header[1] == ECHO_TRACE_VERSION;
+
+    while (isValid && fread(record, 1, sizeof(record), file) == sizeof(record)) {
+        EchoTraceRecord echoTraceRecord = decodeEchoTraceRecord(record);
+        bool isTimedOut = echoTraceRecord.flags != 0 || echoTraceRecord.signalLengthUS >= BENCHMARK_TIMED_OUT_SIGNAL_LENGTH_US;
+
+        readings.push_back({static_cast<uint32_t>(echoTraceRecord.timeMS), isTimedOut ? 0 : echoTraceRecord.signalLengthUS * CENTIMETERS_PER_ECHO_MICROSECOND});
+    }
+
+    fclose(file);
+
+    return isValid;
+}
+
+/**
+ * Normal noise with the Box-Muller transform.
+ */
+static float generateJitterCM(unsigned int& randomState) {
+
+    float uniform = (static_cast<float>(rand_r(&randomState)) + 1.00f) / (static_cast<float>(RAND_MAX) + 2.00f);
+    float angle = static_cast<float>(rand_r(&randomState)) / static_cast<float>(RAND_MAX) * 2 * static_cast<float>(M_PI);
+
+    return sqrtf(-2 * logf(uniform)) * cosf(angle) * BENCHMARK_JITTER_CENTIMETERS;
+}
+
+static void generateLevelTrace(std::vector<Reading>& readings) {
+
+    unsigned int randomState = 1;
+    float levelCM = 120.00f;
+
+    for (uint32_t second = 0; second < 7 * 24 * 3600; second++) {
+
+        if (second % 3600 < 600)
+            levelCM += 0.002f;
+
+        readings.push_back({second * 1000, levelCM + generateJitterCM(randomState)});
+    }
+}
+
+static bool runBenchmark(const char* name, const std::vector<Reading>& readings, const float& quantum) {
+
+    std::vector<uint8_t> compressed;
+    compressed.reserve(readings.size() * 4 + READINGS_ENCODER_MAX_OUTPUT_SIZE);
+
+    ReadingsEncoder encoder(quantum);
+    uint8_t buffer[READINGS_ENCODER_MAX_OUTPUT_SIZE];
+
+    double encodeStartTimeS = getMonotonicTimeS();
+
+    for (const Reading& reading : readings) {
+        uint8_t size = encoder.encode(reading.timeMS, reading.distance, buffer);
+        compressed.insert(compressed.end(), buffer, buffer + size);
+    }
+
+    uint8_t size = encoder.flush(buffer);
+    compressed.insert(compressed.end(), buffer, buffer + size);
+
+    double encodeTimeS = getMonotonicTimeS() - encodeStartTimeS;
+
+    ReadingsDecoder decoder;
+    Reading decoded[BENCHMARK_DECODED_READINGS_CAPACITY];
+    size_t decodedCount = 0;
+    size_t mismatchesCount = 0;
+    size_t offset = 0;
+
+    double decodeStartTimeS = getMonotonicTimeS();
+
+    while (true) {
+        size_t consumedLength;
+        size_t count = decoder.feed(compressed.data() + offset, compressed.size() - offset, consumedLength, decoded, BENCHMARK_DECODED_READINGS_CAPACITY);
+
+        for (size_t i = 0; i < count && decodedCount + i < readings.size(); i++) {
+            const Reading& original = readings[decodedCount + i];
+
+            if (decoded[i].timeMS != original.timeMS || fabsf(decoded[i].distance - original.distance) > quantum / 2 + 1e-4f)
+                mismatchesCount++;
+        }
+
+        decodedCount += count;
+        offset += consumedLength;
+
+        if (count == 0 && offset == compressed.size())
+            break;
+    }
+
+    double decodeTimeS = getMonotonicTimeS() - decodeStartTimeS;
+
+    printf("%s: %zu readings, %zu bytes, ratio %.1fx (%.3f bytes/reading), encode %.1f M readings/s, decode %.1f M readings/s, mismatches %zu\n",
+           name, readings.size(), compressed.size(), encoder.getCompressionRatio(), static_cast<double>(compressed.size()) / static_cast<double>(readings.size()),
+           static_cast<double>(readings.size()) / encodeTimeS / 1e6, static_cast<double>(decodedCount) / decodeTimeS / 1e6,
+           mismatchesCount + (decodedCount != readings.size() ? 1 : 0));
+
+    return mismatchesCount == 0 && decodedCount == readings.size() && !decoder.isInvalid();
+}
+
+int main(int argumentsCount, char** arguments) {
+
+    if (argumentsCount < 2) {
+        fprintf(stderr, "Usage: %s <quantum> [echo trace]...\n", arguments[0]);
+        return 2;
+    }
+
+    float quantum = static_cast<float>(atof(arguments[1]));
+    bool isSuccessful = true;
+
+    if (!(quantum > 0)) {
+        fprintf(stderr, "The quantum must be greater than 0\n");
+        return 2;
+    }
+
+    if (argumentsCount == 2) {
+        std::vector<Reading> readings;
+        generateLevelTrace(readings);
+        isSuccessful = runBenchmark("synthetic level", readings, quantum);
+    }
+
+    for (int i = 2; i < argumentsCount; i++) {
+        std::vector<Reading> readings;
+
+        if (!loadEchoTrace(arguments[i], readings)) {
+            fprintf(stderr, "%s: not an echo trace\n", arguments[i]);
+            isSuccessful = false;
+            continue;
+        }
+
+        isSuccessful = runBenchmark(arguments[i], readings, quantum) && isSuccessful;
+    }
+
+    return isSuccessful ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+/*
+ * Feeds MeasurementRollups with a distance at 25 Hz for a few hours, at the resolutions of a second, a minute and an hour,
+ * and checks the cascade and the queries against the distances themselves:
+ *  - Each closed hour has all of its 90000 distances and their exact min and max and mean (within MEAN_TOLERANCE)
+ *  - Each closed minute has 1500 distances and each closed second 25
+ *  - A query picks the finest level, which still reaches back to the beginning of the range, and returns only aggregates of the range
+ *  - The open hour has the distances of the closed minutes, which are merged into it when they close
+ * The exit code is not 0 if a check fails.
+ *
+ * Build: g++ -std=c++11 -O2 -I ../arduino -I ../../src -I ../../src/hcsr04 MeasurementRollupsDemo.cpp ../arduino/Arduino.cpp ../../src/hcsr04/Measurement.cpp ../../src/hcsr04/DistanceUnits.cpp -o hcsr04-rollups-demo
+ * Usage: hcsr04-rollups-demo [hours]
+ */
+#include <MeasurementRollups.h>
+#include <ToolChecks.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEMO_DEFAULT_HOURS 3
+#define DEMO_PERIOD_MS 40
+#define DEMO_SLOTS 12
+#define MEAN_TOLERANCE 0.0001f
+
+static const uint32_t RESOLUTIONS_MS[3] = {1000, 60000, 3600000};
+
+/**
+ * A level, which changes slowly during the day, with a wave every minute and a little noise.
+ */
+static float getDistance(const uint32_t& timeMS) {
+    return 150.0f + 50.0f * sinf(timeMS / 3600000.0f) + 10.0f * sinf(timeMS / 9549.3f) + static_cast<float>((timeMS * 2654435761UL >> 24) % 100) / 100.0f;
+}
+
+/**
+ * The truth of the period, calculated from the distances themselves, in double.
+ */
+static RollupAggregate calculateAggregate(const uint32_t& startTimeMS, const uint32_t& resolutionMS) {
+
+    RollupAggregate aggregate = {startTimeMS, 0, 0, 0, 0};
+    double sum = 0;
+
+    for (uint32_t timeMS = startTimeMS; timeMS < startTimeMS + resolutionMS; timeMS += DEMO_PERIOD_MS) {
+        float distance = getDistance(timeMS);
+
+        aggregate.minDistance = aggregate.count == 0 ? distance : min(aggregate.minDistance, distance);
+        aggregate.maxDistance = aggregate.count == 0 ? distance : max(aggregate.maxDistance, distance);
+        aggregate.count++;
+        sum += distance;
+    }
+
+    aggregate.meanDistance = static_cast<float>(sum / aggregate.count);
+
+    return aggregate;
+}
+
+static bool isAggregateCorrect(const RollupAggregate& aggregate, const uint32_t& resolutionMS) {
+
+    RollupAggregate expected = calculateAggregate(aggregate.startTimeMS, resolutionMS);
+
+    return aggregate.count == expected.count &&
+           aggregate.minDistance == expected.minDistance &&
+           aggregate.maxDistance == expected.maxDistance &&
+           fabsf(aggregate.meanDistance - expected.meanDistance) <= expected.meanDistance * MEAN_TOLERANCE;
+}
+
+int main(int argc, char** argv) {
+
+    int hours = argc > 1 ? atoi(argv[1]) : DEMO_DEFAULT_HOURS;
+
+    if (hours <= 0 || hours > DEMO_SLOTS) {
+        fprintf(stderr, "Usage: %s [hours, 1 to %d]\n", argv[0], DEMO_SLOTS);
+        return 1;
+    }
+
+    MeasurementRollups<3, DEMO_SLOTS> measurementRollups(RESOLUTIONS_MS);
+    uint32_t endTimeMS = static_cast<uint32_t>(hours) * RESOLUTIONS_MS[2] + 30 * RESOLUTIONS_MS[1];
+
+    for (uint32_t timeMS = 0; timeMS < endTimeMS; timeMS += DEMO_PERIOD_MS)
+        measurementRollups.add(timeMS, getDistance(timeMS));
+
+    printf("%u hours and 30 minutes at %u Hz, %u bytes\n", hours, 1000 / DEMO_PERIOD_MS, static_cast<unsigned int>(sizeof(measurementRollups)));
+
+    bool isPassed = true;
+
+    for (uint8_t levelIndex = 0; levelIndex < 3; levelIndex++) {
+        uint32_t resolutionMS = measurementRollups.getResolutionMS(levelIndex);
+        uint32_t expectedCount = resolutionMS / DEMO_PERIOD_MS;
+        bool isCorrect = measurementRollups.getAggregatesCount(levelIndex) > 0;
+
+        for (uint8_t i = 0; i < measurementRollups.getAggregatesCount(levelIndex); i++) {
+            const RollupAggregate& aggregate = measurementRollups.getAggregate(levelIndex, i);
+
+            if (levelIndex == 2)
+                printf("hour from %7lu s: count %lu, min %.2f, max %.2f, mean %.3f\n", static_cast<unsigned long>(aggregate.startTimeMS / 1000),
+                       static_cast<unsigned long>(aggregate.count), aggregate.minDistance, aggregate.maxDistance, aggregate.meanDistance);
+
+            isCorrect &= aggregate.count == expectedCount && isAggregateCorrect(aggregate, resolutionMS);
+        }
+
+        char name[96];
+        snprintf(name, sizeof(name), "the closed aggregates of %lu ms have %lu distances and their statistics", static_cast<unsigned long>(resolutionMS), static_cast<unsigned long>(expectedCount));
+        isPassed &= check(isCorrect, name);
+    }
+
+    RollupAggregate aggregates[DEMO_SLOTS + 1];
+    uint8_t levelIndex = 0;
+    uint8_t aggregatesCount = measurementRollups.query(endTimeMS - 5000, endTimeMS, aggregates, DEMO_SLOTS + 1, levelIndex);
+
+    isPassed &= check(levelIndex == 0 && aggregatesCount == 5, "the last 5 seconds are 5 aggregates of a second");
+
+    aggregatesCount = measurementRollups.query(endTimeMS - 10 * RESOLUTIONS_MS[1], endTimeMS, aggregates, DEMO_SLOTS + 1, levelIndex);
+
+    isPassed &= check(levelIndex == 1 && aggregatesCount == 10, "the last 10 minutes are 10 aggregates of a minute");
+
+    aggregatesCount = measurementRollups.query(0, endTimeMS, aggregates, DEMO_SLOTS + 1, levelIndex);
+
+    uint64_t queriedCount = 0;
+
+    for (uint8_t i = 0; i < aggregatesCount; i++)
+        queriedCount += aggregates[i].count;
+
+    isPassed &= check(levelIndex == 2 && aggregatesCount == hours + 1, "the whole time is the hours, with the open one last");
+    //The open hour has the closed minutes. The last minute is still open, so its distances are not there yet
+    isPassed &= check(queriedCount == (endTimeMS - RESOLUTIONS_MS[1]) / DEMO_PERIOD_MS, "the hours of the query have the distances of all closed minutes");
+
+    return isPassed ? 0 : 2;
+}
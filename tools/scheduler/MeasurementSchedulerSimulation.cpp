@@ -0,0 +1,124 @@
+/*
+ * Runs the MeasurementScheduler against simulated sensors on the virtual clock of a SceneSimulator, so it is tested on the host.
+ * Three sensors with different periods, deadlines and samples share the scene. The scheduler is polled like in the loop of a sketch
+ * and the clock is moved to the next release when there is nothing to measure. The checks:
+ *  - A feasible set of sensors achieves the rate of its periods and misses no deadline
+ *  - A sensor with a period of 0 is rejected
+ *  - A sensor starved for an hour is caught up in a single poll and the skipped periods are counted as deadline misses
+ * The exit code is not 0 if a check fails.
+ *
+ * Build: g++ -std=c++11 -O2 -I ../arduino -I ../../src -I ../../src/hcsr04 MeasurementSchedulerSimulation.cpp ../arduino/Arduino.cpp ../../src/hcsr04/MeasurementScheduler.cpp ../../src/hcsr04/HCSR04.cpp ../../src/hcsr04/ExtendedClock.cpp ../../src/hcsr04/HCSR04PinBackend.cpp ../../src/hcsr04/HCSR04Response.cpp ../../src/hcsr04/Measurement.cpp ../../src/hcsr04/AdaptivePingRate.cpp ../../src/hcsr04/SoundSpeed.cpp ../../src/hcsr04/SoundSpeedCalibration.cpp ../../src/hcsr04/DistanceUnits.cpp ../../src/hcsr04/TemperatureUnits.cpp ../../src/hcsr04/Utils.cpp ../../src/hcsr04/SceneSimulator.cpp ../../src/hcsr04/SimulatedSensor.cpp -o hcsr04-scheduler-simulation
+ * Usage: hcsr04-scheduler-simulation [seconds]
+ */
+#include <MeasurementScheduler.h>
+#include <SceneSimulator.h>
+#include <SimulatedSensor.h>
+#include <ToolChecks.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIMULATION_DEFAULT_SECONDS 60
+#define SIMULATION_SENSORS_COUNT 3
+#define SIMULATION_RATE_TOLERANCE 0.02f
+#define SIMULATION_STARVATION_MS 3600000UL
+
+#define SIMULATION_SCENARIO "seed 9\nmissed 0.05\ntarget static 80 -40\ntarget static 150 0\ntarget oscillating 200 50 4000 40\n"
+
+struct SimulatedSchedule {
+    float headingDegrees;
+    unsigned long periodMS;
+    unsigned long deadlineMS;
+    unsigned int samples;
+};
+
+/*
+ * The sensors take ~30 ms for a sample with the spacing, so together they need ~40% of the time
+ */
+static const SimulatedSchedule SCHEDULES[SIMULATION_SENSORS_COUNT] = {
+        {-40, 200, 150, 1},
+        {0, 500, 400, 2},
+        {40, 1000, 900, 3}
+};
+
+static SceneSimulator scene;
+
+/**
+ * The clock of the scheduler is the virtual time of the scene.
+ */
+static unsigned long getSceneTimeMS() {
+    return static_cast<unsigned long>(scene.getTimeUS() / 1000);
+}
+
+static void runScheduler(MeasurementScheduler& scheduler, const unsigned long& durationMS) {
+
+    unsigned long endMS = getSceneTimeMS() + durationMS;
+
+    while (getSceneTimeMS() < endMS) {
+
+        if (scheduler.poll())
+            continue;
+
+        unsigned long untilNextReleaseMS = scheduler.getTimeUntilNextReleaseMS();
+        scene.advanceTimeUS(static_cast<uint64_t>(max(untilNextReleaseMS, 1UL)) * 1000);
+    }
+}
+
+int main(int argc, char** argv) {
+
+    int seconds = argc > 1 ? atoi(argv[1]) : SIMULATION_DEFAULT_SECONDS;
+
+    if (seconds <= 0) {
+        fprintf(stderr, "Usage: %s [seconds]\n", argv[0]);
+        return 1;
+    }
+
+    if (!scene.loadScenario(SIMULATION_SCENARIO))
+        return 1;
+
+    SimulatedSensor firstSimulatedSensor(scene, SCHEDULES[0].headingDegrees);
+    SimulatedSensor secondSimulatedSensor(scene, SCHEDULES[1].headingDegrees);
+    SimulatedSensor thirdSimulatedSensor(scene, SCHEDULES[2].headingDegrees);
+    HCSR04 firstSensor(firstSimulatedSensor);
+    HCSR04 secondSensor(secondSimulatedSensor);
+    HCSR04 thirdSensor(thirdSimulatedSensor);
+    HCSR04* sensors[SIMULATION_SENSORS_COUNT] = {&firstSensor, &secondSensor, &thirdSensor};
+    MeasurementScheduler scheduler(getSceneTimeMS);
+
+    for (uint8_t i = 0; i < SIMULATION_SENSORS_COUNT; i++)
+        scheduler.addSensor(*sensors[i], SCHEDULES[i].periodMS, SCHEDULES[i].deadlineMS, SCHEDULES[i].samples);
+
+    bool isPassed = check(scheduler.addSensor(*sensors[0], 0, 0, 1) == -1, "a period of 0 is rejected");
+
+    runScheduler(scheduler, static_cast<unsigned long>(seconds) * 1000);
+
+    for (uint8_t i = 0; i < SIMULATION_SENSORS_COUNT; i++) {
+        float expectedRateHz = 1000.0f / static_cast<float>(SCHEDULES[i].periodMS);
+        float achievedRateHz = scheduler.getAchievedRateHz(i);
+
+        printf("sensor %u: period %4lu ms, completed %5lu, deadline misses %lu, rate %.2f Hz of %.2f Hz\n",
+               i, SCHEDULES[i].periodMS, scheduler.getCompletedCount(i), scheduler.getDeadlineMissCount(i), achievedRateHz, expectedRateHz);
+
+        isPassed &= check(fabsf(achievedRateHz - expectedRateHz) <= expectedRateHz * SIMULATION_RATE_TOLERANCE, "  the rate of the period is achieved");
+        isPassed &= check(scheduler.getDeadlineMissCount(i) == 0, "  no deadline is missed");
+    }
+
+    unsigned long missesBeforeStarvation = scheduler.getDeadlineMissCount(0);
+    unsigned long completedBeforeStarvation = scheduler.getCompletedCount(0);
+
+    scene.advanceTimeUS(static_cast<uint64_t>(SIMULATION_STARVATION_MS) * 1000);
+
+    for (uint8_t i = 0; i < SIMULATION_SENSORS_COUNT; i++)
+        scheduler.poll();
+
+    unsigned long skippedPeriodsCount = scheduler.getDeadlineMissCount(0) - missesBeforeStarvation;
+    unsigned long expectedSkippedPeriodsCount = SIMULATION_STARVATION_MS / SCHEDULES[0].periodMS;
+
+    printf("after %lu ms of starvation: skipped periods %lu, measurements %lu\n",
+           SIMULATION_STARVATION_MS, skippedPeriodsCount, scheduler.getCompletedCount(0) - completedBeforeStarvation);
+
+    isPassed &= check(skippedPeriodsCount + 1 >= expectedSkippedPeriodsCount && skippedPeriodsCount <= expectedSkippedPeriodsCount + 1, "the skipped periods are counted as deadline misses");
+    isPassed &= check(scheduler.getCompletedCount(0) - completedBeforeStarvation == 1, "each starved sensor is measured once, not back to back");
+
+    return isPassed ? 0 : 2;
+}
@@ -0,0 +1,207 @@
+/*
+ * Benchmark of the type checked SERIAL_PRINTF against serial_printf, on the line that src/main.cpp prints for each measurement.
+ * Both write to a serial, which only collects the bytes. The lines of both have to be equal.
+ * ../arduino has the Print of the Arduino core, so it is built without the board.
+ *
+ * Build: g++ -std=c++11 -O2 -I ../arduino -I ../../lib/serialPrintF SerialPrintFBenchmark.cpp ../../lib/serialPrintF/SerialPrintF.cpp ../../lib/serialPrintF/SerialFormat.cpp -o hcsr04-serial-printf-benchmark
+ * Usage: hcsr04-serial-printf-benchmark [lines]
+ */
+#include <Arduino.h>
+#include <SerialPrintF.h>
+#include <SerialFormat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCHMARK_DEFAULT_LINES 1000000
+#define BENCHMARK_LINE_CAPACITY static_cast<size_t>(256)
+
+/**
+ * Keeps only the last line, like a serial, which sends the bytes away.
+ * The HardwareSerial of the AVR core takes the bytes one by one. Other outputs, like a File or a client, take a block of bytes at once.
+ */
+class LineSerial : public HardwareSerial {
+
+private:
+
+    char line[BENCHMARK_LINE_CAPACITY];
+    char lastLine[BENCHMARK_LINE_CAPACITY];
+    size_t length;
+    unsigned long long bytesCount;
+    bool isBlockWriting;
+
+    void append(const uint8_t& c) {
+
+        this->bytesCount++;
+
+        if (c != '\n') {
+            this->line[this->length] = static_cast<char>(c);
+            this->length += this->length < BENCHMARK_LINE_CAPACITY - 1 ? 1 : 0;
+            return;
+        }
+
+        memcpy(this->lastLine, this->line, this->length);
+        this->lastLine[this->length] = '\0';
+        this->length = 0;
+    }
+
+public:
+
+    LineSerial(const bool& isBlockWriting) : length(0), bytesCount(0), isBlockWriting(isBlockWriting) {
+        this->lastLine[0] = '\0';
+    }
+
+    size_t write(uint8_t c) override {
+        this->append(c);
+        return 1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+
+        if (!this->isBlockWriting)
+            return Print::write(buffer, size);
+
+        const uint8_t* newLine = static_cast<const uint8_t*>(memchr(buffer, '\n', size));
+        size_t lineSize = newLine ? static_cast<size_t>(newLine - buffer) : size;
+        size_t copiedSize = min(lineSize, BENCHMARK_LINE_CAPACITY - 1 - this->length);
+
+        memcpy(this->line + this->length, buffer, copiedSize);
+        this->length += copiedSize;
+        this->bytesCount += lineSize;
+
+        if (newLine) {
+            this->append('\n');
+            this->write(newLine + 1, size - lineSize - 1);
+        }
+
+        return size;
+    }
+
+    using Print::write;
+
+    const char* getLastLine() const {
+        return this->lastLine;
+    }
+
+    unsigned long long getBytesCount() const {
+        return this->bytesCount;
+    }
+};
+
+/**
+ * The values that the getters of a Measurement return, with their types.
+ */
+struct MeasurementLine {
+    float distance;
+    const char* distanceUnitAbbreviation;
+    unsigned long validMeasurementsCount;
+    unsigned int takenSamples;
+    unsigned int signalTimedOutCount;
+    unsigned int responseTimedOutCount;
+    unsigned int maxDistanceExceededCount;
+    bool isResponseCoolDownActive;
+};
+
+static double getMonotonicTimeS() {
+
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) / 1e9;
+}
+
+static MeasurementLine makeMeasurementLine(const unsigned long& index) {
+
+    unsigned int errors = static_cast<unsigned int>(index % 4);
+
+    return MeasurementLine{static_cast<float>(index % 40000) / 100.0f - 2.0f, "cm", 3 - errors % 3, 3, errors & 1, errors >> 1, 0, index % 97 == 0};
+}
+
+static void printWithSerialPrintF(LineSerial& serial, const MeasurementLine& line) {
+    serial_printf(serial,
+                  "Distance: %2f %s, Valid Samples: %l/%i [Signal Timed Out Count: %i, Response Timed Out Count: %i, Max Distance Exceeded Count: %i, Response Cool Down: %o]\n",
+                  line.distance, line.distanceUnitAbbreviation,
+                  line.validMeasurementsCount,
+                  line.takenSamples,
+                  line.signalTimedOutCount,
+                  line.responseTimedOutCount,
+                  line.maxDistanceExceededCount,
+                  line.isResponseCoolDownActive);
+}
+
+static void printWithSerialFormat(LineSerial& serial, const MeasurementLine& line) {
+    SERIAL_PRINTF(serial,
+                  "Distance: %2f %s, Valid Samples: %i/%i [Signal Timed Out Count: %i, Response Timed Out Count: %i, Max Distance Exceeded Count: %i, Response Cool Down: %o]\n",
+                  line.distance, line.distanceUnitAbbreviation,
+                  line.validMeasurementsCount,
+                  line.takenSamples,
+                  line.signalTimedOutCount,
+                  line.responseTimedOutCount,
+                  line.maxDistanceExceededCount,
+                  line.isResponseCoolDownActive);
+}
+
+static bool areLinesEqual(const unsigned long& linesCount) {
+
+    LineSerial serial(false);
+    char serialPrintFLine[BENCHMARK_LINE_CAPACITY];
+    char serialFormatLine[BENCHMARK_LINE_CAPACITY];
+
+    for (unsigned long i = 0; i < linesCount; i++) {
+        MeasurementLine line = makeMeasurementLine(i * 7919);
+
+        printWithSerialPrintF(serial, line);
+        strcpy(serialPrintFLine, serial.getLastLine());
+
+        printWithSerialFormat(serial, line);
+        strcpy(serialFormatLine, serial.getLastLine());
+
+        if (strcmp(serialPrintFLine, serialFormatLine) != 0) {
+            fprintf(stderr, "Different lines:\n%s\n%s\n", serialPrintFLine, serialFormatLine);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static double benchmark(const char* name, const unsigned long& linesCount, const bool& isBlockWriting, void (*print)(LineSerial&, const MeasurementLine&)) {
+
+    LineSerial serial(isBlockWriting);
+    double startS = getMonotonicTimeS();
+
+    for (unsigned long i = 0; i < linesCount; i++)
+        print(serial, makeMeasurementLine(i));
+
+    double elapsedS = getMonotonicTimeS() - startS;
+    double nanosecondsPerLine = elapsedS * 1e9 / static_cast<double>(linesCount);
+
+    printf("%-14s %-6s %10.1f ns/line %8.1f MB/s\n", name, isBlockWriting ? "block" : "byte", nanosecondsPerLine, static_cast<double>(serial.getBytesCount()) / elapsedS / 1e6);
+
+    return nanosecondsPerLine;
+}
+
+int main(int argc, char** argv) {
+
+    unsigned long linesCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : BENCHMARK_DEFAULT_LINES;
+
+    if (linesCount == 0) {
+        fprintf(stderr, "Usage: %s [lines]\n", argv[0]);
+        return 1;
+    }
+
+    if (!areLinesEqual(10000))
+        return 1;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        bool isBlockWriting = i == 1;
+
+        double serialPrintFNS = benchmark("serial_printf", linesCount, isBlockWriting, printWithSerialPrintF);
+        double serialFormatNS = benchmark("SERIAL_PRINTF", linesCount, isBlockWriting, printWithSerialFormat);
+
+        printf("speedup %.2fx\n", serialPrintFNS / serialFormatNS);
+    }
+
+    return 0;
+}
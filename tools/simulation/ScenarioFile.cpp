@@ -0,0 +1,28 @@
+#include "ScenarioFile.h"
+#include <stdio.h>
+
+/**
+ * Will load a scenario from a file on the host, in the format of SceneSimulator::loadScenario. See tools/simulation/scenarios.
+ *
+ * @return If the file was read and all of its lines were valid. False if it is longer than SCENARIO_FILE_MAX_LENGTH
+ */
+bool loadScenarioFile(SceneSimulator& scene, const char* path) {
+
+    FILE* file = fopen(path, "rb");
+
+    if (!file)
+        return false;
+
+    char scenario[SCENARIO_FILE_MAX_LENGTH + 1];
+    size_t length = fread(scenario, 1, sizeof(scenario), file);
+    bool isRead = !ferror(file) && length <= SCENARIO_FILE_MAX_LENGTH;
+
+    fclose(file);
+
+    if (!isRead)
+        return false;
+
+    scenario[length] = '\0';
+
+    return scene.loadScenario(scenario);
+}
@@ -0,0 +1,11 @@
+#ifndef HC_SR04_SCENARIOFILE_H
+#define HC_SR04_SCENARIOFILE_H
+
+#include <SceneSimulator.h>
+
+#define SCENARIO_FILE_MAX_LENGTH 4096
+
+bool loadScenarioFile(SceneSimulator& scene, const char* path);
+
+
+#endif //HC_SR04_SCENARIOFILE_H
@@ -0,0 +1,261 @@
+/*
+ * Sweeps the HCSR04 over simulated scenes: thousands of seeded random scenarios and the given scenario files (see scenarios/).
+ * The sensors point at 0 and 20 degrees with a beam of ±15 degrees, so a target at a bearing of 10 degrees is seen by both.
+ * The two sensors measure each scene one after another with the default configuration. Each measurement is compared
+ * with the distance of the nearest target in the beam of its sensor at the end of the measurement.
+ * The report has the valid rate, the mean absolute error, the share of the valid measurements within SWEEP_TOLERANCE_CENTIMETERS,
+ * the phantoms (valid measurements with no target in the beam), the echo effects and the simulated time against the wall time.
+ * The checks:
+ *  - Every scenario file is loaded
+ *  - The sensors receive each other's pings (crosstalk) in the scenarios that have it
+ *  - The clean scenarios (no missed, ghost or crosstalk echoes at 25 °C) are measured within the tolerance
+ * The exit code is not 0 if a check fails.
+ *
+ * Build: g++ -std=c++11 -O2 -I ../arduino -I ../../src -I ../../src/hcsr04 ScenarioSweep.cpp ScenarioFile.cpp ../arduino/Arduino.cpp ../../src/hcsr04/HCSR04.cpp ../../src/hcsr04/ExtendedClock.cpp ../../src/hcsr04/HCSR04PinBackend.cpp ../../src/hcsr04/HCSR04Response.cpp ../../src/hcsr04/Measurement.cpp ../../src/hcsr04/AdaptivePingRate.cpp ../../src/hcsr04/SoundSpeed.cpp ../../src/hcsr04/SoundSpeedCalibration.cpp ../../src/hcsr04/DistanceUnits.cpp ../../src/hcsr04/TemperatureUnits.cpp ../../src/hcsr04/Utils.cpp ../../src/hcsr04/SceneSimulator.cpp ../../src/hcsr04/SimulatedSensor.cpp -o hcsr04-scenario-sweep
+ * Usage: hcsr04-scenario-sweep [scenarios count] [scenario files...]
+ */
+#include "ScenarioFile.h"
+#include <HCSR04.h>
+#include <SimulatedSensor.h>
+#include <ToolChecks.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SWEEP_DEFAULT_SCENARIOS_COUNT 5000
+#define SWEEP_SENSORS_COUNT 2
+#define SWEEP_SENSORS_SEPARATION_DEGREES 20.00f
+#define SWEEP_GENERATED_MEASUREMENTS 40
+#define SWEEP_FILE_MEASUREMENTS 1000
+#define SWEEP_TOLERANCE_CENTIMETERS 2.00f
+#define SWEEP_SCENARIO_MAX_LENGTH 512
+
+struct SweepResult {
+    unsigned long measurementsCount;
+    unsigned long validCount;
+    unsigned long withinToleranceCount;
+    unsigned long phantomsCount;
+    double absoluteErrorSumCM;
+
+    unsigned long pingsCount;
+    unsigned long missedEchoesCount;
+    unsigned long ghostEchoesCount;
+    unsigned long crosstalkEchoesCount;
+
+    uint64_t simulatedTimeUS;
+
+    void add(const SweepResult& other) {
+        this->measurementsCount += other.measurementsCount;
+        this->validCount += other.validCount;
+        this->withinToleranceCount += other.withinToleranceCount;
+        this->phantomsCount += other.phantomsCount;
+        this->absoluteErrorSumCM += other.absoluteErrorSumCM;
+        this->pingsCount += other.pingsCount;
+        this->missedEchoesCount += other.missedEchoesCount;
+        this->ghostEchoesCount += other.ghostEchoesCount;
+        this->crosstalkEchoesCount += other.crosstalkEchoesCount;
+        this->simulatedTimeUS += other.simulatedTimeUS;
+    }
+};
+
+/**
+ * The truth, which the sensor should measure. Same beam as in SimulatedSensor.
+ */
+static bool findNearestTargetDistanceCM(SceneSimulator& scene, const SimulatedSensor& sensor, float& distanceCM) {
+
+    bool isFound = false;
+
+    for (uint8_t i = 0; i < scene.getTargetsCount(); i++) {
+
+        if (fabsf(scene.getTarget(i).bearingDegrees - sensor.getHeadingDegrees()) > sensor.getBeamHalfAngleDegrees())
+            continue;
+
+        float targetDistanceCM = scene.getTargetDistanceCM(i);
+
+        if (!isFound || targetDistanceCM < distanceCM) {
+            distanceCM = targetDistanceCM;
+            isFound = true;
+        }
+    }
+
+    return isFound;
+}
+
+/**
+ * Will measure the scene, which is already loaded, with sensors that are added to it here.
+ */
+static SweepResult runScene(SceneSimulator& scene, const unsigned int& measurementsCount) {
+
+    SweepResult result = {};
+    SimulatedSensor firstSimulatedSensor(scene, 0);
+    SimulatedSensor secondSimulatedSensor(scene, SWEEP_SENSORS_SEPARATION_DEGREES);
+    HCSR04 firstSensor(firstSimulatedSensor);
+    HCSR04 secondSensor(secondSimulatedSensor);
+
+    SimulatedSensor* simulatedSensors[SWEEP_SENSORS_COUNT] = {&firstSimulatedSensor, &secondSimulatedSensor};
+    HCSR04* sensors[SWEEP_SENSORS_COUNT] = {&firstSensor, &secondSensor};
+
+    uint64_t startTimeUS = scene.getTimeUS();
+
+    for (unsigned int i = 0; i < measurementsCount; i++) {
+        uint8_t sensorIndex = i % SWEEP_SENSORS_COUNT;
+        Measurement measurement = sensors[sensorIndex]->measure();
+
+        float truthCM = 0;
+        bool isTargetInBeam = findNearestTargetDistanceCM(scene, *simulatedSensors[sensorIndex], truthCM);
+
+        result.measurementsCount++;
+
+        if (measurement.getValidMeasurementsCount() == 0)
+            continue;
+
+        result.validCount++;
+
+        if (!isTargetInBeam) {
+            result.phantomsCount++;
+            continue;
+        }
+
+        float absoluteErrorCM = fabsf(measurement.getDistance(DistanceUnit::CENTIMETERS) - truthCM);
+        result.absoluteErrorSumCM += absoluteErrorCM;
+
+        if (absoluteErrorCM <= SWEEP_TOLERANCE_CENTIMETERS)
+            result.withinToleranceCount++;
+    }
+
+    result.simulatedTimeUS = scene.getTimeUS() - startTimeUS;
+
+    for (uint8_t i = 0; i < SWEEP_SENSORS_COUNT; i++) {
+        result.pingsCount += simulatedSensors[i]->getPingsCount();
+        result.missedEchoesCount += simulatedSensors[i]->getMissedEchoesCount();
+        result.ghostEchoesCount += simulatedSensors[i]->getGhostEchoesCount();
+        result.crosstalkEchoesCount += simulatedSensors[i]->getCrosstalkEchoesCount();
+    }
+
+    return result;
+}
+
+static float nextRandomBetween(SceneSimulator& generator, const float& from, const float& to) {
+    return from + (to - from) * generator.nextRandom();
+}
+
+/**
+ * Will write a random scenario in the text format, so the generated scenarios go through the same loading as the files.
+ * A third of them are clean (no echo effects at 25 °C) and the rest have random effects and temperature.
+ */
+static void generateScenario(const uint32_t& seed, char* scenario, const size_t& scenarioSize) {
+
+    SceneSimulator generator;
+    generator.setSeed(seed * 2654435761UL);
+
+    bool isClean = seed % 3 == 0;
+    int length = snprintf(scenario, scenarioSize, "seed %lu\n", static_cast<unsigned long>(seed));
+
+    if (!isClean) {
+        length += snprintf(scenario + length, scenarioSize - length, "temperature %.1f %.1f\nmissed %.3f\nghost %.3f\ncrosstalk %.3f\n",
+                           nextRandomBetween(generator, -10, 40), nextRandomBetween(generator, -2, 2),
+                           nextRandomBetween(generator, 0, 0.2f), nextRandomBetween(generator, 0, 0.1f), nextRandomBetween(generator, 0, 0.5f));
+    }
+
+    uint8_t targetsCount = 1 + static_cast<uint8_t>(generator.nextRandom() * MAX_SCENE_TARGETS);
+
+    for (uint8_t i = 0; i < targetsCount; i++) {
+        float distanceCM = nextRandomBetween(generator, 20, 350);
+        float bearingDegrees = nextRandomBetween(generator, -15, 35);
+        float motion = isClean ? 0 : generator.nextRandom();
+
+        if (motion < 0.5f)
+            length += snprintf(scenario + length, scenarioSize - length, "target static %.1f %.1f\n", distanceCM, bearingDegrees);
+        else if (motion < 0.75f)
+            length += snprintf(scenario + length, scenarioSize - length, "target linear %.1f %.1f %.1f\n", distanceCM, nextRandomBetween(generator, -20, 20), bearingDegrees);
+        else
+            length += snprintf(scenario + length, scenarioSize - length, "target oscillating %.1f %.1f %lu %.1f\n", distanceCM, nextRandomBetween(generator, 5, 15),
+                               static_cast<unsigned long>(nextRandomBetween(generator, 2000, 20000)), bearingDegrees);
+    }
+}
+
+static void printResult(const char* name, const SweepResult& result) {
+
+    unsigned long accuracyCount = result.validCount - result.phantomsCount;
+
+    printf("%-32s measurements %7lu, valid %5.1f%%, mean error %6.2f cm, within %.0f cm %5.1f%%, phantoms %5lu\n",
+           name, result.measurementsCount,
+           result.measurementsCount == 0 ? 0 : 100.0 * result.validCount / result.measurementsCount,
+           accuracyCount == 0 ? 0 : result.absoluteErrorSumCM / accuracyCount,
+           SWEEP_TOLERANCE_CENTIMETERS,
+           accuracyCount == 0 ? 0 : 100.0 * result.withinToleranceCount / accuracyCount,
+           result.phantomsCount);
+
+    printf("%-32s pings %7lu, missed %lu, ghost %lu, crosstalk %lu\n", "", result.pingsCount, result.missedEchoesCount, result.ghostEchoesCount, result.crosstalkEchoesCount);
+}
+
+int main(int argc, char** argv) {
+
+    long scenariosCount = argc > 1 ? atol(argv[1]) : SWEEP_DEFAULT_SCENARIOS_COUNT;
+
+    if (scenariosCount < 0) {
+        fprintf(stderr, "Usage: %s [scenarios count] [scenario files...]\n", argv[0]);
+        return 1;
+    }
+
+    bool isPassed = true;
+    int filesCount = argc > 2 ? argc - 2 : 0;
+    SweepResult totalResult = {};
+    clock_t startClock = clock();
+
+    for (int i = 2; i < argc; i++) {
+        SceneSimulator scene;
+        bool isLoaded = loadScenarioFile(scene, argv[i]);
+
+        isPassed &= check(isLoaded, argv[i]);
+
+        if (!isLoaded)
+            continue;
+
+        SweepResult result = runScene(scene, SWEEP_FILE_MEASUREMENTS);
+        printResult(argv[i], result);
+        totalResult.add(result);
+    }
+
+    SweepResult cleanResult = {};
+    SweepResult noisyResult = {};
+    char scenario[SWEEP_SCENARIO_MAX_LENGTH];
+
+    for (long i = 1; i <= scenariosCount; i++) {
+        SceneSimulator scene;
+        generateScenario(static_cast<uint32_t>(i), scenario, sizeof(scenario));
+
+        if (!scene.loadScenario(scenario)) {
+            fprintf(stderr, "Invalid generated scenario:\n%s", scenario);
+            return 1;
+        }
+
+        SweepResult result = runScene(scene, SWEEP_GENERATED_MEASUREMENTS);
+        (i % 3 == 0 ? cleanResult : noisyResult).add(result);
+    }
+
+    if (scenariosCount > 0) {
+        printResult("generated clean scenarios", cleanResult);
+        printResult("generated noisy scenarios", noisyResult);
+    }
+
+    totalResult.add(cleanResult);
+    totalResult.add(noisyResult);
+
+    double wallSeconds = static_cast<double>(clock() - startClock) / CLOCKS_PER_SEC;
+    double simulatedSeconds = static_cast<double>(totalResult.simulatedTimeUS) / 1000000.0;
+
+    printf("%ld scenarios, %.0f s simulated in %.2f s (%.0fx real time)\n",
+           scenariosCount + filesCount, simulatedSeconds, wallSeconds, wallSeconds > 0 ? simulatedSeconds / wallSeconds : 0);
+
+    if (noisyResult.measurementsCount > 0)
+        isPassed &= check(noisyResult.crosstalkEchoesCount > 0, "the sensors receive each other's pings as crosstalk");
+
+    if (cleanResult.measurementsCount > 0) {
+        isPassed &= check(cleanResult.crosstalkEchoesCount == 0 && cleanResult.ghostEchoesCount == 0, "the clean scenarios have no echo effects");
+        isPassed &= check(cleanResult.withinToleranceCount == cleanResult.validCount - cleanResult.phantomsCount, "the clean scenarios are measured within the tolerance");
+    }
+
+    return isPassed ? 0 : 2;
+}
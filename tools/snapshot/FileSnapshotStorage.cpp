@@ -0,0 +1,94 @@
+#include "FileSnapshotStorage.h"
+#include <string.h>
+
+FileSnapshotStorage::FileSnapshotStorage() : file(nullptr), writtenBytesCount(0) {
+}
+
+FileSnapshotStorage::~FileSnapshotStorage() {
+    this->close();
+}
+
+/**
+ * Will open the file or create an erased one.
+ *
+ * @return If the file can be read and written and has the length of the storage
+ */
+bool FileSnapshotStorage::open(const char* path) {
+
+    this->close();
+    this->file = fopen(path, "r+b");
+
+    if (!this->file) {
+        this->file = fopen(path, "w+b");
+
+        if (!this->file)
+            return false;
+
+        uint8_t erased[FILE_SNAPSHOT_STORAGE_LENGTH];
+        memset(erased, 0xFF, sizeof(erased));
+
+        if (fwrite(erased, 1, sizeof(erased), this->file) != sizeof(erased) || fflush(this->file) != 0) {
+            this->close();
+            return false;
+        }
+    }
+
+    if (fseek(this->file, 0, SEEK_END) != 0 || ftell(this->file) != FILE_SNAPSHOT_STORAGE_LENGTH) {
+        this->close();
+        return false;
+    }
+
+    return true;
+}
+
+void FileSnapshotStorage::close() {
+
+    if (!this->file)
+        return;
+
+    fclose(this->file);
+    this->file = nullptr;
+}
+
+size_t FileSnapshotStorage::getLength() {
+    return this->file ? FILE_SNAPSHOT_STORAGE_LENGTH : 0;
+}
+
+void FileSnapshotStorage::read(const size_t& address, uint8_t* data, const size_t& length) {
+
+    memset(data, 0xFF, length);
+
+    if (!this->file || fseek(this->file, static_cast<long>(address), SEEK_SET) != 0)
+        return;
+
+    if (fread(data, 1, length, this->file) != length)
+        clearerr(this->file);
+}
+
+void FileSnapshotStorage::write(const size_t& address, const uint8_t* data, const size_t& length) {
+
+    if (!this->file || address + length > FILE_SNAPSHOT_STORAGE_LENGTH)
+        return;
+
+    uint8_t stored[FILE_SNAPSHOT_STORAGE_LENGTH];
+    this->read(address, stored, length);
+
+    for (size_t i = 0; i < length; i++) {
+
+        if (stored[i] == data[i])
+            continue;
+
+        fseek(this->file, static_cast<long>(address + i), SEEK_SET);
+        fputc(data[i], this->file);
+        this->writtenBytesCount++;
+    }
+
+    fflush(this->file);
+}
+
+/**
+ * @return How many bytes were changed since the opening
+ */
+unsigned long FileSnapshotStorage::getWrittenBytesCount() const {
+    return this->writtenBytesCount;
+}
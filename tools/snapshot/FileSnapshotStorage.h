@@ -0,0 +1,40 @@
+#ifndef HC_SR04_FILESNAPSHOTSTORAGE_H
+#define HC_SR04_FILESNAPSHOTSTORAGE_H
+
+#include <SnapshotStorage.h>
+#include <stdio.h>
+
+#define FILE_SNAPSHOT_STORAGE_LENGTH 1024
+
+/**
+ * The stand-in of the EEPROM on the host. The file has a fixed length and a new one is erased (0xFF), like the EEPROM.
+ * Only the changed bytes are written and counted, so the wear of a storage can be seen.
+ */
+class FileSnapshotStorage : public SnapshotStorage {
+
+private:
+
+    FILE* file;
+    unsigned long writtenBytesCount;
+
+public:
+
+    FileSnapshotStorage();
+
+    ~FileSnapshotStorage();
+
+    bool open(const char* path);
+
+    void close();
+
+    size_t getLength() override;
+
+    void read(const size_t& address, uint8_t* data, const size_t& length) override;
+
+    void write(const size_t& address, const uint8_t* data, const size_t& length) override;
+
+    unsigned long getWrittenBytesCount() const;
+};
+
+
+#endif //HC_SR04_FILESNAPSHOTSTORAGE_H
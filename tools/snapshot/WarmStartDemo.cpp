@@ -0,0 +1,68 @@
+/*
+ * Warm start of a HCSR04 from a snapshot in a file, which stands in for the EEPROM. The scene is cold (0 °C), so the default temperature
+ * of 25 °C measures too far. The first run starts cold, calibrates against the known distance and saves the snapshot.
+ * The next runs restore it and their first ping is as accurate as the calibrated one. Delete the file to start cold again.
+ *
+ * Build: g++ -std=c++11 -O2 -I ../arduino -I ../../src -I ../../src/hcsr04 WarmStartDemo.cpp FileSnapshotStorage.cpp ../arduino/Arduino.cpp ../../src/hcsr04/HCSR04SnapshotKeeper.cpp ../../src/hcsr04/HCSR04.cpp ../../src/hcsr04/ExtendedClock.cpp ../../src/hcsr04/HCSR04PinBackend.cpp ../../src/hcsr04/HCSR04Response.cpp ../../src/hcsr04/Measurement.cpp ../../src/hcsr04/AdaptivePingRate.cpp ../../src/hcsr04/SoundSpeed.cpp ../../src/hcsr04/SoundSpeedCalibration.cpp ../../src/hcsr04/DistanceUnits.cpp ../../src/hcsr04/TemperatureUnits.cpp ../../src/hcsr04/Utils.cpp ../../src/hcsr04/SceneSimulator.cpp ../../src/hcsr04/SimulatedSensor.cpp -o hcsr04-warm-start-demo
+ * Usage: hcsr04-warm-start-demo <snapshot file>
+ */
+#include <HCSR04SnapshotKeeper.h>
+#include <SceneSimulator.h>
+#include <SimulatedSensor.h>
+#include "FileSnapshotStorage.h"
+#include <math.h>
+#include <stdio.h>
+
+#define DEMO_TARGET_DISTANCE_CM 200.0f
+#define DEMO_SCENARIO "seed 3\ntemperature 0\ntarget static 200 0\n"
+#define DEMO_SNAPSHOT_ADDRESS 0
+
+static float measureFirstPing(HCSR04& hcsr04) {
+    return hcsr04.measure(MeasurementConfiguration::builder().withSamples(1).withMeasurementDistanceUnit(DistanceUnit::CENTIMETERS).build()).getDistance();
+}
+
+int main(int argc, char** argv) {
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <snapshot file>\n", argv[0]);
+        return 1;
+    }
+
+    FileSnapshotStorage storage;
+
+    if (!storage.open(argv[1])) {
+        fprintf(stderr, "Can't open %s as a snapshot storage of %d bytes\n", argv[1], FILE_SNAPSHOT_STORAGE_LENGTH);
+        return 1;
+    }
+
+    SceneSimulator scene;
+
+    if (!scene.loadScenario(DEMO_SCENARIO))
+        return 1;
+
+    SimulatedSensor simulatedSensor(scene, 0);
+    HCSR04 hcsr04(simulatedSensor);
+    HCSR04SnapshotKeeper snapshotKeeper(hcsr04, storage, DEMO_SNAPSHOT_ADDRESS);
+
+    bool isWarm = snapshotKeeper.restore();
+    float firstDistanceCM = measureFirstPing(hcsr04);
+
+    printf("%s start, first ping %.2f cm, error %.2f cm\n", isWarm ? "warm" : "cold", firstDistanceCM, fabsf(firstDistanceCM - DEMO_TARGET_DISTANCE_CM));
+
+    if (!isWarm && !hcsr04.calibrate(DEMO_TARGET_DISTANCE_CM, DistanceUnit::CENTIMETERS)) {
+        fprintf(stderr, "The calibration failed\n");
+        return 2;
+    }
+
+    float calibratedDistanceCM = measureFirstPing(hcsr04);
+    printf("calibrated %.5f cm/us, ping %.2f cm, error %.2f cm\n", hcsr04.getCalibratedSoundSpeed(), calibratedDistanceCM, fabsf(calibratedDistanceCM - DEMO_TARGET_DISTANCE_CM));
+
+    bool isSaved = snapshotKeeper.save();
+    bool isSavedAgain = snapshotKeeper.save();
+
+    printf("snapshot %s, saved again %s, written bytes %lu of %lu\n",
+           isSaved ? "saved" : "unchanged", isSavedAgain ? "yes" : "no",
+           storage.getWrittenBytesCount(), static_cast<unsigned long>(HCSR04SnapshotKeeper::getRequiredLength()));
+
+    return 0;
+}
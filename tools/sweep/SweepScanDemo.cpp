@@ -0,0 +1,221 @@
+/*
+ * Scans a known simulated scene with the SweepScanner. A VirtualServo turns a SimulatedSensor from -90 to 90 degrees of the scene
+ * in steps of 10 degrees and each reading is added to an OccupancyGrid, with the sensor at the bottom middle of the grid.
+ * A cell needs the hits of at least two sweeps to be occupied.
+ * The same sweep is then done with the adaptive samples and with a fixed count of samples at each angle.
+ * The checks:
+ *  - The readings that have a target in the beam measure its distance and the others have no echo
+ *  - The cells of the targets are occupied and the cells before them are free
+ *  - A reading without information leaves the grid as it is
+ *  - The adaptive sweep is faster than the fixed one and takes fewer samples
+ * The exit code is not 0 if a check fails.
+ *
+ * Build: g++ -std=c++11 -O2 -I ../arduino -I ../../src -I ../../src/hcsr04 SweepScanDemo.cpp ../arduino/Arduino.cpp ../../src/hcsr04/SweepScanner.cpp ../../src/hcsr04/VirtualServo.cpp ../../src/hcsr04/HCSR04.cpp ../../src/hcsr04/ExtendedClock.cpp ../../src/hcsr04/HCSR04PinBackend.cpp ../../src/hcsr04/HCSR04Response.cpp ../../src/hcsr04/Measurement.cpp ../../src/hcsr04/AdaptivePingRate.cpp ../../src/hcsr04/SoundSpeed.cpp ../../src/hcsr04/SoundSpeedCalibration.cpp ../../src/hcsr04/DistanceUnits.cpp ../../src/hcsr04/TemperatureUnits.cpp ../../src/hcsr04/Utils.cpp ../../src/hcsr04/SceneSimulator.cpp ../../src/hcsr04/SimulatedSensor.cpp -o hcsr04-sweep-scan-demo
+ * Usage: hcsr04-sweep-scan-demo [sweeps]
+ */
+#include <SweepScanner.h>
+#include <VirtualServo.h>
+#include <OccupancyGrid.h>
+#include <SceneSimulator.h>
+#include <SimulatedSensor.h>
+#include <ToolChecks.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEMO_DEFAULT_SWEEPS 4
+#define DEMO_START_ANGLE_DEGREES 0.00f
+#define DEMO_END_ANGLE_DEGREES 180.00f
+#define DEMO_STEP_ANGLE_DEGREES 10.00f
+#define DEMO_SERVO_HEADING_OFFSET_DEGREES -90.00f
+#define DEMO_ANGLES_COUNT 19
+#define DEMO_GRID_WIDTH 32
+#define DEMO_GRID_HEIGHT 20
+#define DEMO_CELL_SIZE_CENTIMETERS 10.00f
+#define DEMO_GRID_MAX_DISTANCE_CENTIMETERS 200.00f
+#define DEMO_TOLERANCE_CENTIMETERS 2.00f
+#define DEMO_TARGETS_COUNT 2
+
+#define DEMO_SCENARIO "seed 5\ntemperature 25\ntarget static 120 -30\ntarget static 80 40\n"
+
+/*
+ * The targets of the scenario, as they are seen from the sensor
+ */
+static const float TARGET_DISTANCES_CM[DEMO_TARGETS_COUNT] = {120, 80};
+static const float TARGET_BEARINGS_DEGREES[DEMO_TARGETS_COUNT] = {-30, 40};
+
+struct SweepCost {
+    unsigned long durationMS;
+    unsigned long samplesCount;
+};
+
+/**
+ * @return The distance of the nearest target in the beam at the angle of the servo, or -1 if there is none
+ */
+static float findExpectedDistanceCM(const float& angleDegrees, const float& beamHalfAngleDegrees) {
+
+    float headingDegrees = angleDegrees + DEMO_SERVO_HEADING_OFFSET_DEGREES;
+    float expectedDistanceCM = -1;
+
+    for (uint8_t i = 0; i < DEMO_TARGETS_COUNT; i++) {
+
+        if (fabsf(TARGET_BEARINGS_DEGREES[i] - headingDegrees) > beamHalfAngleDegrees)
+            continue;
+
+        if (expectedDistanceCM < 0 || TARGET_DISTANCES_CM[i] < expectedDistanceCM)
+            expectedDistanceCM = TARGET_DISTANCES_CM[i];
+    }
+
+    return expectedDistanceCM;
+}
+
+/**
+ * The angle 0 of the servo is the x axis of the grid, so the servo angle of a bearing is also its angle in the grid.
+ */
+static int16_t getCellX(const float& bearingDegrees, const float& distanceCM, const int16_t& originX) {
+    return originX + static_cast<int16_t>(lroundf(cosf((bearingDegrees - DEMO_SERVO_HEADING_OFFSET_DEGREES) * DEG_TO_RAD) * distanceCM / DEMO_CELL_SIZE_CENTIMETERS));
+}
+
+static int16_t getCellY(const float& bearingDegrees, const float& distanceCM, const int16_t& originY) {
+    return originY + static_cast<int16_t>(lroundf(sinf((bearingDegrees - DEMO_SERVO_HEADING_OFFSET_DEGREES) * DEG_TO_RAD) * distanceCM / DEMO_CELL_SIZE_CENTIMETERS));
+}
+
+static void printPolarScan(const PolarReading* readings, const uint16_t& readingsCount) {
+
+    for (uint16_t i = 0; i < readingsCount; i++) {
+        const PolarReading& reading = readings[i];
+
+        if (reading.isValid)
+            printf("  %6.1f deg: %6.1f cm (%u samples)\n", reading.angleDegrees, reading.distanceCM, reading.samples);
+        else
+            printf("  %6.1f deg: %s (%u samples)\n", reading.angleDegrees, reading.hasInformation ? "nothing in range" : "no information", reading.samples);
+    }
+}
+
+static void printGrid(const OccupancyGrid<DEMO_GRID_WIDTH, DEMO_GRID_HEIGHT>& occupancyGrid, const int16_t& originX, const int16_t& originY) {
+
+    for (int16_t y = DEMO_GRID_HEIGHT - 1; y >= 0; y--) {
+        printf("  ");
+
+        for (int16_t x = 0; x < DEMO_GRID_WIDTH; x++) {
+
+            if (x == originX && y == originY)
+                printf("S");
+            else
+                printf("%c", occupancyGrid.isOccupied(x, y) ? '#' : occupancyGrid.isFree(x, y) ? '.' : ' ');
+        }
+
+        printf("\n");
+    }
+}
+
+/**
+ * A single sweep on a new scene, so the sweeps that are compared start the same.
+ */
+static SweepCost sweepOnce(const uint8_t& minSamples, const uint8_t& maxSamples) {
+
+    SceneSimulator scene;
+    scene.loadScenario(DEMO_SCENARIO);
+
+    SimulatedSensor simulatedSensor(scene, 0);
+    VirtualServo virtualServo(simulatedSensor, DEMO_SERVO_HEADING_OFFSET_DEGREES);
+    HCSR04 hcsr04(simulatedSensor);
+    SweepScanner sweepScanner(hcsr04, virtualServo, DEMO_START_ANGLE_DEGREES, DEMO_END_ANGLE_DEGREES, DEMO_STEP_ANGLE_DEGREES);
+    PolarReading readings[DEMO_ANGLES_COUNT];
+
+    sweepScanner.setAdaptiveSamples(minSamples, maxSamples, DEFAULT_SWEEP_AGREEMENT_CENTIMETERS, DistanceUnit::CENTIMETERS);
+    sweepScanner.scan(readings, DEMO_ANGLES_COUNT);
+
+    return {sweepScanner.getLastSweepDurationMS(), sweepScanner.getLastSweepSamplesCount()};
+}
+
+int main(int argc, char** argv) {
+
+    int sweeps = argc > 1 ? atoi(argv[1]) : DEMO_DEFAULT_SWEEPS;
+
+    if (sweeps <= 0) {
+        fprintf(stderr, "Usage: %s [sweeps]\n", argv[0]);
+        return 1;
+    }
+
+    SceneSimulator scene;
+
+    if (!scene.loadScenario(DEMO_SCENARIO))
+        return 1;
+
+    SimulatedSensor simulatedSensor(scene, 0);
+    VirtualServo virtualServo(simulatedSensor, DEMO_SERVO_HEADING_OFFSET_DEGREES);
+    HCSR04 hcsr04(simulatedSensor);
+    SweepScanner sweepScanner(hcsr04, virtualServo, DEMO_START_ANGLE_DEGREES, DEMO_END_ANGLE_DEGREES, DEMO_STEP_ANGLE_DEGREES);
+
+    int16_t originX = DEMO_GRID_WIDTH / 2;
+    int16_t originY = 0;
+    OccupancyGrid<DEMO_GRID_WIDTH, DEMO_GRID_HEIGHT> occupancyGrid(DEMO_CELL_SIZE_CENTIMETERS, originX, originY);
+
+    PolarReading readings[DEMO_ANGLES_COUNT];
+    bool isPassed = check(sweepScanner.getAnglesCount() == DEMO_ANGLES_COUNT, "the sweep has an angle every 10 degrees");
+
+    unsigned long accurateCount = 0;
+    unsigned long expectedCount = 0;
+    unsigned long phantomsCount = 0;
+
+    for (int sweep = 0; sweep < sweeps; sweep++) {
+
+        if (sweepScanner.scan(readings, DEMO_ANGLES_COUNT) != DEMO_ANGLES_COUNT)
+            return 1;
+
+        for (uint16_t i = 0; i < DEMO_ANGLES_COUNT; i++) {
+            const PolarReading& reading = readings[i];
+            float expectedDistanceCM = findExpectedDistanceCM(reading.angleDegrees, simulatedSensor.getBeamHalfAngleDegrees());
+
+            occupancyGrid.addReading(reading, 0, DEMO_GRID_MAX_DISTANCE_CENTIMETERS);
+
+            if (expectedDistanceCM < 0) {
+                phantomsCount += reading.isValid ? 1 : 0;
+                continue;
+            }
+
+            expectedCount++;
+            accurateCount += reading.isValid && fabsf(reading.distanceCM - expectedDistanceCM) <= DEMO_TOLERANCE_CENTIMETERS ? 1 : 0;
+        }
+    }
+
+    printf("polar scan of the last sweep:\n");
+    printPolarScan(readings, DEMO_ANGLES_COUNT);
+    printf("occupancy grid (# occupied, . free, S sensor):\n");
+    printGrid(occupancyGrid, originX, originY);
+
+    isPassed &= check(accurateCount == expectedCount, "the readings with a target in the beam measure its distance");
+    isPassed &= check(phantomsCount == 0, "the readings without a target in the beam have no echo");
+
+    for (uint8_t i = 0; i < DEMO_TARGETS_COUNT; i++) {
+        int16_t targetX = getCellX(TARGET_BEARINGS_DEGREES[i], TARGET_DISTANCES_CM[i], originX);
+        int16_t targetY = getCellY(TARGET_BEARINGS_DEGREES[i], TARGET_DISTANCES_CM[i], originY);
+        int16_t beforeX = getCellX(TARGET_BEARINGS_DEGREES[i], TARGET_DISTANCES_CM[i] / 2, originX);
+        int16_t beforeY = getCellY(TARGET_BEARINGS_DEGREES[i], TARGET_DISTANCES_CM[i] / 2, originY);
+
+        printf("target %u: cell (%d, %d) log odds %d, cell (%d, %d) on the way log odds %d\n",
+               i, targetX, targetY, occupancyGrid.getLogOdds(targetX, targetY), beforeX, beforeY, occupancyGrid.getLogOdds(beforeX, beforeY));
+
+        isPassed &= check(occupancyGrid.isOccupied(targetX, targetY), "  the cell of the target is occupied");
+        isPassed &= check(occupancyGrid.isFree(beforeX, beforeY), "  the cell halfway to the target is free");
+    }
+
+    int16_t firstTargetX = getCellX(TARGET_BEARINGS_DEGREES[0], TARGET_DISTANCES_CM[0], originX);
+    int16_t firstTargetY = getCellY(TARGET_BEARINGS_DEGREES[0], TARGET_DISTANCES_CM[0], originY);
+    int8_t logOddsBefore = occupancyGrid.getLogOdds(firstTargetX, firstTargetY);
+    PolarReading noInformationReading = {TARGET_BEARINGS_DEGREES[0] - DEMO_SERVO_HEADING_OFFSET_DEGREES, 0, 0, false, false};
+
+    isPassed &= check(occupancyGrid.addReading(noInformationReading, 0, DEMO_GRID_MAX_DISTANCE_CENTIMETERS) == 0 &&
+                      occupancyGrid.getLogOdds(firstTargetX, firstTargetY) == logOddsBefore, "a reading without information leaves the grid as it is");
+
+    SweepCost adaptiveSweepCost = sweepOnce(DEFAULT_SWEEP_MIN_SAMPLES, DEFAULT_SWEEP_MAX_SAMPLES);
+    SweepCost fixedSweepCost = sweepOnce(DEFAULT_SWEEP_MAX_SAMPLES, DEFAULT_SWEEP_MAX_SAMPLES);
+
+    printf("adaptive sweep (%u to %u samples): %5lu ms, %3lu samples\n", DEFAULT_SWEEP_MIN_SAMPLES, DEFAULT_SWEEP_MAX_SAMPLES, adaptiveSweepCost.durationMS, adaptiveSweepCost.samplesCount);
+    printf("fixed sweep (%u samples):          %5lu ms, %3lu samples\n", DEFAULT_SWEEP_MAX_SAMPLES, fixedSweepCost.durationMS, fixedSweepCost.samplesCount);
+
+    isPassed &= check(adaptiveSweepCost.durationMS < fixedSweepCost.durationMS && adaptiveSweepCost.samplesCount < fixedSweepCost.samplesCount, "the adaptive sweep is faster and takes fewer samples");
+
+    return isPassed ? 0 : 2;
+}